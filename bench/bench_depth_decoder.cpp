@@ -0,0 +1,37 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "bench_harness.hpp"
+#include "custom_depth_decoder.hpp"
+
+#include <memory>
+
+
+int main(int argc, char **argv)
+{
+  BenchRunner bench(argc, argv);
+  BenchTensors depth = bench.loadTensors("midas_v2", syntheticMidas());
+
+  // Depth map is pushed to an appsrc, discarded without display
+  GstElement* pipeline = gst_parse_launch("appsrc name=src ! fakesink sync=false", NULL);
+  if (pipeline == nullptr) {
+    fprintf(stderr, "Can't create appsrc pipeline\n");
+    return -1;
+  }
+  gst_element_set_state(pipeline, GST_STATE_PLAYING);
+
+  // Decoder data holds the whole display buffer
+  std::unique_ptr<DecoderData> data = std::make_unique<DecoderData>();
+  data->appSrc = gst_bin_get_by_name(GST_BIN(pipeline), "src");
+
+  bench.run("depth: decode + push", [&]() {
+    newDataCallback(nullptr, depth.next(), data.get());
+  });
+
+  gst_element_set_state(pipeline, GST_STATE_NULL);
+  gst_object_unref(data->appSrc);
+  gst_object_unref(pipeline);
+  return 0;
+}
@@ -0,0 +1,41 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "bench_harness.hpp"
+#include "custom_emotion_decoder.hpp"
+
+
+int main(int argc, char **argv)
+{
+  BenchRunner bench(argc, argv);
+  BenchTensors faces = bench.loadTensors("ultraface_slim", syntheticUltraFace(5));
+  BenchTensors emotion = bench.loadTensors("emotion", syntheticEmotion());
+
+  DecoderData boxesData;
+  boxesData.width = 640;
+  boxesData.height = 480;
+  BenchCanvas canvas(boxesData.width, boxesData.height);
+
+  bench.run("emotion: face decode", [&]() {
+    newDataCallback(nullptr, faces.next(), &boxesData);
+  });
+
+  // Emotion of each detected face, the last one publishes results
+  boxesData.faceBoxes.update();
+  const std::vector<int> faceBoxes = boxesData.faceBoxes.readBuffer();
+  bench.run("emotion: emotion decode (all faces)", [&]() {
+    for (int i = 0; i < faceBoxes.size() / 4; i++)
+      getEmotionResult(emotion.next(), faceBoxes, i, &boxesData);
+  });
+  bench.run("emotion: emotion decode + draw", [&]() {
+    for (int i = 0; i < faceBoxes.size() / 4; i++)
+      getEmotionResult(emotion.next(), faceBoxes, i, &boxesData);
+    drawCallback(nullptr, canvas.cr, 0, 0, &boxesData);
+  });
+  bench.run("emotion: draw cached results", [&]() {
+    drawCallback(nullptr, canvas.cr, 0, 0, &boxesData);
+  });
+  return 0;
+}
@@ -0,0 +1,39 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "bench_harness.hpp"
+#include "custom_face_and_pose_decoder.hpp"
+
+
+int main(int argc, char **argv)
+{
+  BenchRunner bench(argc, argv);
+  BenchTensors faces = bench.loadTensors("ultraface_slim", syntheticUltraFace(5));
+  BenchTensors pose = bench.loadTensors("movenet_singlepose", syntheticMoveNet(1, false));
+
+  FaceData boxesData;
+  boxesData.inputDim = 480;
+  PoseData kptsData;
+  kptsData.inputDim = 480;
+  BenchCanvas canvas(480, 480);
+
+  bench.run("face_and_pose: face decode", [&]() {
+    newDataFaceCallback(nullptr, faces.next(), &boxesData);
+  });
+  bench.run("face_and_pose: pose decode", [&]() {
+    newDataPoseCallback(nullptr, pose.next(), &kptsData);
+  });
+  bench.run("face_and_pose: decode + draw", [&]() {
+    newDataFaceCallback(nullptr, faces.next(), &boxesData);
+    newDataPoseCallback(nullptr, pose.next(), &kptsData);
+    drawFaceCallback(nullptr, canvas.cr, 0, 0, &boxesData);
+    drawPoseCallback(nullptr, canvas.cr, 0, 0, &kptsData);
+  });
+  bench.run("face_and_pose: draw cached results", [&]() {
+    drawFaceCallback(nullptr, canvas.cr, 0, 0, &boxesData);
+    drawPoseCallback(nullptr, canvas.cr, 0, 0, &kptsData);
+  });
+  return 0;
+}
@@ -0,0 +1,32 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "bench_harness.hpp"
+#include "custom_face_decoder.hpp"
+
+
+int main(int argc, char **argv)
+{
+  BenchRunner bench(argc, argv);
+  BenchTensors faces = bench.loadTensors("ultraface_slim", syntheticUltraFace(5));
+
+  DecoderData boxesData;
+  boxesData.camWidth = 640;
+  boxesData.camHeight = 480;
+  boxesData.letterbox = computeLetterbox(640, 480, 320, 240, false);
+  BenchCanvas canvas(boxesData.camWidth, boxesData.camHeight);
+
+  bench.run("face: decode", [&]() {
+    newDataCallback(nullptr, faces.next(), &boxesData);
+  });
+  bench.run("face: decode + draw", [&]() {
+    newDataCallback(nullptr, faces.next(), &boxesData);
+    drawCallback(nullptr, canvas.cr, 0, 0, &boxesData);
+  });
+  bench.run("face: draw cached results", [&]() {
+    drawCallback(nullptr, canvas.cr, 0, 0, &boxesData);
+  });
+  return 0;
+}
@@ -0,0 +1,335 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "bench_harness.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <random>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+// Heap allocations done through operator new
+static std::atomic<uint64_t> numAllocations{0};
+
+
+void* operator new(std::size_t size)
+{
+  numAllocations.fetch_add(1, std::memory_order_relaxed);
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+
+void operator delete(void* ptr, std::size_t size) noexcept
+{
+  std::free(ptr);
+}
+
+
+/**
+ * @brief Open hardware cache misses counter of calling thread, inherited by
+ *        threads it creates afterwards, e.g. OpenMP workers.
+ *
+ * @return counter file descriptor, or -1 if not available.
+ */
+static int openCacheMissesCounter()
+{
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = PERF_COUNT_HW_CACHE_MISSES;
+  attr.disabled = 1;
+  attr.inherit = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+
+BenchCanvas::BenchCanvas(const int &width, const int &height)
+{
+  surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+  cr = cairo_create(surface);
+}
+
+
+BenchCanvas::~BenchCanvas()
+{
+  cairo_destroy(cr);
+  cairo_surface_destroy(surface);
+}
+
+
+/**
+ * @brief Parameterized constructor.
+ *
+ * @param argc: number of command line arguments.
+ * @param argv: command line arguments, --frames N and --fixtures DIR.
+ */
+BenchRunner::BenchRunner(int argc, char **argv)
+{
+  // Opened before any worker thread is created, so that workers inherit it
+  cacheMissesCounter = openCacheMissesCounter();
+  gst_init(&argc, &argv);
+  for (int i = 1; i < argc - 1; i++) {
+    std::string arg = argv[i];
+    if (arg == "--frames")
+      numFrames = std::max(1, std::atoi(argv[++i]));
+    else if (arg == "--fixtures")
+      fixturesDir = argv[++i];
+  }
+  printf("%-40s %14s %14s %20s\n", "case", "ns/frame", "allocs/frame", "cache-misses/frame");
+}
+
+
+BenchRunner::~BenchRunner()
+{
+  if (syntheticInputs)
+    printf("# WARNING: results above come from synthetic inputs, not from device recordings\n");
+  if (cacheMissesCounter >= 0)
+    close(cacheMissesCounter);
+  // Buffers may wrap recordings, release them first
+  for (GstBuffer* buffer : buffers)
+    gst_buffer_unref(buffer);
+  recordings.clear();
+}
+
+
+/**
+ * @brief Mark benchmark results as coming from synthetic inputs, reported
+ *        with each input and again after results.
+ *
+ * @param name: input name.
+ * @param source: origin of the input.
+ */
+void BenchRunner::useSyntheticInput(const std::string &name, const std::string &source)
+{
+  syntheticInputs = true;
+  printf("# %s: SYNTHETIC input, %s\n", name.c_str(), source.c_str());
+}
+
+
+/**
+ * @brief Load single frame model output, stored as raw float32 values in
+ *        <fixtures directory>/<name>.bin. Those fixtures are generated
+ *        frames, not device recordings.
+ *
+ * @param name: fixture name.
+ * @param synthetic: output used if no fixture is found.
+ */
+std::vector<float> BenchRunner::loadFixture(const std::string &name,
+                                            const std::vector<float> &synthetic)
+{
+  std::filesystem::path path = fixturesDir / (name + ".bin");
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) {
+    useSyntheticInput(name, "generated output, no fixture found");
+    return synthetic;
+  }
+
+  std::streamsize size = file.tellg();
+  if ((size <= 0) || (size % sizeof(float) != 0)) {
+    fprintf(stderr, "Invalid fixture size: %s\n", path.c_str());
+    exit(-1);
+  }
+  std::vector<float> tensor(size / sizeof(float));
+  file.seekg(0);
+  file.read(reinterpret_cast<char*>(tensor.data()), size);
+  useSyntheticInput(name, "replaying " + path.string());
+  return tensor;
+}
+
+
+/**
+ * @brief Create a single tensor buffer as given by tensor_sink.
+ *
+ * @param tensor: tensor values.
+ * @return buffer, owned by the runner.
+ */
+GstBuffer* BenchRunner::makeTensorBuffer(const std::vector<float> &tensor)
+{
+  gsize size = tensor.size() * sizeof(float);
+  GstBuffer* buffer = gst_buffer_new_allocate(NULL, size, NULL);
+  gst_buffer_fill(buffer, 0, tensor.data(), size);
+  buffers.push_back(buffer);
+  return buffer;
+}
+
+
+/**
+ * @brief Load frames of a model output, from a tensor_sink recording in
+ *        <fixtures directory>/<name>.tensors if any, else from a single
+ *        frame fixture.
+ *
+ * @param name: fixture name.
+ * @param synthetic: output used if no recording nor fixture is found.
+ * @return frames, owned by the runner.
+ */
+BenchTensors BenchRunner::loadTensors(const std::string &name,
+                                      const std::vector<float> &synthetic)
+{
+  BenchTensors tensors;
+  std::filesystem::path path = fixturesDir / (name + ".tensors");
+  if (std::filesystem::exists(path)) {
+    recordings.push_back(std::make_unique<TensorReplay>(path.string()));
+    TensorReplay &recording = *recordings.back();
+    for (size_t i = 0; i < recording.getNumRecords(); i++) {
+      tensors.buffers.push_back(recording.getBuffer(i));
+      buffers.push_back(tensors.buffers.back());
+    }
+  }
+  if (tensors.buffers.empty()) {
+    tensors.buffers.push_back(makeTensorBuffer(loadFixture(name, synthetic)));
+  } else {
+    printf("# %s: replaying %zu recorded frames of %s\n",
+           name.c_str(), tensors.buffers.size(), path.c_str());
+  }
+  return tensors;
+}
+
+
+/**
+ * @brief Run a benchmark case and print its statistics.
+ *
+ * @param name: case name.
+ * @param frame: processing of a frame.
+ */
+void BenchRunner::run(const std::string &name, const std::function<void()> &frame)
+{
+  for (int i = 0; i < numWarmup; i++)
+    frame();
+
+  int counter = cacheMissesCounter;
+  uint64_t allocations = numAllocations.load(std::memory_order_relaxed);
+  if (counter >= 0) {
+    ioctl(counter, PERF_EVENT_IOC_RESET, 0);
+    ioctl(counter, PERF_EVENT_IOC_ENABLE, 0);
+  }
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < numFrames; i++)
+    frame();
+  auto end = std::chrono::steady_clock::now();
+
+  uint64_t cacheMisses = 0;
+  bool cacheMissesValid = false;
+  if (counter >= 0) {
+    ioctl(counter, PERF_EVENT_IOC_DISABLE, 0);
+    cacheMissesValid = (read(counter, &cacheMisses, sizeof(cacheMisses)) == sizeof(cacheMisses));
+  }
+  allocations = numAllocations.load(std::memory_order_relaxed) - allocations;
+
+  double ns = std::chrono::duration<double, std::nano>(end - start).count() / numFrames;
+  std::string misses = "n/a";
+  if (cacheMissesValid)
+    misses = std::to_string(static_cast<double>(cacheMisses) / numFrames);
+  printf("%-40s %14.0f %14.2f %20s\n",
+         name.c_str(),
+         ns,
+         static_cast<double>(allocations) / numFrames,
+         misses.c_str());
+}
+
+
+/**
+ * @brief UltraFace slim output: 100 boxes of (background score, face score,
+ *        x1, y1, x2, y2), with normalized coordinates.
+ *
+ * @param numFaces: number of boxes above detection threshold.
+ */
+std::vector<float> syntheticUltraFace(const int &numFaces)
+{
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<float> position(0.05f, 0.75f);
+  std::vector<float> tensor(100 * 6);
+  for (int i = 0; i < 100; i++) {
+    float* box = tensor.data() + i * 6;
+    float x = position(rng);
+    float y = position(rng);
+    box[1] = (i < numFaces) ? 0.95f : 0.1f;
+    box[0] = 1.0f - box[1];
+    box[2] = x;
+    box[3] = y;
+    box[4] = x + 0.15f;
+    box[5] = y + 0.2f;
+  }
+  return tensor;
+}
+
+
+/**
+ * @brief MoveNet output: 17 keypoints of (y, x, score) for SinglePose,
+ *        followed by box and person score for each of the 6 MultiPose persons.
+ *
+ * @param numPersons: number of persons above detection threshold.
+ * @param multiPose: MultiPose output instead of SinglePose.
+ */
+std::vector<float> syntheticMoveNet(const int &numPersons, const bool &multiPose)
+{
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<float> jitter(-0.02f, 0.02f);
+  std::uniform_real_distribution<float> score(0.2f, 0.95f);
+  int persons = multiPose ? 6 : 1;
+  int stride = multiPose ? 56 : 17 * 3;
+  std::vector<float> tensor(persons * stride);
+  for (int p = 0; p < persons; p++) {
+    float* person = tensor.data() + p * stride;
+    float center = (p + 0.5f) / persons;
+    for (int k = 0; k < 17; k++) {
+      person[k * 3 + 0] = 0.1f + 0.05f * k + jitter(rng);
+      person[k * 3 + 1] = center + ((k % 2) ? 0.03f : -0.03f) + jitter(rng);
+      person[k * 3 + 2] = score(rng);
+    }
+    if (multiPose) {
+      person[51] = 0.1f;
+      person[52] = center - 0.08f;
+      person[53] = 0.95f;
+      person[54] = center + 0.08f;
+      person[55] = (p < numPersons) ? 0.8f : 0.05f;
+    }
+  }
+  return tensor;
+}
+
+
+/**
+ * @brief Emotion classifier output: probabilities of 7 emotions.
+ */
+std::vector<float> syntheticEmotion()
+{
+  return {0.05f, 0.02f, 0.08f, 0.6f, 0.1f, 0.05f, 0.1f};
+}
+
+
+/**
+ * @brief MiDaS v2 output: 256x256 relative inverse depth map.
+ */
+std::vector<float> syntheticMidas()
+{
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<float> noise(-5.0f, 5.0f);
+  std::vector<float> tensor(256 * 256);
+  for (int y = 0; y < 256; y++) {
+    for (int x = 0; x < 256; x++)
+      tensor[y * 256 + x] = 200.0f + 4.0f * y + noise(rng);
+  }
+  return tensor;
+}
@@ -0,0 +1,109 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef BENCH_BENCH_HARNESS_H_
+#define BENCH_BENCH_HARNESS_H_
+
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <gst/gst.h>
+#include <cairo.h>
+
+#include "tensor_record.hpp"
+
+// Recorded model outputs, set by CMake to bench/fixtures of source tree
+#ifndef BENCH_FIXTURES_DIR
+#define BENCH_FIXTURES_DIR "fixtures"
+#endif
+
+
+/**
+ * @brief Cairo canvas standing for a cairooverlay frame.
+ */
+class BenchCanvas {
+  private:
+    cairo_surface_t* surface;
+
+  public:
+    cairo_t* cr;
+
+    BenchCanvas(const int &width, const int &height);
+
+    BenchCanvas(const BenchCanvas&) = delete;
+
+    BenchCanvas& operator=(const BenchCanvas&) = delete;
+
+    ~BenchCanvas();
+};
+
+
+/**
+ * @brief Frames of a model output, replayed in a loop.
+ */
+class BenchTensors {
+  private:
+    size_t index = 0;
+
+  public:
+    std::vector<GstBuffer*> buffers;
+
+    GstBuffer* next()
+    {
+      GstBuffer* buffer = buffers[index];
+      index = (index + 1) % buffers.size();
+      return buffer;
+    }
+};
+
+
+/**
+ * @brief Replay model outputs through decoder callbacks, and report time,
+ *        allocations and cache misses per frame.
+ */
+class BenchRunner {
+  private:
+    int numFrames = 2000;
+    int numWarmup = 100;
+    std::filesystem::path fixturesDir = BENCH_FIXTURES_DIR;
+    int cacheMissesCounter = -1;
+    bool syntheticInputs = false;
+    std::vector<GstBuffer*> buffers;
+    std::vector<std::unique_ptr<TensorReplay>> recordings;
+
+  public:
+    BenchRunner(int argc, char **argv);
+
+    BenchRunner(const BenchRunner&) = delete;
+
+    BenchRunner& operator=(const BenchRunner&) = delete;
+
+    ~BenchRunner();
+
+    std::vector<float> loadFixture(const std::string &name,
+                                   const std::vector<float> &synthetic);
+
+    GstBuffer* makeTensorBuffer(const std::vector<float> &tensor);
+
+    void useSyntheticInput(const std::string &name, const std::string &source);
+
+    BenchTensors loadTensors(const std::string &name,
+                             const std::vector<float> &synthetic);
+
+    void run(const std::string &name, const std::function<void()> &frame);
+};
+
+
+std::vector<float> syntheticUltraFace(const int &numFaces);
+
+std::vector<float> syntheticMoveNet(const int &numPersons, const bool &multiPose);
+
+std::vector<float> syntheticEmotion();
+
+std::vector<float> syntheticMidas();
+#endif
@@ -0,0 +1,38 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "bench_harness.hpp"
+#include "custom_pose_decoder.hpp"
+
+
+int main(int argc, char **argv)
+{
+  BenchRunner bench(argc, argv);
+  BenchTensors singlePose = bench.loadTensors("movenet_singlepose", syntheticMoveNet(1, false));
+  BenchTensors multiPose = bench.loadTensors("movenet_multipose", syntheticMoveNet(4, true));
+
+  DecoderData kptsData;
+  kptsData.inputDim = 480;
+  BenchCanvas canvas(kptsData.inputDim, kptsData.inputDim);
+
+  bench.run("pose: singlepose decode", [&]() {
+    newDataCallback(nullptr, singlePose.next(), &kptsData);
+  });
+  bench.run("pose: singlepose decode + draw", [&]() {
+    newDataCallback(nullptr, singlePose.next(), &kptsData);
+    drawCallback(nullptr, canvas.cr, 0, 0, &kptsData);
+  });
+  bench.run("pose: multipose decode", [&]() {
+    newDataCallback(nullptr, multiPose.next(), &kptsData);
+  });
+  bench.run("pose: multipose decode + draw", [&]() {
+    newDataCallback(nullptr, multiPose.next(), &kptsData);
+    drawCallback(nullptr, canvas.cr, 0, 0, &kptsData);
+  });
+  bench.run("pose: draw cached results", [&]() {
+    drawCallback(nullptr, canvas.cr, 0, 0, &kptsData);
+  });
+  return 0;
+}
@@ -0,0 +1,70 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "bench_harness.hpp"
+#include "preprocess_kernel.hpp"
+
+
+/**
+ * @brief Frame of deterministic pixel values.
+ */
+static std::vector<uint8_t> syntheticFrame(const size_t &size)
+{
+  std::vector<uint8_t> frame(size);
+  for (size_t i = 0; i < size; i++)
+    frame[i] = (i * 37 + (i >> 7)) & 0xff;
+  return frame;
+}
+
+
+int main(int argc, char **argv)
+{
+  BenchRunner bench(argc, argv);
+  const int width = 640;
+  const int height = 480;
+  std::vector<uint8_t> yuy2 = syntheticFrame(width * height * 2);
+  std::vector<uint8_t> nv12 = syntheticFrame(width * height * 3 / 2);
+  std::vector<uint8_t> rgba = syntheticFrame(300 * 300 * 4);
+  bench.useSyntheticInput("camera frames", "deterministic pixel values");
+  std::vector<uint8_t> output(300 * 300 * 3 * sizeof(float));
+
+  const uint8_t* yuy2Planes[] = {yuy2.data()};
+  const int yuy2Strides[] = {width * 2};
+  const uint8_t* nv12Planes[] = {nv12.data(), nv12.data() + width * height};
+  const int nv12Strides[] = {width, width};
+  const uint8_t* rgbaPlanes[] = {rgba.data()};
+  const int rgbaStrides[] = {300 * 4};
+
+  PreprocessKernel yuy2Kernel("YUY2", width, height, "RGB", 300, 300, Normalization::none);
+  bench.run("preprocess: YUY2 640x480 to RGB 300x300", [&]() {
+    yuy2Kernel.process(yuy2Planes, yuy2Strides, output.data());
+  });
+
+  PreprocessKernel centeredKernel("YUY2", width, height, "RGB", 300, 300, Normalization::centered);
+  bench.run("preprocess: YUY2 640x480 to RGB 300x300 int8", [&]() {
+    centeredKernel.process(yuy2Planes, yuy2Strides, output.data());
+  });
+
+  PreprocessKernel nv12Kernel("NV12", width, height, "RGB", 224, 224, Normalization::centeredScaled);
+  bench.run("preprocess: NV12 640x480 to RGB 224x224 float32", [&]() {
+    nv12Kernel.process(nv12Planes, nv12Strides, output.data());
+  });
+
+  PreprocessKernel letterboxKernel("YUY2", width, height, "RGB", 300, 300, Normalization::none, true);
+  bench.run("preprocess: YUY2 640x480 to RGB 300x300 letterbox", [&]() {
+    letterboxKernel.process(yuy2Planes, yuy2Strides, output.data());
+  });
+
+  PreprocessKernel grayKernel("NV12", width, height, "GRAY8", 64, 64, Normalization::none);
+  bench.run("preprocess: NV12 640x480 to GRAY8 64x64", [&]() {
+    grayKernel.process(nv12Planes, nv12Strides, output.data());
+  });
+
+  PreprocessKernel rgbaKernel("RGBA", 300, 300, "RGB", 300, 300, Normalization::centered);
+  bench.run("preprocess: RGBA 300x300 to RGB int8", [&]() {
+    rgbaKernel.process(rgbaPlanes, rgbaStrides, output.data());
+  });
+  return 0;
+}
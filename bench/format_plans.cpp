@@ -0,0 +1,120 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * Print conversion plans of the format planner for every SoC, on host,
+ * from a 640x480 YUY2 or NV12 camera to usual model inputs, and check them
+ * against expected plans. Exit code is 1 if a plan differs.
+ */
+
+#include <iostream>
+#include <map>
+
+#include "format_planner.hpp"
+
+
+/**
+ * @brief Converter and formats expected for a request.
+ */
+typedef struct {
+  Converter converter;
+  std::string convertFormat;
+  std::string outputFormat;
+} ExpectedPlan;
+
+
+/**
+ * @brief Expected plans of requests below, same for YUY2 and NV12 sources.
+ *        SoCs without converter formats convert on CPU, and only scale
+ *        and flip with a converter.
+ */
+static std::vector<ExpectedPlan> cpuConversion(const Converter &flipConverter)
+{
+  return {
+    {Converter::cpu, "RGB", "RGB"},
+    {Converter::cpu, "RGB", "RGB"},
+    {Converter::cpu, "GRAY8", "GRAY8"},
+    {Converter::cpu, "RGB16", "RGB16"},
+    {flipConverter, "", ""},
+  };
+}
+
+
+int main(int argc, char **argv)
+{
+  const std::vector<ConversionRequest> requests = {
+    {.outputFormats = {"RGB"}, .width = 300, .height = 300},
+    {.outputFormats = {"RGB"}, .width = 300, .height = 300, .allowGpu3d = false},
+    {.outputFormats = {"GRAY8"}, .width = 64, .height = 64},
+    {.outputFormats = {"RGB16"}, .width = -1, .height = -1},
+    {.outputFormats = {}, .width = 640, .height = 480, .flip = true},
+  };
+
+  const std::map<int, std::vector<ExpectedPlan>> expectedPlans = {
+    {imx::IMX8MQ, cpuConversion(Converter::cpu)},
+    {imx::IMX8MM, cpuConversion(Converter::g2d)},
+    {imx::IMX8MN, cpuConversion(Converter::cpu)},
+    {imx::IMX8MP, {
+      {Converter::ocl, "RGB", "RGB"},
+      {Converter::g2d, "RGBA", "RGB"},
+      {Converter::ocl, "NV12", "GRAY8"},
+      {Converter::g2d, "RGB16", "RGB16"},
+      {Converter::g2d, "", ""},
+    }},
+    {imx::IMX8ULP, cpuConversion(Converter::g2d)},
+    {imx::IMX8QM, cpuConversion(Converter::g2d)},
+    {imx::IMX8QXP, cpuConversion(Converter::g2d)},
+    {imx::IMX93, {
+      {Converter::pxp, "BGR", "RGB"},
+      {Converter::pxp, "BGR", "RGB"},
+      {Converter::pxp, "GRAY8", "GRAY8"},
+      {Converter::pxp, "RGB16", "RGB16"},
+      {Converter::pxp, "", ""},
+    }},
+    {imx::IMX95, {
+      {Converter::g2d, "RGB", "RGB"},
+      {Converter::g2d, "RGB", "RGB"},
+      {Converter::ocl, "NV12", "GRAY8"},
+      {Converter::g2d, "RGB16", "RGB16"},
+      {Converter::g2d, "", ""},
+    }},
+    {imx::IMX952, cpuConversion(Converter::g2d)},
+  };
+
+  int failures = 0;
+  for (int soc = 0; soc < NUMBER_OF_SOC; soc++) {
+    std::cout << imx::socNameArray[soc] << std::endl;
+    const std::vector<ExpectedPlan> &expected = expectedPlans.at(soc);
+    for (const std::string sourceFormat : {"YUY2", "NV12"}) {
+      for (size_t i = 0; i < requests.size(); i++) {
+        ConversionRequest request = requests[i];
+        request.sourceFormats = {sourceFormat};
+        request.sourceWidth = 640;
+        request.sourceHeight = 480;
+        ConversionPlan plan = planConversion(soc, request);
+        std::cout << "  " << describePlan(plan) << std::endl;
+
+        if ((plan.sourceFormat != sourceFormat)
+            || (plan.converter != expected[i].converter)
+            || (plan.convertFormat != expected[i].convertFormat)
+            || (plan.outputFormat != expected[i].outputFormat)) {
+          std::cout << "  FAILED, expected " << converterName(expected[i].converter)
+                    << " to " << (expected[i].convertFormat.empty()
+                                  ? "any" : expected[i].convertFormat)
+                    << (expected[i].convertFormat != expected[i].outputFormat
+                        ? " then " + expected[i].outputFormat : "")
+                    << std::endl;
+          failures += 1;
+        }
+      }
+    }
+  }
+
+  if (failures != 0) {
+    std::cerr << failures << " unexpected conversion plans" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,45 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CPP_BACKEND_SELECTOR_H_
+#define CPP_BACKEND_SELECTOR_H_
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "imx_devices.hpp"
+
+// Backend argument selecting the fastest backend at first run
+#define BACKEND_AUTO                  "auto"
+// Timed invocations per backend, after a warm-up invocation
+#define BACKEND_PROBE_INVOCATIONS     5
+// Selected backends cache, in $XDG_CACHE_HOME or $HOME/.cache
+#define BACKEND_CACHE_FILE            "nnstreamer-imx/backends.txt"
+
+
+/**
+ * @brief Inference time of a model on a backend.
+ */
+typedef struct {
+  std::string backend;
+  bool available;
+  float inferenceMs;
+} BackendProbe;
+
+
+std::vector<std::string> candidateBackends(imx::Imx &imx);
+
+std::string modelHash(const std::filesystem::path &path);
+
+BackendProbe probeBackend(const std::filesystem::path &path,
+                          const std::string &backend,
+                          imx::Imx &imx,
+                          const int &numThreads);
+
+std::string selectBackend(const std::filesystem::path &path,
+                          imx::Imx &imx,
+                          const int &numThreads);
+#endif
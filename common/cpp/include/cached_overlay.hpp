@@ -0,0 +1,51 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CPP_CACHED_OVERLAY_H_
+#define CPP_CACHED_OVERLAY_H_
+
+#include <cairo.h>
+#include <cstdint>
+#include <vector>
+
+#include "logging.hpp"
+
+
+/**
+ * @brief Overlay layer rendered once per result generation and blitted on
+ *        every displayed frame in between.
+ *
+ * Usage in a cairooverlay draw callback:
+ *   cairo_t* layer = overlay.beginRender(cr, generation);
+ *   if (layer != nullptr)
+ *     ... draw results on layer ...
+ *   overlay.paint(cr);
+ */
+class CachedOverlay {
+  private:
+    cairo_surface_t* surface = nullptr;
+    cairo_t* context = nullptr;
+    uint32_t generation = 0;
+    bool rendered = false;
+    bool dirty = false;
+    // Regions of the layer holding drawn pixels
+    std::vector<cairo_rectangle_int_t> inkRegions;
+
+    void updateInkRegions();
+
+  public:
+    CachedOverlay() = default;
+
+    CachedOverlay(const CachedOverlay&) = delete;
+
+    CachedOverlay& operator=(const CachedOverlay&) = delete;
+
+    ~CachedOverlay();
+
+    cairo_t* beginRender(cairo_t* cr, const uint32_t &generation);
+
+    void paint(cairo_t* cr);
+};
+#endif
@@ -1,19 +1,34 @@
 /**
- * Copyright 2024 NXP
+ * Copyright 2024-2026 NXP
  * SPDX-License-Identifier: BSD-3-Clause 
  */ 
 
 #ifndef CPP_COMMON_H_
 #define CPP_COMMON_H_
 
+#include "backend_selector.hpp"
+#include "core_planner.hpp"
+#include "format_planner.hpp"
+#include "frame_bus.hpp"
+#include "gst_pinned_task_pool.hpp"
 #include "gst_pipeline_imx.hpp"
+#include "gst_preprocess_cpu.hpp"
 #include "gst_source_imx.hpp"
 #include "gst_video_imx.hpp"
 #include "gst_video_post_process.hpp"
+#include "image_batch.hpp"
 #include "imx_devices.hpp"
+#include "inference_arbiter.hpp"
+#include "letterbox.hpp"
 #include "logging.hpp"
 #include "model_infos.hpp"
 #include "nn_decoder.hpp"
+#include "offline_runner.hpp"
+#include "preprocess_kernel.hpp"
+#include "quantization_planner.hpp"
+#include "queue_autotuner.hpp"
+#include "results_publisher.hpp"
 #include "tensor_custom_data_generator.hpp"
+#include "tensor_record.hpp"
 
 #endif
\ No newline at end of file
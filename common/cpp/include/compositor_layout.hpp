@@ -0,0 +1,62 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CPP_COMPOSITOR_LAYOUT_H_
+#define CPP_COMPOSITOR_LAYOUT_H_
+
+#include "logging.hpp"
+
+
+/**
+ * @brief Enum of available video compositor layouts.
+ */
+enum class CompositorLayout {
+  grid,               // inputs tiled in rows and columns
+  pictureInPicture,   // first input on full display, others in small tiles
+  overlay,            // all inputs on full display, for alpha blending
+};
+
+
+/**
+ * @brief Position and size of an input on the display, in pixels.
+ */
+typedef struct {
+  int x;
+  int y;
+  int width;
+  int height;
+} LayoutTile;
+
+
+/**
+ * @brief Compute tiles of compositor inputs for a display resolution.
+ */
+class CompositorLayoutEngine {
+  private:
+    CompositorLayout layout;
+    int numInputs;
+    int displayWidth;
+    int displayHeight;
+    int columns = 1;
+    int rows = 1;
+
+    void computeGrid(const float &sourceAspect);
+
+  public:
+    CompositorLayoutEngine(const CompositorLayout &layout,
+                           const int &numInputs,
+                           const int &displayWidth,
+                           const int &displayHeight,
+                           const float &sourceAspect = 4.0f/3);
+
+    LayoutTile getTile(const int &index) const;
+
+    static LayoutTile letterbox(const LayoutTile &tile,
+                                const int &sourceWidth,
+                                const int &sourceHeight);
+
+    static bool readDisplayResolution(int &width, int &height);
+};
+#endif
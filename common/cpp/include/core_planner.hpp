@@ -0,0 +1,91 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CPP_CORE_PLANNER_H_
+#define CPP_CORE_PLANNER_H_
+
+#include <string>
+#include <vector>
+
+// cgroup v2 CPU limit, relative to the cgroup of the process
+#define CGROUP_V2_ROOT          "/sys/fs/cgroup"
+// cgroup v1 CPU quota and period
+#define CGROUP_V1_CPU_QUOTA     "/sys/fs/cgroup/cpu/cpu.cfs_quota_us"
+#define CGROUP_V1_CPU_PERIOD    "/sys/fs/cgroup/cpu/cpu.cfs_period_us"
+
+
+/**
+ * @brief Roles of application threads.
+ */
+enum class CoreRole {
+  capture,      // source streaming threads
+  inference,    // streaming threads running tensor_filter, XNNPACK threads
+  decoder,      // streaming threads running decoders only, decoder workers
+  display,      // other streaming threads: overlays, encoding, display
+};
+
+
+/**
+ * @brief Cores assigned to each role. Roles share cores when there are
+ *        less cores than roles.
+ */
+typedef struct {
+  std::vector<int> capture;
+  std::vector<int> inference;
+  std::vector<int> decoder;
+  std::vector<int> display;
+} CorePlan;
+
+
+/**
+ * @brief Linux scheduling policies of a thread.
+ */
+enum class SchedPolicy {
+  other,        // default time sharing, with nice value
+  fifo,         // real-time, runs until it blocks or yields
+  rr,           // real-time, round robin between threads of same priority
+};
+
+
+/**
+ * @brief Scheduling of a thread. Real-time priority is only used with fifo
+ *        and rr policies, nice value with other policy.
+ */
+typedef struct {
+  SchedPolicy policy = SchedPolicy::other;
+  int priority = 0;
+  int nice = 0;
+  std::vector<int> cores = {};  //optional, inherited cores if empty
+} ThreadScheduling;
+
+
+std::vector<int> affinityCores();
+
+int cgroupCpuLimit();
+
+std::vector<int> usableCores();
+
+CorePlan planCores(const std::vector<int> &cores);
+
+CorePlan planCores();
+
+const std::vector<int>& roleCores(const CorePlan &plan, const CoreRole &role);
+
+int inferenceThreads(const CorePlan &plan, const int &numModels=1);
+
+int defaultInferenceThreads(const int &numModels=1);
+
+int decoderThreads(const CorePlan &plan);
+
+bool pinCurrentThread(const std::vector<int> &cores);
+
+bool isDefaultScheduling(const ThreadScheduling &scheduling);
+
+bool applyThreadScheduling(const ThreadScheduling &scheduling);
+
+std::string describeScheduling(const ThreadScheduling &scheduling);
+
+std::string describeCorePlan(const CorePlan &plan);
+#endif
@@ -0,0 +1,88 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CPP_FORMAT_PLANNER_H_
+#define CPP_FORMAT_PLANNER_H_
+
+#include <string>
+#include <vector>
+
+#include "imx_devices.hpp"
+
+// Frame size used to rank plans when no resolution is known
+#define PLAN_DEFAULT_WIDTH    640
+#define PLAN_DEFAULT_HEIGHT   480
+
+
+/**
+ * @brief Video converters, in order of preference for plans of same cost.
+ */
+enum class Converter {
+  g2d,    // imxvideoconvert_g2d
+  pxp,    // imxvideoconvert_pxp
+  ocl,    // imxvideoconvert_ocl, GPU 3D
+  cpu,    // videoscale and videoconvert
+};
+
+
+/**
+ * @brief Output formats of a converter on a SoC.
+ */
+typedef struct {
+  Converter converter;
+  std::vector<std::string> formats;
+} ConverterCaps;
+
+
+/**
+ * @brief Conversion to plan. Empty formats and -1 dimensions are kept
+ *        from input. Source formats are the formats source can deliver,
+ *        output formats the layouts the model accepts, first ones being
+ *        preferred for plans of same cost.
+ */
+typedef struct {
+  std::vector<std::string> sourceFormats = {};
+  int sourceWidth = -1;
+  int sourceHeight = -1;
+  std::vector<std::string> outputFormats = {};
+  int width = -1;
+  int height = -1;
+  bool flip = false;
+  bool useCPU = false;
+  bool allowGpu3d = true;
+} ConversionRequest;
+
+
+/**
+ * @brief Conversion chain: source format, converter to convert format,
+ *        then CPU videoconvert to output format if they differ.
+ */
+typedef struct {
+  std::string sourceFormat;
+  Converter converter;
+  std::string convertFormat;
+  std::string outputFormat;
+  int width;
+  int height;
+  bool flip;
+  // CPU-touched bytes per frame, read and written
+  size_t cpuBytes;
+} ConversionPlan;
+
+
+const std::vector<ConverterCaps>& getConverterCaps(const int &socId);
+
+int formatBitsPerPixel(const std::string &format);
+
+bool isLosslessIntermediate(const std::string &intermediate,
+                            const std::string &target);
+
+ConversionPlan planConversion(const int &socId,
+                              const ConversionRequest &request);
+
+std::string converterName(const Converter &converter);
+
+std::string describePlan(const ConversionPlan &plan);
+#endif
@@ -0,0 +1,191 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CPP_FRAME_BUS_H_
+#define CPP_FRAME_BUS_H_
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gst_source_imx.hpp"
+
+#define FRAME_BUS_MAGIC           0x53554246  // "FBUS"
+#define FRAME_BUS_MAX_SLOTS       32
+// Slot holders are a bit mask, one bit per consumer
+#define FRAME_BUS_MAX_CONSUMERS   32
+#define FRAME_BUS_FORMAT_SIZE     16
+
+
+/**
+ * @brief Frame slot of the bus. Sequence is 0 while publisher writes the
+ *        slot, and a slot is only written when no consumer holds it.
+ */
+typedef struct {
+  std::atomic<uint64_t> sequence;
+  std::atomic<uint32_t> holders;
+  uint32_t reserved;
+  uint64_t pts;
+  uint64_t duration;
+} FrameBusSlot;
+
+
+/**
+ * @brief Header of the frame bus shared memory, frames follow at data
+ *        offset, one every slot stride bytes.
+ */
+typedef struct {
+  uint32_t magic;
+  uint32_t numSlots;
+  uint32_t width;
+  uint32_t height;
+  uint32_t framerate;
+  uint32_t frameSize;
+  uint64_t slotStride;
+  uint64_t dataOffset;
+  char format[FRAME_BUS_FORMAT_SIZE];
+  // Sequence of latest frame << 8 | its slot index
+  std::atomic<uint64_t> latest;
+  FrameBusSlot slots[FRAME_BUS_MAX_SLOTS];
+} FrameBusHeader;
+
+
+/**
+ * @brief Message sent to a consumer when it connects, with the shared
+ *        memory file descriptor.
+ */
+typedef struct {
+  uint32_t magic;
+  uint32_t consumer;
+  uint64_t mapSize;
+} FrameBusHello;
+
+
+/**
+ * @brief Frame bus publisher options.
+ */
+typedef struct {
+  std::filesystem::path socketPath;
+  int width;
+  int height;
+  std::string format = "YUY2";
+  int framerate = 30;
+  int numSlots = 8;
+} FrameBusOptions;
+
+
+/**
+ * @brief Capture once and share frames with other processes. Frames are
+ *        copied into slots of a memfd shared memory, consumers get the
+ *        memory over a Unix socket and are notified of each new frame.
+ *        A consumer holding slots is released when its socket closes,
+ *        so consumers can crash or restart without disturbing capture.
+ */
+class FrameBusPublisher {
+  private:
+    typedef struct {
+      int fd;
+      uint32_t consumer;
+    } Client;
+
+    FrameBusOptions options;
+    std::string gstName;
+    int memFd = -1;
+    int listenFd = -1;
+    uint8_t* map = nullptr;
+    size_t mapSize = 0;
+    size_t dataOffset = 0;
+    size_t slotStride = 0;
+    FrameBusHeader* header = nullptr;
+    std::vector<Client> clients;
+    uint32_t usedConsumers = 0;
+    std::mutex clientsMutex;
+    std::atomic<bool> running{false};
+    std::thread serverThread;
+    uint64_t sequence = 0;
+    uint32_t nextSlot = 0;
+    GstVideoInfo videoInfo;
+
+    void serve();
+
+    void releaseClient(const Client &client);
+
+    int acquireFreeSlot();
+
+  public:
+    FrameBusPublisher(const FrameBusOptions &options);
+
+    FrameBusPublisher(const FrameBusPublisher&) = delete;
+
+    FrameBusPublisher& operator=(const FrameBusPublisher&) = delete;
+
+    ~FrameBusPublisher();
+
+    void addFrameBusToPipeline(GstPipelineImx &pipeline,
+                               const std::string &gstName="frame_bus_sink");
+
+    void connectFrameBus(GstPipelineImx &pipeline);
+
+    static GstFlowReturn newSampleCallback(GstElement* appsink,
+                                           gpointer user_data);
+};
+
+
+/**
+ * @brief Create pipeline segment for frames of a frame bus. Buffers wrap
+ *        the shared memory without copy, and the latest frame is taken
+ *        when the consumer is late.
+ */
+class GstFrameBusImx : public GstSourceImx {
+  private:
+    typedef struct {
+      GstFrameBusImx* bus;
+      uint32_t slot;
+    } SlotRelease;
+
+    std::filesystem::path socketPath;
+    std::string gstName;
+    int socketFd = -1;
+    uint32_t consumerBit = 0;
+    FrameBusHeader* header = nullptr;
+    size_t headerMapSize = 0;
+    const uint8_t* data = nullptr;
+    size_t dataMapSize = 0;
+    uint32_t numSlots = 0;
+    uint64_t slotStride = 0;
+    uint32_t frameSize = 0;
+    int framerate;
+    GstElement* appsrc = nullptr;
+    std::atomic<bool> running{false};
+    std::thread readerThread;
+    uint64_t lastSequence = 0;
+    SlotRelease releases[FRAME_BUS_MAX_SLOTS];
+
+    void reader();
+
+    GstBuffer* acquireLatest();
+
+    static void releaseSlot(gpointer user_data);
+
+  public:
+    GstFrameBusImx(const std::filesystem::path &socketPath);
+
+    GstFrameBusImx(const GstFrameBusImx&) = delete;
+
+    GstFrameBusImx& operator=(const GstFrameBusImx&) = delete;
+
+    ~GstFrameBusImx();
+
+    void addFrameBusToPipeline(GstPipelineImx &pipeline,
+                               const std::string &gstName="frame_bus_src");
+
+    void connectFrameBus(GstPipelineImx &pipeline);
+};
+#endif
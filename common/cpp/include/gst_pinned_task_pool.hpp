@@ -0,0 +1,50 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CPP_GST_PINNED_TASK_POOL_H_
+#define CPP_GST_PINNED_TASK_POOL_H_
+
+#include <gst/gst.h>
+#include <map>
+#include <string>
+
+#include "core_planner.hpp"
+
+
+/**
+ * @brief Create a GstTaskPool running each task in its own thread, with
+ *        a scheduling policy, priority and cores.
+ *
+ * @param scheduling: scheduling of pool threads.
+ * @return task pool, to release with gst_object_unref().
+ */
+GstTaskPool* createPinnedTaskPool(const ThreadScheduling &scheduling);
+
+
+/**
+ * @brief Get role of a streaming thread from the element owning it: source
+ *        elements capture, threads running a tensor_filter before next
+ *        queue run inference, threads running decoders or tensor sinks
+ *        only run decoders, and other threads display.
+ *
+ * @param owner: element owning the streaming thread.
+ */
+CoreRole streamingThreadRole(GstElement* owner);
+
+
+/**
+ * @brief Run streaming threads of a pipeline in task pools: threads owned
+ *        by listed elements with their scheduling, other threads pinned to
+ *        cores of their role. Pipeline bus synchronous handler is used,
+ *        call once before pipeline leaves NULL state.
+ *
+ * @param pipeline: GStreamer pipeline.
+ * @param plan: cores assignment, empty to keep threads on inherited cores.
+ * @param elements: scheduling of threads owned by elements, by name.
+ */
+void scheduleStreamingThreads(GstElement* pipeline,
+                              const CorePlan &plan,
+                              const std::map<std::string, ThreadScheduling> &elements);
+#endif
@@ -10,8 +10,13 @@
 #include <glib.h>
 #include <glib-unix.h>
 #include <cairo.h>
+#include <atomic>
+#include <map>
+#include <memory>
 #include <vector>
 
+#include "cached_overlay.hpp"
+#include "core_planner.hpp"
 #include "imx_devices.hpp"
 
 
@@ -45,6 +50,8 @@ typedef struct {
   std::string queueName = "";
   int maxSizeBuffer = -1;
   GstQueueLeaky leakType = GstQueueLeaky::no;
+  ThreadScheduling scheduling = {};  //optional, scheduling of queue thread
+  int64_t maxSizeTime = -1;          //optional, nanoseconds
 } GstQueueOptions;
 
 
@@ -76,6 +83,9 @@ void outlineText(cairo_t* cr,
 long long getLatencyFromEnv(const char* envVar, long long defaultValue);
 
 
+class TensorRecorder;
+
+
 /**
  * @brief Setup and run GStreamer pipeline.
  */
@@ -92,8 +102,20 @@ class GstPipelineImx {
     static inline std::vector<float> infVector;
     static inline float perfFontSize = 0;
     static inline std::string perfColor = "";
+    static inline std::atomic<uint32_t> perfGeneration{0};
+    static inline CachedOverlay perfOverlay;
     int displayWidth = 0;
     int displayHeight = 0;
+    bool offline = false;
+    std::vector<std::string> tensorSinkNames;
+    std::vector<std::shared_ptr<TensorRecorder>> recorders;
+    bool pinned = false;
+    CorePlan corePlan;
+    std::map<std::string, ThreadScheduling> threadScheduling;
+
+    void recordTensorSinks();
+
+    void scheduleThreads();
 
   public:
     static int elemNameCount;
@@ -111,6 +133,8 @@ class GstPipelineImx {
 
     void run();
 
+    bool runToCompletion();
+
     void freeData();
 
     void addBranch(const std::string &teeName, const GstQueueOptions &options);
@@ -135,8 +159,15 @@ class GstPipelineImx {
 
     void setSave(const bool &save);
 
+    void setOffline(const bool &offline) { this->offline = offline; }
+
     GstElement* getElement(const std::string &gstName);
 
+    void pinThreads(const CorePlan &plan);
+
+    void setThreadScheduling(const std::string &gstName,
+                             const ThreadScheduling &scheduling);
+
     template<typename F>
     void connectToElementSignal(const std::string &gstName,
                                 F callback,
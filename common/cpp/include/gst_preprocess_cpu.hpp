@@ -0,0 +1,28 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CPP_GST_PREPROCESS_CPU_H_
+#define CPP_GST_PREPROCESS_CPU_H_
+
+#include <gst/gst.h>
+
+#define PREPROCESS_ELEMENT_NAME   "preprocess_cpu"
+// Video formats read by preprocess_cpu, as in its sink pad template
+#define PREPROCESS_VIDEO_FORMATS \
+  "{ YUY2, UYVY, NV12, I420, RGB, BGR, RGBA, RGBx, BGRA, BGRx, ARGB, xRGB, ABGR, xBGR, GRAY8 }"
+
+
+/**
+ * @brief Register preprocess_cpu element, a GStreamer element turning
+ *        video frames into a model input tensor with PreprocessKernel, in
+ *        place of videoscale, videoconvert, tensor_converter and
+ *        tensor_transform elements. It has width, height, format (RGB,
+ *        BGR or GRAY8), normalization and letterbox properties, and
+ *        outputs other/tensors. Registration is done once, after gst_init().
+ *
+ * @return true if element is available.
+ */
+bool registerPreprocessElement();
+#endif
@@ -1,13 +1,17 @@
 /**
- * Copyright 2024-2025 NXP
+ * Copyright 2024-2026 NXP
  * SPDX-License-Identifier: BSD-3-Clause 
  */ 
 
 #ifndef CPP_GST_VIDEO_IMX_H_
 #define CPP_GST_VIDEO_IMX_H_
 
+#include <vector>
+
+#include "format_planner.hpp"
 #include "imx_devices.hpp"
 #include "gst_pipeline_imx.hpp"
+#include "letterbox.hpp"
 
 
 /**
@@ -16,10 +20,23 @@
 class GstVideoImx {
   private:
     imx::Imx imx{};
+    bool allowGpu3d = true;
+    std::vector<ConversionPlan> plans;
 
   public:
     GstVideoImx() = default;
 
+    void setGpu3dAllowed(const bool &allowed) { allowGpu3d = allowed; }
+
+    const std::vector<ConversionPlan>& getPlans() const { return plans; }
+
+    ConversionPlan planTransform(GstPipelineImx &pipeline,
+                                 const std::string &format,
+                                 const int &width,
+                                 const int &height,
+                                 const bool &flip,
+                                 const bool &useCPU=false);
+
     void videoTransform(GstPipelineImx &pipeline,
                         const std::string &format,
                         const int &width,
@@ -28,10 +45,17 @@ class GstVideoImx {
                         const bool &aspectRatio=false,
                         const bool &useCPU=false);
 
+    void addPlanToPipeline(GstPipelineImx &pipeline,
+                           const ConversionPlan &plan,
+                           const bool &aspectRatio=false);
+
     void videoscaleToRGB(GstPipelineImx &pipeline,
                          const int &width,
                          const int &height);
 
+    void videoLetterbox(GstPipelineImx &pipeline,
+                        const Letterbox &letterbox);
+
     void videocrop(GstPipelineImx &pipeline,
                    const std::string &gstName,
                    const int &newWidth,
@@ -1,5 +1,5 @@
 /**
- * Copyright 2024-2025 NXP
+ * Copyright 2024-2026 NXP
  * SPDX-License-Identifier: BSD-3-Clause 
  */
 
@@ -11,6 +11,7 @@
 #include <filesystem>
 #include <vector>
 
+#include "compositor_layout.hpp"
 #include "gst_pipeline_imx.hpp"
 
 
@@ -34,18 +35,20 @@ typedef struct {
 } AppSinkOptions;
 
 
-enum class displayPosition {
-  left,
-  right,
-  center
-};
+typedef struct {
+  CompositorLayout layout;
+  int numInputs;
+  int width = -1;                     //optional, connected display by default
+  int height = -1;                    //optional, connected display by default
+} CompositorLayoutOptions;
 
 
 typedef struct {
-  displayPosition position;
   int order;
   bool keepRatio;
   bool transparency;
+  int sourceWidth = -1;               //optional, needed to scale source once
+  int sourceHeight = -1;              //optional, needed to scale source once
 } compositorInputParams;
 
 
@@ -84,12 +87,17 @@ class GstVideoCompositorImx {
   private:
     imx::Imx imx{};
     std::string gstName;
+    LayoutTile displayArea;
+    CompositorLayoutEngine layoutEngine;
     std::vector<compositorInputParams> compositorInputs;
-    static inline int sinkNumber = 0;
+    std::vector<LayoutTile> compositorTiles;
+    std::vector<bool> compositorScaled;
+
+    static LayoutTile getDisplayArea(const CompositorLayoutOptions &layoutOptions);
 
   public:
-    GstVideoCompositorImx(const std::string &gstName)
-        : gstName(gstName) {}
+    GstVideoCompositorImx(const std::string &gstName,
+                          const CompositorLayoutOptions &layoutOptions);
 
     void addToCompositor(GstPipelineImx &pipeline,
                          const compositorInputParams &inputParams);
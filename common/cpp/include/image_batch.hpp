@@ -0,0 +1,79 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CPP_IMAGE_BATCH_H_
+#define CPP_IMAGE_BATCH_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gst_source_imx.hpp"
+
+// Nominal framerate of timestamps, image index is PTS / frame duration
+#define IMAGE_BATCH_FRAMERATE   30
+// Decoded images waiting to be pushed, per decoding thread
+#define IMAGE_BATCH_PREFETCH    2
+
+
+/**
+ * @brief Create pipeline segment for a batch of JPEG images of a directory.
+ *        Images are decoded and resized to RGB by a thread pool, and pushed
+ *        in order as fast as downstream consumes them, then stream ends.
+ */
+class GstImageBatchImx : public GstSourceImx {
+  private:
+    typedef struct {
+      GstBuffer* buffer = nullptr;
+      bool ready = false;
+    } Slot;
+
+    std::string gstName;
+    std::vector<std::filesystem::path> images;
+    int numWorkers;
+    std::vector<Slot> slots;
+    std::mutex slotsMutex;
+    std::condition_variable slotsCondition;
+    std::atomic<size_t> nextDecode{0};
+    size_t nextPush = 0;
+    bool running = false;
+    std::vector<std::thread> workers;
+
+    void worker();
+
+    bool decode(const std::filesystem::path &path,
+                uint8_t* rgb,
+                std::vector<uint8_t> &scratch);
+
+  public:
+    GstImageBatchImx(const std::filesystem::path &directory,
+                     const int &width,
+                     const int &height,
+                     const int &numWorkers=0);
+
+    GstImageBatchImx(const GstImageBatchImx&) = delete;
+
+    GstImageBatchImx& operator=(const GstImageBatchImx&) = delete;
+
+    ~GstImageBatchImx();
+
+    void addImageBatchToPipeline(GstPipelineImx &pipeline,
+                                 const std::string &gstName="image_batch");
+
+    void connectImageBatch(GstPipelineImx &pipeline);
+
+    size_t getNumImages() const { return images.size(); }
+
+    const std::filesystem::path& getImagePath(const GstClockTime &pts) const;
+
+    static void needDataCallback(GstElement* appsrc,
+                                 guint length,
+                                 gpointer user_data);
+};
+#endif
@@ -0,0 +1,136 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CPP_INFERENCE_ARBITER_H_
+#define CPP_INFERENCE_ARBITER_H_
+
+#include <gst/gst.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "gst_pipeline_imx.hpp"
+
+// Inference considered lost (e.g. frame dropped after admission) after
+#define ARBITER_INFLIGHT_TIMEOUT_NS   (1000 * 1000 * 1000ULL)
+// Period of achieved rate measurement
+#define ARBITER_RATE_WINDOW_NS        (1000 * 1000 * 1000ULL)
+
+
+/**
+ * @brief Model sharing an accelerator. Frames are admitted on tensor_filter
+ *        sink pad, or on gate element src pad if set, e.g. the queue of
+ *        model branch so that dropped frames are not preprocessed. Models
+ *        of higher priority are served first, target rate of 0 admits as
+ *        many frames as possible.
+ */
+typedef struct {
+  std::string filterName;
+  std::string gateName = "";          //optional, tensor_filter by default
+  int priority = 0;
+  float targetFps = 0;
+} ArbiterModelOptions;
+
+
+/**
+ * @brief Admission of a frame: admitted, dropped, or to decide again when
+ *        running inferences of higher priority models are done.
+ */
+enum class ArbiterDecision {
+  admit,
+  drop,
+  wait,
+};
+
+
+/**
+ * @brief Admission statistics of a model.
+ */
+typedef struct {
+  std::string filterName;
+  int priority;
+  float targetFps;
+  float achievedFps;
+  float latencyMs;
+  uint64_t admitted;
+  uint64_t dropped;
+} ArbiterModelStats;
+
+
+/**
+ * @brief Inference arbiter for tensor_filter elements sharing an
+ *        accelerator. Each model gets frames at its target rate, and a
+ *        model is only given a frame when its inference can not delay a
+ *        model of higher priority: it waits for running inferences of such
+ *        models, and must end before their next expected frame.
+ */
+class InferenceArbiter {
+  private:
+    typedef struct {
+      InferenceArbiter* arbiter;
+      int index;
+      ArbiterModelOptions options;
+      uint64_t periodNs;
+      uint64_t nextDueNs;
+      uint64_t lastArrivalNs;
+      uint64_t arrivalIntervalNs;
+      bool inFlight;
+      uint64_t admittedAtNs;
+      uint64_t latencyNs;
+      uint64_t admitted;
+      uint64_t dropped;
+      uint64_t windowStartNs;
+      uint64_t windowCount;
+      float achievedFps;
+    } ArbitratedModel;
+
+    std::mutex mutex;
+    std::condition_variable done;
+    std::deque<ArbitratedModel> models;
+    guint statsSource = 0;
+
+    ArbiterDecision decide(ArbitratedModel &model,
+                           const uint64_t &nowNs,
+                           const bool &newFrame);
+
+    static GstPadProbeReturn gateProbe(GstPad* pad,
+                                       GstPadProbeInfo* info,
+                                       gpointer user_data);
+
+    static GstPadProbeReturn doneProbe(GstPad* pad,
+                                       GstPadProbeInfo* info,
+                                       gpointer user_data);
+
+    static gboolean statsCallback(gpointer user_data);
+
+  public:
+    InferenceArbiter() = default;
+
+    InferenceArbiter(const InferenceArbiter&) = delete;
+
+    InferenceArbiter& operator=(const InferenceArbiter&) = delete;
+
+    ~InferenceArbiter();
+
+    int addModel(const ArbiterModelOptions &options);
+
+    void attach(GstPipelineImx &pipeline);
+
+    ArbiterDecision admit(const int &model,
+                          const uint64_t &nowNs,
+                          const bool &newFrame=true);
+
+    void complete(const int &model, const uint64_t &nowNs);
+
+    std::vector<ArbiterModelStats> getStats();
+
+    void logStats();
+
+    void logStatsPeriodically(const guint &periodSeconds=10);
+};
+#endif
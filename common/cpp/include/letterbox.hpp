@@ -0,0 +1,43 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CPP_LETTERBOX_H_
+#define CPP_LETTERBOX_H_
+
+
+/**
+ * @brief Placement of a source frame in model input: the frame is resized
+ *        to scaledWidth x scaledHeight and padded by left and top pixels
+ *        before it, and by the remaining pixels after it. A stretched
+ *        frame fills model input without padding.
+ */
+typedef struct {
+  int sourceWidth;
+  int sourceHeight;
+  int width;
+  int height;
+  int scaledWidth;
+  int scaledHeight;
+  int left;
+  int top;
+} Letterbox;
+
+
+Letterbox computeLetterbox(const int &sourceWidth,
+                           const int &sourceHeight,
+                           const int &width,
+                           const int &height,
+                           const bool &keepAspectRatio);
+
+bool isLetterboxed(const Letterbox &letterbox);
+
+float letterboxToSourceX(const Letterbox &letterbox, const float &x);
+
+float letterboxToSourceY(const Letterbox &letterbox, const float &y);
+
+float letterboxToFrameX(const Letterbox &letterbox, const float &x);
+
+float letterboxToFrameY(const Letterbox &letterbox, const float &y);
+#endif
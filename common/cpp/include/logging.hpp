@@ -1,35 +1,74 @@
 /**
- * Copyright 2023-2024 NXP
- * SPDX-License-Identifier: BSD-3-Clause 
- */ 
+ * Copyright 2023-2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
 
 #ifndef CPP_LOGGING_H_
 #define CPP_LOGGING_H_
 
-/* Define macro for logging */
-#define LOG_INFO true
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 
-#if LOG_INFO
-#define log_info(...) printf("\n\033[1;32mINFO:\033[0m "); printf(__VA_ARGS__); fflush(stdout);
+#define LOG_LEVEL_DEBUG   0
+#define LOG_LEVEL_INFO    1
+#define LOG_LEVEL_ERROR   2
+#define LOG_LEVEL_NONE    3
 
-#else 
-#define log_info(...)
+/* Minimum level compiled in, lower level calls are removed, except errors */
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL LOG_LEVEL_DEBUG
 #endif
 
-#define LOG_ERROR true
 
-#if LOG_ERROR
-#define log_error(...) printf("\n\033[1;31mERROR:\033[0m "); printf(__VA_ARGS__); fflush(stdout);
-#else 
-#define log_error(...)
+/**
+ * @brief Rate limiting state of a logging call site.
+ */
+typedef struct {
+  std::atomic<uint64_t> lastHash{0};
+  std::atomic<uint64_t> windowStart{0};
+  std::atomic<uint32_t> count{0};
+  std::atomic<uint32_t> suppressed{0};
+} LogSite;
+
+
+/**
+ * @brief Asynchronous logger. Debug and info messages are formatted by the
+ *        calling thread in a lock-free ring buffer, and written to stdout by
+ *        a background thread, so streaming threads never do I/O. They are
+ *        dropped if the ring buffer is full, and identical messages repeated
+ *        by a call site are rate limited. Errors usually precede an exit,
+ *        they are written to stderr by the calling thread, never dropped.
+ *
+ * Runtime level is read from LOG_LEVEL environment variable
+ * (debug, info, error or none), info by default.
+ */
+namespace logger {
+  void log(const int &level, LogSite &site, const char* format, ...)
+      __attribute__((format(printf, 3, 4)));
+
+  void flush();
+}
+
+
+#define LOG_AT_LEVEL(level, ...) do { \
+    static LogSite logSite; \
+    logger::log(level, logSite, __VA_ARGS__); \
+  } while (0)
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_INFO
+#define log_info(...) LOG_AT_LEVEL(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define log_info(...) do {} while (0)
 #endif
 
-#define LOG_DEBUG true
+#define log_error(...) LOG_AT_LEVEL(LOG_LEVEL_ERROR, __VA_ARGS__)
 
-#if LOG_DEBUG
-#define log_debug(...) printf("\n\033[1;33mDEBUG:\033[0m "); printf(__VA_ARGS__); fflush(stdout);
-#else 
-#define log_debug(...)
+#if LOG_MIN_LEVEL <= LOG_LEVEL_DEBUG
+#define log_debug(...) LOG_AT_LEVEL(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define log_debug(...) do {} while (0)
 #endif
 
-#endif
\ No newline at end of file
+#endif
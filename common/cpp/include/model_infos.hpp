@@ -1,5 +1,5 @@
 /**
- * Copyright 2024-2025 NXP
+ * Copyright 2024-2026 NXP
  * SPDX-License-Identifier: BSD-3-Clause 
  */ 
 
@@ -9,9 +9,12 @@
 #include <filesystem>
 #include <thread>
 
+#include "core_planner.hpp"
 #include "imx_devices.hpp"
 #include "gst_video_imx.hpp"
 #include "gst_pipeline_imx.hpp"
+#include "letterbox.hpp"
+#include "quantization_planner.hpp"
 #include "tensor_custom_data_generator.hpp"
 
 
@@ -30,6 +33,15 @@ class ModelInfos {
     imx::Imx imx{};
     GstVideoImx videoscale{};
     TensorData tensorData;
+    InputQuantization inputQuantization;
+    InputPlan inputPlan;
+    bool keepAspectRatio = false;
+    Letterbox letterbox{};
+
+    void planInput();
+
+    bool addPreprocessToPipeline(GstPipelineImx &pipeline,
+                                 const std::string &format);
 
   public:
     ModelInfos(const std::filesystem::path &path,
@@ -47,6 +59,12 @@ class ModelInfos {
 
     bool isRGB() const  { return ((modelChannel == 3) ? true : false); }
 
+    const InputPlan& getInputPlan() const { return inputPlan; }
+
+    void setLetterbox(const bool &enabled) { keepAspectRatio = enabled; }
+
+    const Letterbox& getLetterbox() const { return letterbox; }
+
     void addInferenceToPipeline(GstPipelineImx &pipeline,
                                 const std::string &gstName="",
                                 const std::string &format="RGB");
@@ -59,10 +77,15 @@ class ModelInfos {
  * @brief Create pipeline segments for tensorflow lite model.
  */
 class TFliteModelInfos : public ModelInfos {
+  private:
+    static std::string resolveBackend(const std::filesystem::path &path,
+                                      const std::string &backend,
+                                      const int &numThreads);
+
   public:
     TFliteModelInfos(const std::filesystem::path &path,
                      const std::string &backend,
                      const std::string &norm,
-                     const int &numThreads=std::thread::hardware_concurrency());
+                     const int &numThreads=defaultInferenceThreads());
 };
 #endif
\ No newline at end of file
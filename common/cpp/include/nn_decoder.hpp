@@ -1,5 +1,5 @@
 /**
- * Copyright 2024 NXP
+ * Copyright 2024,2026 NXP
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
@@ -8,9 +8,17 @@
 
 #include <filesystem>
 #include <map>
+#include <memory>
+#include <vector>
 
+#include "cached_overlay.hpp"
 #include "gst_pipeline_imx.hpp"
+#include "letterbox.hpp"
+#include "results_publisher.hpp"
+#include "segmentation_kernel.hpp"
+#include "ssd_box_decoder.hpp"
 #include "tensor_custom_data_generator.hpp"
+#include "triple_buffer.hpp"
 
 
 /**
@@ -43,6 +51,8 @@ typedef struct {
   Dimension inDim;
   bool trackResult;
   bool logResult;
+  bool nativeDecoder = false;         //optional, mobilenetssd only
+  Letterbox letterbox = {};           //optional, native decoder only
 } BoundingBoxesOptions;
 
 
@@ -147,6 +157,8 @@ enum class ModeImageSegment {
 typedef struct {
   ModeImageSegment modelName;
   int numClass = -1;                  //optional
+  bool nativeDecoder = false;         //optional, tfliteDeeplab only
+  Dimension maskDim = {-1, -1};       //optional, needed by native decoder
 } ImageSegmentOptions;
 
 
@@ -154,14 +166,68 @@ typedef struct {
  * @brief Create pipeline segments for NNStreamer decoder.
  */
 class NNDecoder {
+  private:
+    std::unique_ptr<SSDBoxDecoder> ssdDecoder;
+    std::string tensorSinkName;
+    std::string overlayName;
+    TripleBuffer<std::vector<DetectedBox>> boxes;
+    // Boxes of last buffer, published and only read by tensor_sink thread
+    const std::vector<DetectedBox>* sinkBoxes = nullptr;
+    CachedOverlay boxesOverlay;
+    bool logResult = false;
+    ResultsPublisher* resultsPublisher = nullptr;
+    FrameResults frameResults;
+    std::unique_ptr<SegmentationKernel> segmentationKernel;
+    std::string segmentSinkName;
+    std::string segmentOverlayName;
+
+    static void newBoxesCallback(GstElement* element,
+                                 GstBuffer* buffer,
+                                 gpointer user_data);
+
+    static void drawBoxesCallback(GstElement* overlay,
+                                  cairo_t* cr,
+                                  guint64 timestamp,
+                                  guint64 duration,
+                                  gpointer user_data);
+
+    static void newSegmentCallback(GstElement* element,
+                                   GstBuffer* buffer,
+                                   gpointer user_data);
+
+    static void drawSegmentCallback(GstElement* overlay,
+                                    cairo_t* cr,
+                                    guint64 timestamp,
+                                    guint64 duration,
+                                    gpointer user_data);
+
   public:
     void addImageSegment(GstPipelineImx &pipeline,
                          const ImageSegmentOptions &options);
 
+    void addImageSegmentOverlay(GstPipelineImx &pipeline);
+
+    void connectImageSegment(GstPipelineImx &pipeline);
+
+    std::vector<int> getClassPixelCounts();
+
     void addImageLabeling(GstPipelineImx &pipeline,
                           const std::filesystem::path &labelsPath);
 
     void addBoundingBoxes(GstPipelineImx &pipeline,
                           const BoundingBoxesOptions &options);
+
+    void addBoundingBoxesOverlay(GstPipelineImx &pipeline);
+
+    void connectBoundingBoxes(GstPipelineImx &pipeline);
+
+    const std::vector<DetectedBox>& getBoundingBoxes() const;
+
+    std::string getBoundingBoxesSinkName() const { return tensorSinkName; }
+
+    void setResultsPublisher(ResultsPublisher* publisher,
+                             const std::string &source="");
+
+    std::string getLabel(const int &classId) const;
 };
 #endif
\ No newline at end of file
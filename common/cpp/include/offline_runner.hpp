@@ -0,0 +1,57 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CPP_OFFLINE_RUNNER_H_
+#define CPP_OFFLINE_RUNNER_H_
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Inference threads of a CPU pipeline when number of jobs is sized automatically
+#define OFFLINE_CPU_THREADS_PER_JOB 2
+// Pipelines sharing an accelerator, one can decode while another one infers
+#define OFFLINE_ACCELERATOR_JOBS    2
+
+
+/**
+ * @brief Processing of an input: build and parse its pipeline while build
+ *        lock is held, release the lock, run the pipeline to completion
+ *        and return the number of processed frames.
+ */
+typedef std::function<uint64_t(const std::filesystem::path &input,
+                               std::unique_lock<std::mutex> &buildLock)> OfflineJob;
+
+
+/**
+ * @brief Process a list of inputs as fast as possible, with concurrent
+ *        offline pipelines, and report aggregate throughput.
+ */
+class OfflineRunner {
+  private:
+    std::vector<std::filesystem::path> inputs;
+    int numJobs;
+    int threadsPerJob;
+    std::mutex buildMutex;
+    std::atomic<size_t> nextInput{0};
+    std::atomic<uint64_t> totalFrames{0};
+
+    void worker(const OfflineJob &job);
+
+  public:
+    OfflineRunner(const std::vector<std::filesystem::path> &inputs,
+                  const std::string &backend,
+                  const int &numJobs=0);
+
+    int getNumJobs() const { return numJobs; }
+
+    int getThreadsPerJob() const { return threadsPerJob; }
+
+    uint64_t run(const OfflineJob &job);
+};
+#endif
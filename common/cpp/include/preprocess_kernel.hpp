@@ -0,0 +1,108 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CPP_PREPROCESS_KERNEL_H_
+#define CPP_PREPROCESS_KERNEL_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "letterbox.hpp"
+#include "logging.hpp"
+#include "tensor_custom_data_generator.hpp"
+
+#define PREPROCESS_MAX_PLANES   3
+
+
+/**
+ * @brief Native CPU preprocessing kernel: bilinear resize, color conversion
+ *        to RGB, BGR or GRAY8, and normalization to the model input type.
+ *
+ * Each output row reads its two source rows once. They are decoded and
+ * horizontally interpolated in small row buffers, reused by the next output
+ * row when it needs the same source row. Vertical interpolation, color
+ * conversion and normalization are then done together on the row buffers,
+ * with NEON on aarch64, so frame data is walked in a single pass. With
+ * letterbox, the frame is resized keeping its aspect ratio and padded with
+ * black.
+ */
+class PreprocessKernel {
+  private:
+    // Component decoding, components are Y, U, V or R, G, B
+    bool isYUV;
+    int numComponents;
+    int componentPlane[3];
+    bool componentHalfRows[3];
+    std::vector<int32_t> componentOffsets[3][2];
+
+    int inputWidth;
+    int inputHeight;
+    int outputWidth;
+    int outputHeight;
+    int outputChannels;
+    // Resized frame placement in output, whole output without letterbox
+    Letterbox placement;
+    bool swapRedBlue;
+    Normalization normalization;
+
+    std::vector<uint16_t> xWeights;
+    std::vector<int> yIndex;
+    std::vector<uint16_t> yWeights;
+
+    // YUV to RGB coefficients, scaled by 256
+    int32_t lumaOffset;
+    int32_t coefY;
+    int32_t coefRV;
+    int32_t coefGU;
+    int32_t coefGV;
+    int32_t coefBU;
+
+    std::vector<uint16_t> rows[2][3];
+    int rowSource[2];
+    std::vector<uint8_t> pixels;
+    std::vector<uint8_t> paddingRow;
+
+    void decodeRow(const uint8_t* const planes[],
+                   const int strides[],
+                   const int &sourceRow,
+                   const int &slot);
+
+    void convertRow(const int &top,
+                    const int &bottom,
+                    const uint16_t &weight,
+                    uint8_t* output);
+
+    void normalizeRow(const uint8_t* input, void* output);
+
+  public:
+    PreprocessKernel(const std::string &inputFormat,
+                     const int &inputWidth,
+                     const int &inputHeight,
+                     const std::string &outputFormat,
+                     const int &outputWidth,
+                     const int &outputHeight,
+                     const Normalization &normalization,
+                     const bool &letterbox=false,
+                     const bool &bt709=false,
+                     const bool &fullRange=false);
+
+    void process(const uint8_t* const planes[],
+                 const int strides[],
+                 void* output);
+
+    size_t getOutputSize() const;
+
+    static bool isInputFormatSupported(const std::string &format);
+
+    static bool isOutputFormatSupported(const std::string &format);
+
+    static int getNumPlanes(const std::string &format);
+
+    static std::string getTensorType(const Normalization &normalization);
+
+    static size_t getTensorTypeSize(const Normalization &normalization);
+};
+#endif
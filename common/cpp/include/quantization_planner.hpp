@@ -0,0 +1,88 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CPP_QUANTIZATION_PLANNER_H_
+#define CPP_QUANTIZATION_PLANNER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "tensor_custom_data_generator.hpp"
+
+#define INPUT_MAX_CHANNELS   3
+
+
+/**
+ * @brief Model input tensor types handled by the planner.
+ */
+enum class InputType {
+  uint8,
+  int8,
+  float32,
+  other,
+};
+
+
+/**
+ * @brief Model input type and quantization, real = scale * (q - zeroPoint).
+ *        Scales and zero points hold one value, or one value per channel,
+ *        and are empty for float models.
+ */
+typedef struct {
+  InputType type;
+  std::vector<float> scales;
+  std::vector<int32_t> zeroPoints;
+} InputQuantization;
+
+
+/**
+ * @brief Real values expected by the model for 8 bits pixel values,
+ *        real = (pixel - mean) / std for each channel.
+ */
+typedef struct {
+  float mean[INPUT_MAX_CHANNELS];
+  float std[INPUT_MAX_CHANNELS];
+} PixelNormalization;
+
+
+/**
+ * @brief Transform from 8 bits pixels to model input values.
+ */
+enum class InputTransform {
+  none,             // pixels are fed as is
+  zeroPointShift,   // pixel - 128 as int8
+  affine,           // pixel * mul + add, cast to model input type
+};
+
+
+/**
+ * @brief Minimal model input transform. Normalization is the equivalent
+ *        named normalization, when transform has one.
+ */
+typedef struct {
+  InputTransform transform;
+  bool hasNormalization;
+  Normalization normalization;
+  InputType type;
+  int channels;
+  float mul[INPUT_MAX_CHANNELS];
+  float add[INPUT_MAX_CHANNELS];
+} InputPlan;
+
+
+bool parsePixelNormalization(const std::string &norm,
+                             PixelNormalization &pixelNorm);
+
+InputPlan planInputTransform(const InputQuantization &quantization,
+                             const std::string &norm,
+                             const int &channels);
+
+std::string inputTypeName(const InputType &type);
+
+std::string normalizationName(const Normalization &normalization);
+
+std::string describeInputPlan(const InputPlan &plan);
+#endif
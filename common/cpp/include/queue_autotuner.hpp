@@ -0,0 +1,122 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CPP_QUEUE_AUTOTUNER_H_
+#define CPP_QUEUE_AUTOTUNER_H_
+
+#include <gst/gst.h>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "gst_pipeline_imx.hpp"
+
+// Period of queue occupancy observation, settings change at most once
+#define AUTOTUNE_WINDOW_NS          (1000 * 1000 * 1000ULL)
+// Windows without change before settings are considered converged
+#define AUTOTUNE_STABLE_WINDOWS     3
+// Mean number of waiting buffers considered a standing backlog
+#define AUTOTUNE_BACKLOG_LEVEL      0.5f
+
+
+/**
+ * @brief Queue tuned from its occupancy, with bounds of max-size-buffers,
+ *        and upper bound of max-size-time.
+ */
+typedef struct {
+  std::string queueName;
+  int minBuffers = 1;                         //optional
+  int maxBuffers = 8;                         //optional
+  uint64_t maxTimeNs = 1000 * 1000 * 1000ULL; //optional
+} AutotuneQueueOptions;
+
+
+/**
+ * @brief Settings and occupancy of a tuned queue.
+ */
+typedef struct {
+  std::string queueName;
+  int maxSizeBuffers;
+  uint64_t maxSizeTimeNs;
+  float meanLevel;
+  uint64_t overruns;
+  uint64_t underruns;
+  bool converged;
+} AutotuneQueueSettings;
+
+
+/**
+ * @brief Queue depth autotuner. Each window, a queue which overran and
+ *        underran, i.e. dropped or blocked frames and starved its
+ *        downstream stage, gets one more buffer, and a queue holding a
+ *        standing backlog without underrun gets one less buffer, since
+ *        waiting buffers only add latency. max-size-time follows
+ *        max-size-buffers at observed frame interval, so that a slower
+ *        source does not increase latency.
+ */
+class QueueAutotuner {
+  private:
+    typedef struct {
+      QueueAutotuner* autotuner;
+      int index;
+      AutotuneQueueOptions options;
+      int maxSizeBuffers;
+      uint64_t maxSizeTimeNs;
+      int starvedBuffers;
+      uint64_t lastArrivalNs;
+      uint64_t arrivalIntervalNs;
+      uint64_t windowStartNs;
+      uint64_t windowDepartures;
+      uint64_t windowLevelSum;
+      uint64_t windowOverruns;
+      uint64_t windowUnderruns;
+      float meanLevel;
+      uint64_t overruns;
+      uint64_t underruns;
+      int stableWindows;
+      bool converged;
+    } TunedQueue;
+
+    std::mutex mutex;
+    std::deque<TunedQueue> queues;
+
+    bool tune(TunedQueue &queue);
+
+    static void applySettings(GstElement* element,
+                              const int &maxSizeBuffers,
+                              const uint64_t &maxSizeTimeNs);
+
+    static GstPadProbeReturn arrivalProbe(GstPad* pad,
+                                          GstPadProbeInfo* info,
+                                          gpointer user_data);
+
+    static GstPadProbeReturn departureProbe(GstPad* pad,
+                                            GstPadProbeInfo* info,
+                                            gpointer user_data);
+
+    static void overrunCallback(GstElement* element, gpointer user_data);
+
+    static void underrunCallback(GstElement* element, gpointer user_data);
+
+  public:
+    int addQueue(const AutotuneQueueOptions &options);
+
+    void attach(GstPipelineImx &pipeline);
+
+    void arrive(const int &queue, const uint64_t &nowNs);
+
+    bool depart(const int &queue, const int &level, const uint64_t &nowNs);
+
+    void countOverrun(const int &queue);
+
+    void countUnderrun(const int &queue);
+
+    std::vector<AutotuneQueueSettings> getSettings();
+
+    void logSettings();
+};
+#endif
@@ -0,0 +1,200 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CPP_RESULTS_PUBLISHER_H_
+#define CPP_RESULTS_PUBLISHER_H_
+
+#include <gst/gst.h>
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define RESULTS_MAGIC           0x31534552  // "RES1"
+#define RESULTS_LABEL_SIZE      32
+#define RESULTS_SOURCE_SIZE     32
+// Messages kept for a slow socket client before it is disconnected
+#define RESULTS_SOCKET_BACKLOG  (256 * 1024)
+
+
+/**
+ * @brief Detected box, in pixels of the decoder output resolution.
+ */
+typedef struct {
+  float x1;
+  float y1;
+  float x2;
+  float y2;
+  float score;
+  int32_t classId;
+  char label[RESULTS_LABEL_SIZE];
+} ResultBox;
+
+
+/**
+ * @brief Keypoint, group tells which person or object it belongs to.
+ */
+typedef struct {
+  float x;
+  float y;
+  float score;
+  int32_t group;
+} ResultKeypoint;
+
+
+/**
+ * @brief Header of a binary results record, followed by boxes and
+ *        keypoints.
+ */
+typedef struct {
+  uint32_t magic;
+  uint32_t size;
+  uint64_t sequence;
+  uint64_t pts;
+  uint64_t monotonicNs;
+  uint32_t numBoxes;
+  uint32_t numKeypoints;
+  char source[RESULTS_SOURCE_SIZE];
+} ResultsHeader;
+
+
+/**
+ * @brief Decoder outputs of a frame. Reusing the same object for every
+ *        frame avoids allocations.
+ */
+typedef struct {
+  std::string source;
+  GstClockTime pts = GST_CLOCK_TIME_NONE;
+  std::vector<ResultBox> boxes;
+  std::vector<ResultKeypoint> keypoints;
+} FrameResults;
+
+
+/**
+ * @brief Wire format of results.
+ */
+enum class ResultsFormat {
+  json,
+  binary,
+};
+
+
+/**
+ * @brief Results publisher options, a transport is disabled if its name is empty.
+ */
+typedef struct {
+  std::filesystem::path socketPath = "";
+  ResultsFormat socketFormat = ResultsFormat::json;
+  std::string shmName = "";
+  size_t shmSize = 1 << 20;
+} ResultsPublisherOptions;
+
+
+/**
+ * @brief Header of the shared memory ring. Records are never split, a
+ *        record with a zero magic tells readers to wrap to ring start.
+ */
+typedef struct {
+  uint32_t magic;
+  uint32_t headerSize;
+  uint64_t capacity;
+  std::atomic<uint64_t> writePos;
+  std::atomic<uint64_t> reservePos;
+  std::atomic<uint64_t> lastPos;
+  uint8_t reserved[64 - 40];
+} ResultsRingHeader;
+
+
+std::string toJsonString(const std::string &text);
+
+ResultBox makeResultBox(const float &x1,
+                        const float &y1,
+                        const float &x2,
+                        const float &y2,
+                        const float &score,
+                        const int &classId,
+                        const std::string &label);
+
+
+/**
+ * @brief Publish decoder outputs on a Unix-domain socket, as JSON lines or
+ *        binary records, and on a shared memory ring of binary records.
+ *        Publishing never blocks the streaming thread.
+ */
+class ResultsPublisher {
+  private:
+    typedef struct {
+      int fd;
+      std::vector<uint8_t> pending;
+    } Client;
+
+    ResultsPublisherOptions options;
+    int listenFd = -1;
+    std::vector<Client> clients;
+    std::mutex clientsMutex;
+    std::atomic<bool> running{true};
+    std::thread acceptThread;
+    uint8_t* ring = nullptr;
+    size_t ringMapSize = 0;
+    uint64_t sequence = 0;
+    std::mutex publishMutex;
+    std::vector<uint8_t> binary;
+    std::string json;
+
+    void acceptClients();
+
+    void sendToClients(const uint8_t* data, const size_t &size);
+
+    void writeToRing(const uint8_t* data, const size_t &size);
+
+  public:
+    ResultsPublisher(const ResultsPublisherOptions &options);
+
+    ResultsPublisher(const ResultsPublisher&) = delete;
+
+    ResultsPublisher& operator=(const ResultsPublisher&) = delete;
+
+    ~ResultsPublisher();
+
+    void publish(const FrameResults &results);
+
+    static void serialize(const FrameResults &results,
+                          const uint64_t &sequence,
+                          std::vector<uint8_t> &binary);
+
+    static void toJson(const FrameResults &results,
+                       const uint64_t &sequence,
+                       std::string &json);
+};
+
+
+/**
+ * @brief Read binary records of a shared memory ring, for co-located
+ *        consumers. Records overwritten before being read are counted as lost.
+ */
+class ResultsSubscriber {
+  private:
+    const uint8_t* ring = nullptr;
+    size_t ringMapSize = 0;
+    uint64_t readPos = 0;
+    uint64_t lastSequence = 0;
+    uint64_t lost = 0;
+
+  public:
+    ResultsSubscriber(const std::string &shmName);
+
+    ResultsSubscriber(const ResultsSubscriber&) = delete;
+
+    ResultsSubscriber& operator=(const ResultsSubscriber&) = delete;
+
+    ~ResultsSubscriber();
+
+    bool poll(std::vector<uint8_t> &record);
+
+    uint64_t getLost() const { return lost; }
+};
+#endif
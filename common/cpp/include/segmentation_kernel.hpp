@@ -0,0 +1,66 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CPP_SEGMENTATION_KERNEL_H_
+#define CPP_SEGMENTATION_KERNEL_H_
+
+#include <gst/gst.h>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "logging.hpp"
+
+
+/**
+ * @brief Native segmentation kernel: per-pixel argmax over classes, palette
+ *        lookup and alpha blending into the display frame.
+ *
+ * The label mask is computed at model resolution once for each model
+ * output, and class pixel counts are accumulated in the same pass. The
+ * mask is upscaled on the fly while blending, it is never materialized at
+ * display resolution.
+ */
+class SegmentationKernel {
+  private:
+    int numClasses;
+    int maskWidth;
+    int maskHeight;
+    uint32_t palette[256];
+    uint8_t paletteAlpha[256];
+
+    std::mutex bufferMutex;
+    GstBuffer* pendingBuffer = nullptr;
+
+    // Only accessed from the drawing thread
+    GstBuffer* currentBuffer = nullptr;
+    std::vector<uint8_t> labels;
+    std::vector<int> counts;
+    std::vector<int> xIndex;
+    int lastWidth = 0;
+
+    std::mutex countsMutex;
+    std::vector<int> publishedCounts;
+
+    void computeRow(const float* logits, const int &row);
+
+  public:
+    SegmentationKernel(const int &numClasses,
+                       const int &maskWidth,
+                       const int &maskHeight,
+                       const float &alpha);
+
+    ~SegmentationKernel();
+
+    void setBuffer(GstBuffer* buffer);
+
+    void blend(uint8_t* frame,
+               const int &width,
+               const int &height,
+               const int &stride);
+
+    std::vector<int> getClassPixelCounts();
+};
+#endif
@@ -0,0 +1,81 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CPP_SSD_BOX_DECODER_H_
+#define CPP_SSD_BOX_DECODER_H_
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "letterbox.hpp"
+#include "logging.hpp"
+
+
+/**
+ * @brief Compact detection result, coordinates are given in output dimension.
+ */
+typedef struct {
+  float x1;
+  float y1;
+  float x2;
+  float y2;
+  float score;
+  int classId;
+} DetectedBox;
+
+
+/**
+ * @brief Native MobileNet-SSD decoder working on raw model output.
+ *
+ * Box priors are loaded once into a packed structure of arrays, and only
+ * anchors with a score above the threshold are decoded. Scores are compared
+ * in logit space so that the sigmoid is only computed for kept anchors.
+ */
+class SSDBoxDecoder {
+  private:
+    int numAnchors = 0;
+    int numClasses = 0;
+    int outWidth;
+    int outHeight;
+    float threshold = 0.5f;
+    float logitThreshold;
+    float yScale = 10.0f;
+    float xScale = 10.0f;
+    float hScale = 5.0f;
+    float wScale = 5.0f;
+    float iouThreshold = 0.5f;
+    // Placement of frame in model input, boxes are mapped back to frame
+    Letterbox letterbox{};
+    std::vector<std::string> labels;
+    // Packed priors table: [ycenter | xcenter | height | width]
+    std::vector<float> priors;
+    std::vector<DetectedBox> candidates;
+
+    void loadPriors(const std::filesystem::path &boxesPath);
+
+    void loadLabels(const std::filesystem::path &labelsPath);
+
+    void nonMaximumSuppression(std::vector<DetectedBox> &boxes);
+
+  public:
+    SSDBoxDecoder(const std::string &option3,
+                  const std::filesystem::path &labelsPath,
+                  const int &outWidth,
+                  const int &outHeight);
+
+    void decode(const float* locations,
+                const int &locationsSize,
+                const float* scores,
+                const int &scoresSize,
+                std::vector<DetectedBox> &boxes);
+
+    void setLetterbox(const Letterbox &letterbox) { this->letterbox = letterbox; }
+
+    int getNumAnchors() const { return numAnchors; }
+
+    std::string getLabel(const int &classId) const;
+};
+#endif
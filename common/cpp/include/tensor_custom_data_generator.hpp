@@ -1,5 +1,5 @@
 /**
- * Copyright 2024-2025 NXP
+ * Copyright 2024-2026 NXP
  * SPDX-License-Identifier: BSD-3-Clause 
  */
 
@@ -95,5 +95,11 @@ class TensorCustomGenerator {
     std::string GPU();
 
     std::string setTensorTransformConfig(const std::string &norm, GstPipelineImx &pipeline);
+
+    std::string setAffineTransformConfig(const float mul[],
+                                         const float add[],
+                                         const int &channels,
+                                         const std::string &type,
+                                         GstPipelineImx &pipeline);
 };
 #endif
\ No newline at end of file
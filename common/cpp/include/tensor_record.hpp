@@ -0,0 +1,154 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CPP_TENSOR_RECORD_H_
+#define CPP_TENSOR_RECORD_H_
+
+#include <gst/gst.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gst_pipeline_imx.hpp"
+
+#define TENSOR_RECORD_MAGIC       "NNSTREC1"
+#define TENSOR_RECORD_VERSION     1
+// Alignment of records and tensors, tensors can be used in place once mapped
+#define TENSOR_RECORD_ALIGNMENT   64
+#define TENSOR_RECORD_MAX_TENSORS 16
+// Buffers waiting for the writer thread, newer buffers are dropped above
+#define TENSOR_RECORD_MAX_PENDING 64
+
+
+/**
+ * @brief Header at the beginning of a recording file.
+ */
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t alignment;
+  uint8_t reserved[TENSOR_RECORD_ALIGNMENT - 16];
+} TensorRecordFileHeader;
+
+
+/**
+ * @brief Header of a recorded buffer. It is followed by caps string if caps
+ *        changed since previous record, then by tensors, each one aligned.
+ */
+typedef struct {
+  uint64_t recordSize;
+  uint64_t pts;
+  uint64_t duration;
+  uint32_t capsSize;
+  uint32_t numTensors;
+  uint64_t tensorSizes[TENSOR_RECORD_MAX_TENSORS];
+} TensorRecordEntry;
+
+
+/**
+ * @brief Record buffers received by a tensor_sink in an append-only file.
+ *        Buffers are written by a background thread, the streaming thread
+ *        only takes a reference on them.
+ */
+class TensorRecorder {
+  private:
+    typedef struct {
+      GstBuffer* buffer;
+      GstCaps* caps;
+    } PendingBuffer;
+
+    std::string path;
+    FILE* file = nullptr;
+    GstCaps* lastCaps = nullptr;
+    std::deque<PendingBuffer> pending;
+    std::mutex pendingMutex;
+    std::condition_variable pendingCondition;
+    bool running = true;
+    std::atomic<uint64_t> numRecords{0};
+    std::thread worker;
+
+    void run();
+
+    void write(const PendingBuffer &data);
+
+  public:
+    TensorRecorder(const std::string &path);
+
+    TensorRecorder(const TensorRecorder&) = delete;
+
+    TensorRecorder& operator=(const TensorRecorder&) = delete;
+
+    ~TensorRecorder();
+
+    void connectToTensorSink(GstPipelineImx &pipeline, const std::string &gstName);
+
+    static void newDataCallback(GstElement* element,
+                                GstBuffer* buffer,
+                                gpointer user_data);
+};
+
+
+/**
+ * @brief Replay a recording, either through tensor_sink callbacks or as
+ *        an appsrc source, at recorded timing or at maximum speed.
+ */
+class TensorReplay {
+  private:
+    typedef struct {
+      const TensorRecordEntry* entry;
+      size_t capsIndex;
+      const uint8_t* tensors[TENSOR_RECORD_MAX_TENSORS];
+    } Record;
+
+    std::string path;
+    uint8_t* data = nullptr;
+    size_t dataSize = 0;
+    std::vector<Record> records;
+    std::vector<std::string> capsList;
+    std::string gstName;
+    bool realTime = true;
+    size_t nextRecord = 0;
+    size_t lastCapsIndex = 0;
+    std::chrono::steady_clock::time_point startTime;
+
+    void waitForRecord(const size_t &index,
+                       const std::chrono::steady_clock::time_point &start) const;
+
+  public:
+    TensorReplay(const std::string &path);
+
+    TensorReplay(const TensorReplay&) = delete;
+
+    TensorReplay& operator=(const TensorReplay&) = delete;
+
+    ~TensorReplay();
+
+    size_t getNumRecords() const { return records.size(); }
+
+    const std::string& getCaps(const size_t &index) const;
+
+    GstBuffer* getBuffer(const size_t &index) const;
+
+    void replay(void (*callback)(GstElement*, GstBuffer*, gpointer),
+                gpointer userData,
+                const bool &realTime=true);
+
+    void addReplayToPipeline(GstPipelineImx &pipeline,
+                             const std::string &gstName,
+                             const bool &realTime=true);
+
+    void connectReplay(GstPipelineImx &pipeline);
+
+    static void needDataCallback(GstElement* appsrc,
+                                 guint length,
+                                 gpointer user_data);
+};
+#endif
@@ -0,0 +1,82 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CPP_TRIPLE_BUFFER_H_
+#define CPP_TRIPLE_BUFFER_H_
+
+#include <atomic>
+#include <cstdint>
+
+
+/**
+ * @brief Lock-free handoff of results from one producer thread to one
+ *        consumer thread.
+ *
+ * Producer fills writeBuffer() and calls publish(), consumer calls update()
+ * then reads readBuffer(). Both sides always own a different buffer, so the
+ * consumer gets a consistent snapshot of the latest published results, and
+ * neither side ever waits. Buffers are reused, so containers keep their
+ * capacity and no allocation happens once they are warmed up.
+ */
+template<typename T>
+class TripleBuffer {
+  private:
+    static constexpr uint8_t indexMask = 0x3;
+    static constexpr uint8_t freshFlag = 0x4;
+
+    T buffers[3] {};
+    // Shared buffer index, flagged when holding unread results
+    std::atomic<uint8_t> middle {1};
+    // Owned by producer
+    uint8_t back = 0;
+    // Owned by consumer
+    uint8_t front = 2;
+    uint32_t generation = 0;
+
+  public:
+    TripleBuffer() = default;
+
+    TripleBuffer(const TripleBuffer&) = delete;
+
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    /**
+     * @brief Get buffer to write results to, producer side.
+     */
+    T& writeBuffer() { return buffers[back]; }
+
+    /**
+     * @brief Make written results available to consumer, producer side.
+     */
+    void publish()
+    {
+      back = middle.exchange(back | freshFlag, std::memory_order_acq_rel) & indexMask;
+    }
+
+    /**
+     * @brief Switch to latest published results if any, consumer side.
+     *
+     * @return true if new results are available.
+     */
+    bool update()
+    {
+      if ((middle.load(std::memory_order_relaxed) & freshFlag) == 0)
+        return false;
+      front = middle.exchange(front, std::memory_order_acq_rel) & indexMask;
+      generation += 1;
+      return true;
+    }
+
+    /**
+     * @brief Get latest results taken by update(), consumer side.
+     */
+    const T& readBuffer() const { return buffers[front]; }
+
+    /**
+     * @brief Get number of results taken by update(), consumer side.
+     */
+    uint32_t getGeneration() const { return generation; }
+};
+#endif
@@ -0,0 +1,240 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include <tensorflow/lite/interpreter.h>
+#include <tensorflow/lite/kernels/register.h>
+#include <tensorflow/lite/delegates/external/external_delegate.h>
+
+#include "backend_selector.hpp"
+#include "logging.hpp"
+
+
+/**
+ * @brief Backends available on this i.MX, probed by auto backend. GPU of
+ *        i.MX95 is not an external delegate library and is not probed.
+ */
+std::vector<std::string> candidateBackends(imx::Imx &imx)
+{
+  std::vector<std::string> backends = {"CPU"};
+  if (imx.hasVsiGPU())
+    backends.push_back("GPU");
+  if (imx.hasNPU())
+    backends.push_back("NPU");
+  return backends;
+}
+
+
+/**
+ * @brief External delegate library of a backend, as used by tensor_filter,
+ *        empty for CPU.
+ */
+static std::string delegateLibrary(const std::string &backend, imx::Imx &imx)
+{
+  if (backend == "GPU" && imx.hasVsiGPU()) {
+    setenv("USE_GPU_INFERENCE", "1", 1);
+    return "libvx_delegate.so";
+  }
+  if (backend == "NPU") {
+    if (imx.isIMX8() && imx.hasNPU()) {
+      setenv("USE_GPU_INFERENCE", "0", 1);
+      return "libvx_delegate.so";
+    }
+    if (imx.hasEthosNPU())
+      return "libethosu_delegate.so";
+    if (imx.hasNeutronNPU())
+      return "libneutron_delegate.so";
+  }
+  return "";
+}
+
+
+/**
+ * @brief Hash of model file content (64 bits FNV-1a), as hexadecimal.
+ */
+std::string modelHash(const std::filesystem::path &path)
+{
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    log_error("Can't read %s\n", path.c_str());
+    exit(-1);
+  }
+
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  std::vector<char> chunk(1 << 16);
+  while (file) {
+    file.read(chunk.data(), chunk.size());
+    for (std::streamsize i = 0; i < file.gcount(); i++) {
+      hash ^= (unsigned char) chunk[i];
+      hash *= 0x100000001b3ULL;
+    }
+  }
+
+  char hex[17];
+  snprintf(hex, sizeof(hex), "%016llx", (unsigned long long) hash);
+  return hex;
+}
+
+
+/**
+ * @brief Time model invocations on a backend, after a warm-up invocation
+ *        which includes graph compilation.
+ *
+ * @param path: TFlite model path.
+ * @param backend: CPU, GPU or NPU.
+ * @param imx: i.MX used.
+ * @param numThreads: number of threads for CPU operations.
+ * @return median inference time, backend unavailable if model can't run.
+ */
+BackendProbe probeBackend(const std::filesystem::path &path,
+                          const std::string &backend,
+                          imx::Imx &imx,
+                          const int &numThreads)
+{
+  BackendProbe probe = {backend, false, 0};
+  std::unique_ptr<tflite::FlatBufferModel> model;
+  model = tflite::FlatBufferModel::BuildFromFile(path.string().c_str());
+  if (model == nullptr) {
+    log_error("Failed to load model\n");
+    exit(-1);
+  }
+
+  std::unique_ptr<tflite::Interpreter> interpreter;
+  tflite::ops::builtin::BuiltinOpResolver resolver;
+  tflite::InterpreterBuilder(*model.get(), resolver)(&interpreter);
+  if (interpreter == nullptr) {
+    log_error("Failed to initiate the interpreter\n");
+    exit(-1);
+  }
+  interpreter->SetNumThreads(numThreads);
+
+  std::string library = delegateLibrary(backend, imx);
+  if (library.length() != 0) {
+    auto delegateOptions = TfLiteExternalDelegateOptionsDefault(library.c_str());
+    auto externalDelegate = TfLiteExternalDelegateCreate(&delegateOptions);
+    if (externalDelegate == nullptr) {
+      log_debug("%s delegate unavailable\n", library.c_str());
+      return probe;
+    }
+    auto delegate = tflite::Interpreter::TfLiteDelegatePtr(
+                        externalDelegate, [](TfLiteDelegate* delegate) {
+                        TfLiteExternalDelegateDelete(delegate); }
+                        );
+    if (interpreter->ModifyGraphWithDelegate(std::move(delegate)) != kTfLiteOk) {
+      log_debug("Failed to apply %s delegate\n", library.c_str());
+      return probe;
+    }
+  }
+
+  if ((interpreter->AllocateTensors() != kTfLiteOk)
+      || (interpreter->Invoke() != kTfLiteOk)) {
+    log_debug("Failed to run model on %s\n", backend.c_str());
+    return probe;
+  }
+
+  std::vector<float> durations;
+  for (int i = 0; i < BACKEND_PROBE_INVOCATIONS; i++) {
+    auto start = std::chrono::steady_clock::now();
+    if (interpreter->Invoke() != kTfLiteOk)
+      return probe;
+    std::chrono::duration<float, std::milli> duration = std::chrono::steady_clock::now() - start;
+    durations.push_back(duration.count());
+  }
+  std::sort(durations.begin(), durations.end());
+  probe.available = true;
+  probe.inferenceMs = durations[durations.size() / 2];
+  return probe;
+}
+
+
+/**
+ * @brief Path of selected backends cache.
+ */
+static std::filesystem::path cachePath()
+{
+  const char* cacheHome = getenv("XDG_CACHE_HOME");
+  if (cacheHome != nullptr && cacheHome[0] != '\0')
+    return std::filesystem::path(cacheHome) / BACKEND_CACHE_FILE;
+  const char* home = getenv("HOME");
+  if (home == nullptr)
+    return "";
+  return std::filesystem::path(home) / ".cache" / BACKEND_CACHE_FILE;
+}
+
+
+/**
+ * @brief Select fastest backend of a model, probed at first run on this
+ *        SoC, then read from cache. Cache lines are "soc hash backend ms",
+ *        remove the cache file to probe again, e.g. after a BSP update.
+ *
+ * @param path: TFlite model path.
+ * @param imx: i.MX used.
+ * @param numThreads: number of threads for CPU operations.
+ * @return CPU, GPU or NPU.
+ */
+std::string selectBackend(const std::filesystem::path &path,
+                          imx::Imx &imx,
+                          const int &numThreads)
+{
+  std::string soc = imx.socName();
+  std::replace(soc.begin(), soc.end(), ' ', '_');
+  std::string hash = modelHash(path);
+  std::filesystem::path cache = cachePath();
+
+  std::ifstream cacheFile(cache);
+  std::string line;
+  while (std::getline(cacheFile, line)) {
+    std::istringstream fields(line);
+    std::string cachedSoc, cachedHash, backend;
+    if ((fields >> cachedSoc >> cachedHash >> backend)
+        && (cachedSoc == soc) && (cachedHash == hash)) {
+      log_info("%s: %s backend (cached)\n", path.filename().c_str(), backend.c_str());
+      return backend;
+    }
+  }
+
+  // Probes set USE_GPU_INFERENCE, restored for tensor_filter configuration
+  const char* gpuInference = getenv("USE_GPU_INFERENCE");
+  std::string savedGpuInference = (gpuInference != nullptr) ? gpuInference : "";
+
+  BackendProbe fastest = {"CPU", false, 0};
+  for (const std::string &backend : candidateBackends(imx)) {
+    BackendProbe probe = probeBackend(path, backend, imx, numThreads);
+    if (!probe.available)
+      continue;
+    log_info("%s: %s backend %.2f ms\n", path.filename().c_str(),
+             backend.c_str(), probe.inferenceMs);
+    if (!fastest.available || probe.inferenceMs < fastest.inferenceMs)
+      fastest = probe;
+  }
+  if (gpuInference != nullptr)
+    setenv("USE_GPU_INFERENCE", savedGpuInference.c_str(), 1);
+  else
+    unsetenv("USE_GPU_INFERENCE");
+
+  if (!fastest.available) {
+    log_error("%s can't run on any backend\n", path.c_str());
+    exit(-1);
+  }
+  log_info("%s: %s backend selected\n", path.filename().c_str(), fastest.backend.c_str());
+
+  if (cache.empty())
+    return fastest.backend;
+  std::error_code error;
+  std::filesystem::create_directories(cache.parent_path(), error);
+  std::ofstream output(cache, std::ios::app);
+  if (!output) {
+    log_debug("Can't write %s\n", cache.c_str());
+    return fastest.backend;
+  }
+  output << soc << " " << hash << " " << fastest.backend << " "
+         << fastest.inferenceMs << std::endl;
+  return fastest.backend;
+}
@@ -0,0 +1,143 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "cached_overlay.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+// Layer is scanned in tiles to only blit regions holding drawn pixels
+#define CACHED_OVERLAY_TILE_SIZE    64
+
+
+CachedOverlay::~CachedOverlay()
+{
+  if (context != nullptr)
+    cairo_destroy(context);
+  if (surface != nullptr)
+    cairo_surface_destroy(surface);
+}
+
+
+/**
+ * @brief Get layer context if results changed since last rendering.
+ *
+ * @param cr: cairooverlay context, used to size the layer.
+ * @param generation: generation of results to draw.
+ * @return cleared layer context to draw on, or nullptr if cached layer
+ *         is up to date.
+ */
+cairo_t* CachedOverlay::beginRender(cairo_t* cr, const uint32_t &generation)
+{
+  cairo_surface_t* target = cairo_get_target(cr);
+  int width = cairo_image_surface_get_width(target);
+  int height = cairo_image_surface_get_height(target);
+
+  if ((surface == nullptr)
+      || (cairo_image_surface_get_width(surface) != width)
+      || (cairo_image_surface_get_height(surface) != height)) {
+    if (context != nullptr)
+      cairo_destroy(context);
+    if (surface != nullptr)
+      cairo_surface_destroy(surface);
+    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+    if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
+      log_error("Can't create overlay layer of %dx%d\n", width, height);
+      exit(-1);
+    }
+    context = cairo_create(surface);
+    // Font face is kept by the layer context across renderings
+    cairo_select_font_face(context,
+                           "Arial",
+                           CAIRO_FONT_SLANT_NORMAL,
+                           CAIRO_FONT_WEIGHT_NORMAL);
+    rendered = false;
+  }
+
+  if ((rendered == true) && (this->generation == generation))
+    return nullptr;
+
+  cairo_set_operator(context, CAIRO_OPERATOR_CLEAR);
+  cairo_paint(context);
+  cairo_set_operator(context, CAIRO_OPERATOR_OVER);
+  cairo_new_path(context);
+
+  this->generation = generation;
+  rendered = true;
+  dirty = true;
+  return context;
+}
+
+
+/**
+ * @brief Find tiles of the layer holding drawn pixels, merging adjacent
+ *        tiles of a row into a single region.
+ */
+void CachedOverlay::updateInkRegions()
+{
+  cairo_surface_flush(surface);
+  const unsigned char* data = cairo_image_surface_get_data(surface);
+  int width = cairo_image_surface_get_width(surface);
+  int height = cairo_image_surface_get_height(surface);
+  int stride = cairo_image_surface_get_stride(surface);
+
+  inkRegions.clear();
+  for (int y = 0; y < height; y += CACHED_OVERLAY_TILE_SIZE) {
+    int tileHeight = std::min(CACHED_OVERLAY_TILE_SIZE, height - y);
+    cairo_rectangle_int_t region = {0, y, 0, tileHeight};
+    for (int x = 0; x < width; x += CACHED_OVERLAY_TILE_SIZE) {
+      int tileWidth = std::min(CACHED_OVERLAY_TILE_SIZE, width - x);
+      bool ink = false;
+      for (int row = y; (row < y + tileHeight) && (ink == false); row++) {
+        // Transparent ARGB32 pixels are zero as alpha is premultiplied
+        const uint32_t* pixels = reinterpret_cast<const uint32_t*>(data + row * stride) + x;
+        for (int i = 0; i < tileWidth; i++) {
+          if (pixels[i] != 0) {
+            ink = true;
+            break;
+          }
+        }
+      }
+
+      if (ink == true) {
+        if (region.width == 0)
+          region.x = x;
+        region.width = x + tileWidth - region.x;
+      } else if (region.width != 0) {
+        inkRegions.push_back(region);
+        region.width = 0;
+      }
+    }
+    if (region.width != 0)
+      inkRegions.push_back(region);
+  }
+}
+
+
+/**
+ * @brief Blit cached layer on the frame.
+ *
+ * @param cr: cairooverlay context.
+ */
+void CachedOverlay::paint(cairo_t* cr)
+{
+  if (rendered == false)
+    return;
+
+  if (dirty == true) {
+    updateInkRegions();
+    dirty = false;
+  }
+  if (inkRegions.empty())
+    return;
+
+  cairo_save(cr);
+  cairo_set_source_surface(cr, surface, 0, 0);
+  for (const cairo_rectangle_int_t &region : inkRegions)
+    cairo_rectangle(cr, region.x, region.y, region.width, region.height);
+  cairo_fill(cr);
+  cairo_restore(cr);
+}
@@ -0,0 +1,190 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "compositor_layout.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+// Small tiles of picture-in-picture layout are a quarter of the display
+#define PIP_TILE_DIVIDER    4
+#define PIP_MARGIN_DIVIDER  40
+
+
+/**
+ * @brief Align a dimension down to an even value, required by YUV formats.
+ */
+static inline int alignEven(const int &value)
+{
+  return value & ~1;
+}
+
+
+/**
+ * @brief Parameterized constructor.
+ *
+ * @param layout: layout of inputs on display.
+ * @param numInputs: number of compositor inputs.
+ * @param displayWidth: display width.
+ * @param displayHeight: display height.
+ * @param sourceAspect: expected width / height ratio of inputs,
+ *                      used to pick the grid shape wasting less space.
+ */
+CompositorLayoutEngine::CompositorLayoutEngine(const CompositorLayout &layout,
+                                               const int &numInputs,
+                                               const int &displayWidth,
+                                               const int &displayHeight,
+                                               const float &sourceAspect)
+    : layout(layout), numInputs(numInputs),
+      displayWidth(displayWidth), displayHeight(displayHeight)
+{
+  if ((numInputs <= 0) || (displayWidth <= 0) || (displayHeight <= 0)) {
+    log_error("Invalid compositor layout: %d inputs on %dx%d display\n",
+              numInputs, displayWidth, displayHeight);
+    exit(-1);
+  }
+  if (layout == CompositorLayout::grid)
+    computeGrid(sourceAspect);
+}
+
+
+/**
+ * @brief Pick number of columns and rows maximizing displayed area
+ *        once inputs are letterboxed in their tile.
+ *
+ * @param sourceAspect: expected width / height ratio of inputs.
+ */
+void CompositorLayoutEngine::computeGrid(const float &sourceAspect)
+{
+  float bestArea = 0;
+  for (int cols = 1; cols <= numInputs; cols++) {
+    int numRows = (numInputs + cols - 1) / cols;
+    float tileWidth = static_cast<float>(displayWidth) / cols;
+    float tileHeight = static_cast<float>(displayHeight) / numRows;
+    float width = std::min(tileWidth, tileHeight * sourceAspect);
+    float height = width / sourceAspect;
+    float area = width * height;
+    if (area > bestArea) {
+      bestArea = area;
+      columns = cols;
+      rows = numRows;
+    }
+  }
+}
+
+
+/**
+ * @brief Get tile of an input.
+ *
+ * @param index: input index, in the order inputs are added to compositor.
+ */
+LayoutTile CompositorLayoutEngine::getTile(const int &index) const
+{
+  LayoutTile full = {0, 0, displayWidth, displayHeight};
+  LayoutTile tile;
+
+  switch (layout)
+  {
+    case CompositorLayout::grid:
+    {
+      int tileWidth = alignEven(displayWidth / columns);
+      int tileHeight = alignEven(displayHeight / rows);
+      int row = index / columns;
+      int col = index % columns;
+      // Center an incomplete last row
+      int rowInputs = std::min(columns, numInputs - row * columns);
+      int offset = (displayWidth - rowInputs * tileWidth) / 2;
+      tile.x = alignEven(offset + col * tileWidth);
+      tile.y = row * tileHeight;
+      tile.width = tileWidth;
+      tile.height = tileHeight;
+      return tile;
+    }
+
+    case CompositorLayout::pictureInPicture:
+    {
+      if (index == 0)
+        return full;
+      int margin = alignEven(displayHeight / PIP_MARGIN_DIVIDER);
+      tile.width = alignEven(displayWidth / PIP_TILE_DIVIDER);
+      tile.height = alignEven(displayHeight / PIP_TILE_DIVIDER);
+      // Fill from bottom right corner, right to left then bottom to top
+      int perRow = std::max(1, (displayWidth - margin) / (tile.width + margin));
+      int row = (index - 1) / perRow;
+      int col = (index - 1) % perRow;
+      tile.x = displayWidth - (col + 1) * (tile.width + margin);
+      tile.y = std::max(0, displayHeight - (row + 1) * (tile.height + margin));
+      return tile;
+    }
+
+    case CompositorLayout::overlay:
+    default:
+      return full;
+  }
+}
+
+
+/**
+ * @brief Fit a source in a tile keeping its aspect ratio, centered.
+ *
+ * @param tile: tile to fit source in.
+ * @param sourceWidth: source width.
+ * @param sourceHeight: source height.
+ */
+LayoutTile CompositorLayoutEngine::letterbox(const LayoutTile &tile,
+                                             const int &sourceWidth,
+                                             const int &sourceHeight)
+{
+  if ((sourceWidth <= 0) || (sourceHeight <= 0))
+    return tile;
+
+  LayoutTile fitted;
+  if (static_cast<long>(tile.width) * sourceHeight
+      <= static_cast<long>(tile.height) * sourceWidth) {
+    fitted.width = tile.width;
+    fitted.height = alignEven(tile.width * sourceHeight / sourceWidth);
+  } else {
+    fitted.height = tile.height;
+    fitted.width = alignEven(tile.height * sourceWidth / sourceHeight);
+  }
+  fitted.x = tile.x + alignEven((tile.width - fitted.width) / 2);
+  fitted.y = tile.y + alignEven((tile.height - fitted.height) / 2);
+  return fitted;
+}
+
+
+/**
+ * @brief Read preferred mode of first connected display from DRM sysfs.
+ *
+ * @param width: display width, unchanged if no display is found.
+ * @param height: display height, unchanged if no display is found.
+ * @return true if a connected display was found.
+ */
+bool CompositorLayoutEngine::readDisplayResolution(int &width, int &height)
+{
+  const std::filesystem::path drmPath = "/sys/class/drm";
+  std::error_code error;
+  for (const auto &entry : std::filesystem::directory_iterator(drmPath, error)) {
+    std::ifstream statusFile(entry.path() / "status");
+    std::string status;
+    if (!(statusFile >> status) || (status != "connected"))
+      continue;
+
+    // First mode is the preferred one
+    std::ifstream modesFile(entry.path() / "modes");
+    std::string mode;
+    int modeWidth, modeHeight;
+    if ((modesFile >> mode)
+        && (std::sscanf(mode.c_str(), "%dx%d", &modeWidth, &modeHeight) == 2)) {
+      width = modeWidth;
+      height = modeHeight;
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,376 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#include "core_planner.hpp"
+#include "logging.hpp"
+
+
+/**
+ * @brief Cores the process may run on, from its affinity mask.
+ */
+std::vector<int> affinityCores()
+{
+  std::vector<int> cores;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (CPU_ISSET(cpu, &set))
+        cores.push_back(cpu);
+    }
+  }
+  if (cores.empty()) {
+    int numCores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    for (int cpu = 0; cpu < numCores; cpu++)
+      cores.push_back(cpu);
+  }
+  return cores;
+}
+
+
+/**
+ * @brief Number of cores allowed by a quota and period, 0 if unlimited.
+ */
+static int quotaCores(const long &quota, const long &period)
+{
+  if (quota <= 0 || period <= 0)
+    return 0;
+  // Rounded down, a partial core would be throttled
+  return std::max(1L, quota / period);
+}
+
+
+/**
+ * @brief Number of cores allowed by cgroup v2 cpu.max files, from cgroup
+ *        of the process up to the root, 0 if unlimited.
+ */
+static int cgroupV2CpuLimit()
+{
+  std::ifstream cgroupFile("/proc/self/cgroup");
+  std::string line;
+  std::string path;
+  while (std::getline(cgroupFile, line)) {
+    if (line.rfind("0::", 0) == 0)
+      path = line.substr(3);
+  }
+
+  // Path is "/" in a cgroup namespace, e.g. in a container
+  std::string root = CGROUP_V2_ROOT;
+  std::filesystem::path cgroup = root + ((path == "/") ? "" : path);
+  int limit = 0;
+  while (cgroup.string().rfind(root, 0) == 0) {
+    std::ifstream cpuMax(cgroup / "cpu.max");
+    std::string quota;
+    long period = 0;
+    if ((cpuMax >> quota >> period) && (quota != "max")) {
+      int cores = quotaCores(std::stol(quota), period);
+      if (cores > 0)
+        limit = (limit == 0) ? cores : std::min(limit, cores);
+    }
+    if (cgroup.string() == root)
+      break;
+    cgroup = cgroup.parent_path();
+  }
+  return limit;
+}
+
+
+/**
+ * @brief Number of cores allowed by cgroup CPU quota, e.g. of a container,
+ *        0 if unlimited.
+ */
+int cgroupCpuLimit()
+{
+  int limit = cgroupV2CpuLimit();
+  if (limit != 0)
+    return limit;
+
+  std::ifstream quotaFile(CGROUP_V1_CPU_QUOTA);
+  std::ifstream periodFile(CGROUP_V1_CPU_PERIOD);
+  long quota = 0;
+  long period = 0;
+  if ((quotaFile >> quota) && (periodFile >> period))
+    return quotaCores(quota, period);
+  return 0;
+}
+
+
+/**
+ * @brief Cores usable without oversubscription: cores of affinity mask,
+ *        limited to the number of cores of cgroup CPU quota.
+ */
+std::vector<int> usableCores()
+{
+  std::vector<int> cores = affinityCores();
+  int limit = cgroupCpuLimit();
+  if (limit > 0 && limit < static_cast<int>(cores.size()))
+    cores.resize(limit);
+  return cores;
+}
+
+
+/**
+ * @brief Assign cores to roles. Capture and display threads mostly wait
+ *        for hardware (camera, VPU, GPU, display) and share the last core,
+ *        decoders get about a quarter of the remaining cores, inference
+ *        gets the others. With less than 3 cores, all roles but inference
+ *        share a core, and with a single core all roles share it.
+ *
+ * @param cores: usable cores.
+ */
+CorePlan planCores(const std::vector<int> &cores)
+{
+  CorePlan plan;
+  int numCores = cores.size();
+  if (numCores == 0)
+    return plan;
+
+  if (numCores == 1) {
+    plan.capture = plan.inference = plan.decoder = plan.display = cores;
+    return plan;
+  }
+
+  plan.capture = plan.display = {cores.back()};
+  if (numCores == 2) {
+    plan.decoder = plan.display;
+    plan.inference = {cores.front()};
+    return plan;
+  }
+
+  int numDecoder = std::max(1, (numCores - 1) / 4);
+  int numInference = numCores - 1 - numDecoder;
+  plan.inference.assign(cores.begin(), cores.begin() + numInference);
+  plan.decoder.assign(cores.begin() + numInference, cores.end() - 1);
+  return plan;
+}
+
+
+/**
+ * @brief Assign usable cores of the process to roles.
+ */
+CorePlan planCores()
+{
+  return planCores(usableCores());
+}
+
+
+/**
+ * @brief Get cores assigned to a role.
+ */
+const std::vector<int>& roleCores(const CorePlan &plan, const CoreRole &role)
+{
+  switch (role) {
+    case CoreRole::capture:
+      return plan.capture;
+
+    case CoreRole::inference:
+      return plan.inference;
+
+    case CoreRole::decoder:
+      return plan.decoder;
+
+    default:
+      return plan.display;
+  }
+}
+
+
+/**
+ * @brief Number of XNNPACK threads of each model.
+ *
+ * @param plan: cores assignment.
+ * @param numModels: number of models running on CPU at the same time.
+ */
+int inferenceThreads(const CorePlan &plan, const int &numModels)
+{
+  return std::max(1, static_cast<int>(plan.inference.size()) / std::max(1, numModels));
+}
+
+
+/**
+ * @brief Number of XNNPACK threads of each model, for usable cores of the
+ *        process.
+ *
+ * @param numModels: number of models running on CPU at the same time.
+ */
+int defaultInferenceThreads(const int &numModels)
+{
+  return inferenceThreads(planCores(), numModels);
+}
+
+
+/**
+ * @brief Number of decoder worker threads, e.g. OpenMP threads.
+ */
+int decoderThreads(const CorePlan &plan)
+{
+  return std::max(1, static_cast<int>(plan.decoder.size()));
+}
+
+
+/**
+ * @brief Restrict calling thread to cores. Threads it creates afterwards
+ *        inherit the same cores.
+ *
+ * @return false if affinity can't be set.
+ */
+bool pinCurrentThread(const std::vector<int> &cores)
+{
+  if (cores.empty())
+    return false;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cores)
+    CPU_SET(cpu, &set);
+  return (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0);
+}
+
+
+/**
+ * @brief Check if scheduling leaves a thread unchanged.
+ */
+bool isDefaultScheduling(const ThreadScheduling &scheduling)
+{
+  return (scheduling.policy == SchedPolicy::other) && (scheduling.nice == 0)
+         && scheduling.cores.empty();
+}
+
+
+/**
+ * @brief Log once that priority can't be raised, instead of once per thread.
+ */
+static void logSchedulingDenied()
+{
+  static std::once_flag logged;
+  std::call_once(logged, []() {
+    log_info("Not permitted to raise thread priority, threads keep default"
+             " scheduling (needs CAP_SYS_NICE, or RLIMIT_RTPRIO and"
+             " RLIMIT_NICE limits)\n");
+  });
+}
+
+
+/**
+ * @brief Set real-time policy of calling thread. Without CAP_SYS_NICE,
+ *        priority is lowered to RLIMIT_RTPRIO limit when it allows
+ *        real-time scheduling.
+ *
+ * @return false if real-time policy can't be set.
+ */
+static bool setRealTimePolicy(const SchedPolicy &policy, const int &priority)
+{
+  int linuxPolicy = (policy == SchedPolicy::fifo) ? SCHED_FIFO : SCHED_RR;
+  sched_param param = {};
+  param.sched_priority = std::clamp(priority,
+                                    sched_get_priority_min(linuxPolicy),
+                                    sched_get_priority_max(linuxPolicy));
+  int error = pthread_setschedparam(pthread_self(), linuxPolicy, &param);
+  if (error != EPERM)
+    return (error == 0);
+
+  rlimit limit;
+  if ((getrlimit(RLIMIT_RTPRIO, &limit) != 0) || (limit.rlim_cur == 0))
+    return false;
+  if (limit.rlim_cur < static_cast<rlim_t>(param.sched_priority))
+    param.sched_priority = limit.rlim_cur;
+  return (pthread_setschedparam(pthread_self(), linuxPolicy, &param) == 0);
+}
+
+
+/**
+ * @brief Apply scheduling to calling thread: cores, then policy and
+ *        priority. When the process may not raise priority, the thread
+ *        keeps the default policy with its nice value, or its inherited
+ *        nice value when it may not be lowered either.
+ *
+ * @param scheduling: scheduling of calling thread.
+ * @return false if scheduling was only partly applied.
+ */
+bool applyThreadScheduling(const ThreadScheduling &scheduling)
+{
+  bool applied = true;
+  if (!scheduling.cores.empty() && !pinCurrentThread(scheduling.cores)) {
+    log_debug("Can't pin thread\n");
+    applied = false;
+  }
+
+  if (scheduling.policy != SchedPolicy::other) {
+    if (setRealTimePolicy(scheduling.policy, scheduling.priority))
+      return applied;
+    logSchedulingDenied();
+    applied = false;
+  }
+
+  // Linux nice value is per thread, set on thread id
+  pid_t tid = syscall(SYS_gettid);
+  if (scheduling.nice != 0 && setpriority(PRIO_PROCESS, tid, scheduling.nice) != 0) {
+    logSchedulingDenied();
+    applied = false;
+  }
+  return applied;
+}
+
+
+/**
+ * @brief Describe cores of a role, e.g. "0,1".
+ */
+static std::string describeCores(const std::vector<int> &cores)
+{
+  std::string description;
+  for (size_t i = 0; i < cores.size(); i++)
+    description += ((i == 0) ? "" : ",") + std::to_string(cores[i]);
+  return description;
+}
+
+
+/**
+ * @brief Describe a cores assignment, e.g. "capture 3, inference 0,1,
+ *        decoder 2, display 3".
+ */
+std::string describeCorePlan(const CorePlan &plan)
+{
+  return "capture " + describeCores(plan.capture)
+         + ", inference " + describeCores(plan.inference)
+         + ", decoder " + describeCores(plan.decoder)
+         + ", display " + describeCores(plan.display);
+}
+
+
+/**
+ * @brief Describe a thread scheduling, e.g. "fifo 10, cores 3".
+ */
+std::string describeScheduling(const ThreadScheduling &scheduling)
+{
+  std::string description;
+  switch (scheduling.policy) {
+    case SchedPolicy::fifo:
+      description = "fifo " + std::to_string(scheduling.priority);
+      break;
+
+    case SchedPolicy::rr:
+      description = "rr " + std::to_string(scheduling.priority);
+      break;
+
+    default:
+      description = "nice " + std::to_string(scheduling.nice);
+      break;
+  }
+  if (!scheduling.cores.empty())
+    description += ", cores " + describeCores(scheduling.cores);
+  return description;
+}
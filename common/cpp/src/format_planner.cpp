@@ -0,0 +1,265 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <limits>
+#include <map>
+#include <unordered_map>
+
+#include "format_planner.hpp"
+
+// imxvideoconvert elements do not support width and height lower than 16
+#define CONVERTER_DIM_LIMIT   16
+// Bits per pixel assumed for sources of unknown format, as YUY2 cameras
+#define UNKNOWN_FORMAT_BITS   16
+
+
+/**
+ * @brief Output formats of converters on each SoC. SoCs not listed only
+ *        use the CPU for format conversion, imxvideoconvert_g2d and
+ *        imxvideoconvert_pxp still scale and flip on them.
+ */
+const std::map<int, std::vector<ConverterCaps>> socConverterCaps = {
+  {imx::IMX8MP, {
+    {Converter::g2d, {"RGBA", "RGBx", "BGRA", "BGRx", "ARGB", "xRGB",
+                      "ABGR", "xBGR", "RGB16", "BGR16"}},
+    {Converter::ocl, {"RGB", "RGBA", "RGBx", "BGRA", "BGRx", "YUY2", "NV12"}},
+  }},
+  {imx::IMX93, {
+    {Converter::pxp, {"BGR", "BGRA", "BGRx", "RGB16", "UYVY", "GRAY8"}},
+  }},
+  {imx::IMX95, {
+    {Converter::g2d, {"RGB", "RGBA", "RGBx", "BGRA", "BGRx", "ARGB", "xRGB",
+                      "ABGR", "xBGR", "RGB16", "BGR16"}},
+    {Converter::ocl, {"RGB", "RGBA", "RGBx", "BGRA", "BGRx", "YUY2", "NV12"}},
+  }},
+};
+
+
+/**
+ * @brief Bits per pixel of GStreamer video formats.
+ */
+const std::unordered_map<std::string, int> formatBits = {
+  {"RGB", 24}, {"BGR", 24},
+  {"RGBA", 32}, {"RGBx", 32}, {"BGRA", 32}, {"BGRx", 32},
+  {"ARGB", 32}, {"xRGB", 32}, {"ABGR", 32}, {"xBGR", 32},
+  {"RGB16", 16}, {"BGR16", 16},
+  {"YUY2", 16}, {"UYVY", 16}, {"NV12", 12}, {"I420", 12},
+  {"GRAY8", 8},
+};
+
+
+/**
+ * @brief Get output formats of converters available on a SoC.
+ *
+ * @param socId: imx::iMXSocId of the SoC.
+ */
+const std::vector<ConverterCaps>& getConverterCaps(const int &socId)
+{
+  static const std::vector<ConverterCaps> noConverter;
+  auto caps = socConverterCaps.find(socId);
+  return (caps != socConverterCaps.end()) ? caps->second : noConverter;
+}
+
+
+/**
+ * @brief Get bits per pixel of a video format.
+ *
+ * @param format: GStreamer video format, YUY2 size is used if unknown.
+ */
+int formatBitsPerPixel(const std::string &format)
+{
+  auto bits = formatBits.find(format);
+  return (bits != formatBits.end()) ? bits->second : UNKNOWN_FORMAT_BITS;
+}
+
+
+/**
+ * @brief Check if a format can be converted to target format on CPU
+ *        without losing information required by target.
+ *
+ * @param intermediate: format produced by a converter.
+ * @param target: format of the model input.
+ */
+bool isLosslessIntermediate(const std::string &intermediate,
+                            const std::string &target)
+{
+  auto isRGB8 = [](const std::string &format) {
+    return formatBitsPerPixel(format) >= 24
+           && formatBits.find(format) != formatBits.end();
+  };
+  auto isPackedYUV = [](const std::string &format) {
+    return format == "YUY2" || format == "UYVY";
+  };
+
+  if (intermediate == target)
+    return true;
+  if (isRGB8(target))
+    return isRGB8(intermediate);
+  if (target == "GRAY8")
+    return isRGB8(intermediate) || isPackedYUV(intermediate)
+           || intermediate == "NV12" || intermediate == "I420";
+  if (isPackedYUV(target))
+    return isRGB8(intermediate) || isPackedYUV(intermediate);
+  // 16 bits RGB and planar YUV targets lose information from all formats
+  return formatBits.find(intermediate) != formatBits.end();
+}
+
+
+/**
+ * @brief Compute CPU-touched bytes of videoscale, videoconvert and
+ *        videoflip, for the chain without converter.
+ */
+static size_t cpuChainBytes(const std::string &sourceFormat,
+                            const std::string &outputFormat,
+                            const size_t &sourcePixels,
+                            const size_t &outputPixels,
+                            const bool &resize,
+                            const bool &flip)
+{
+  size_t sourceBits = formatBitsPerPixel(sourceFormat);
+  size_t outputBits = formatBitsPerPixel(outputFormat);
+  size_t bits = 0;
+  if (resize)
+    bits += sourcePixels * sourceBits + outputPixels * sourceBits;
+  if (outputFormat != sourceFormat)
+    bits += outputPixels * (sourceBits + outputBits);
+  if (flip)
+    bits += 2 * outputPixels * outputBits;
+  return bits / 8;
+}
+
+
+/**
+ * @brief Plan cheapest conversion chain, in CPU-touched bytes per frame.
+ *        Only SoC tables are used, so plans can be inspected on any host.
+ *
+ * @param socId: imx::iMXSocId of the SoC.
+ * @param request: conversion to plan.
+ */
+ConversionPlan planConversion(const int &socId,
+                              const ConversionRequest &request)
+{
+  std::vector<std::string> sourceFormats = request.sourceFormats;
+  if (sourceFormats.empty())
+    sourceFormats.push_back("");
+  std::vector<std::string> outputFormats = request.outputFormats;
+  if (outputFormats.empty())
+    outputFormats.push_back("");
+
+  bool resize = (request.width > 0 && request.height > 0)
+                && (request.width != request.sourceWidth
+                    || request.height != request.sourceHeight);
+  size_t sourcePixels = (request.sourceWidth > 0 && request.sourceHeight > 0)
+      ? (size_t) request.sourceWidth * request.sourceHeight
+      : (size_t) PLAN_DEFAULT_WIDTH * PLAN_DEFAULT_HEIGHT;
+  size_t outputPixels = (request.width > 0 && request.height > 0)
+      ? (size_t) request.width * request.height
+      : sourcePixels;
+  bool isValidDimensions = (request.width > CONVERTER_DIM_LIMIT || request.width == -1)
+                           && (request.height > CONVERTER_DIM_LIMIT || request.height == -1);
+
+  ConversionPlan best = {};
+  best.cpuBytes = std::numeric_limits<size_t>::max();
+  best.converter = Converter::cpu;
+  auto consider = [&](const ConversionPlan &plan) {
+    if (plan.cpuBytes < best.cpuBytes
+        || (plan.cpuBytes == best.cpuBytes && plan.converter < best.converter))
+      best = plan;
+  };
+
+  for (const std::string &sourceFormat : sourceFormats) {
+    for (const std::string &outputFormat : outputFormats) {
+      ConversionPlan plan = {
+        .sourceFormat  = sourceFormat,
+        .converter     = Converter::cpu,
+        .convertFormat = outputFormat,
+        .outputFormat  = outputFormat,
+        .width         = request.width,
+        .height        = request.height,
+        .flip          = request.flip,
+        .cpuBytes      = cpuChainBytes(sourceFormat,
+                                       outputFormat.empty() ? sourceFormat : outputFormat,
+                                       sourcePixels, outputPixels, resize, request.flip),
+      };
+      consider(plan);
+
+      if (request.useCPU || !isValidDimensions)
+        continue;
+
+      if (outputFormat.empty()) {
+        // Scale or flip only, converters keep input format
+        plan.cpuBytes = 0;
+        if (socId < imx::UNKNOWN && imx::socHasFeature[socId][imx::GPU2D]) {
+          plan.converter = Converter::g2d;
+          consider(plan);
+        } else if (socId == imx::IMX93) {
+          plan.converter = Converter::pxp;
+          consider(plan);
+        }
+        continue;
+      }
+
+      for (const ConverterCaps &caps : getConverterCaps(socId)) {
+        if (caps.converter == Converter::ocl && (!request.allowGpu3d || request.flip))
+          continue;
+
+        plan.converter = caps.converter;
+        for (const std::string &format : caps.formats) {
+          if (!isLosslessIntermediate(format, outputFormat))
+            continue;
+          plan.convertFormat = format;
+          plan.cpuBytes = (format == outputFormat) ? 0
+              : outputPixels * (formatBitsPerPixel(format)
+                                + formatBitsPerPixel(outputFormat)) / 8;
+          consider(plan);
+        }
+      }
+    }
+  }
+  return best;
+}
+
+
+/**
+ * @brief Get GStreamer element name of a converter.
+ *
+ * @param converter: converter of a plan.
+ */
+std::string converterName(const Converter &converter)
+{
+  switch (converter) {
+    case Converter::g2d:
+      return "imxvideoconvert_g2d";
+    case Converter::pxp:
+      return "imxvideoconvert_pxp";
+    case Converter::ocl:
+      return "imxvideoconvert_ocl";
+    default:
+      return "videoscale/videoconvert";
+  }
+}
+
+
+/**
+ * @brief Describe a plan on one line, for logs and inspection.
+ *
+ * @param plan: conversion plan.
+ */
+std::string describePlan(const ConversionPlan &plan)
+{
+  auto formatName = [](const std::string &format) {
+    return format.empty() ? std::string("any") : format;
+  };
+  std::string text = formatName(plan.sourceFormat) + " -> " + converterName(plan.converter);
+  if (plan.flip)
+    text += " (flip)";
+  text += " -> " + formatName(plan.convertFormat);
+  if (plan.width > 0 && plan.height > 0)
+    text += " " + std::to_string(plan.width) + "x" + std::to_string(plan.height);
+  if (plan.convertFormat != plan.outputFormat)
+    text += " -> videoconvert -> " + formatName(plan.outputFormat);
+  text += ", " + std::to_string(plan.cpuBytes) + " CPU bytes per frame";
+  return text;
+}
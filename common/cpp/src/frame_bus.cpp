@@ -0,0 +1,558 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "frame_bus.hpp"
+#include "logging.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Period at which bus threads check for shutdown
+#define FRAME_BUS_POLL_MS   100
+
+
+static size_t alignPage(const size_t &size)
+{
+  size_t page = sysconf(_SC_PAGESIZE);
+  return (size + page - 1) / page * page;
+}
+
+
+static void fillAddress(struct sockaddr_un &address, const std::filesystem::path &path)
+{
+  address = {};
+  address.sun_family = AF_UNIX;
+  if (path.string().size() >= sizeof(address.sun_path)) {
+    log_error("Frame bus socket path too long: %s\n", path.c_str());
+    exit(-1);
+  }
+  strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+}
+
+
+/**
+ * @brief Parameterized constructor, create the shared memory and the socket
+ *        consumers connect to.
+ *
+ * @param options: FrameBusOptions structure.
+ */
+FrameBusPublisher::FrameBusPublisher(const FrameBusOptions &options)
+    : options(options)
+{
+  GstVideoFormat format = gst_video_format_from_string(options.format.c_str());
+  if ((format == GST_VIDEO_FORMAT_UNKNOWN)
+      || (options.format.size() >= FRAME_BUS_FORMAT_SIZE)
+      || (options.numSlots < 2) || (options.numSlots > FRAME_BUS_MAX_SLOTS)) {
+    log_error("Invalid frame bus format %s or number of slots %d\n",
+              options.format.c_str(), options.numSlots);
+    exit(-1);
+  }
+  gst_video_info_set_format(&videoInfo, format, options.width, options.height);
+
+  // Layout is kept by the publisher, consumers can write the shared header
+  dataOffset = alignPage(sizeof(FrameBusHeader));
+  slotStride = alignPage(GST_VIDEO_INFO_SIZE(&videoInfo));
+  mapSize = dataOffset + slotStride * options.numSlots;
+
+  // Size is sealed, consumers can't make publisher fault by truncating it
+  memFd = memfd_create("frame_bus", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+  if ((memFd < 0) || (ftruncate(memFd, mapSize) < 0)
+      || (fcntl(memFd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) < 0)) {
+    log_error("Could not create frame bus memory: %s\n", strerror(errno));
+    exit(-1);
+  }
+  void* memory = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, memFd, 0);
+  if (memory == MAP_FAILED) {
+    log_error("Could not map frame bus memory: %s\n", strerror(errno));
+    exit(-1);
+  }
+  map = static_cast<uint8_t*>(memory);
+
+  header = reinterpret_cast<FrameBusHeader*>(map);
+  header->numSlots = options.numSlots;
+  header->width = options.width;
+  header->height = options.height;
+  header->framerate = options.framerate;
+  header->frameSize = GST_VIDEO_INFO_SIZE(&videoInfo);
+  header->slotStride = slotStride;
+  header->dataOffset = dataOffset;
+  strncpy(header->format, options.format.c_str(), FRAME_BUS_FORMAT_SIZE - 1);
+  header->latest.store(0);
+  for (int i = 0; i < options.numSlots; i++) {
+    header->slots[i].sequence.store(0);
+    header->slots[i].holders.store(0);
+  }
+  header->magic = FRAME_BUS_MAGIC;
+
+  struct sockaddr_un address;
+  fillAddress(address, options.socketPath);
+  unlink(options.socketPath.c_str());
+  listenFd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+  if ((listenFd < 0)
+      || (bind(listenFd, (struct sockaddr *) &address, sizeof(address)) < 0)
+      || (listen(listenFd, FRAME_BUS_MAX_CONSUMERS) < 0)) {
+    log_error("Could not open frame bus socket %s: %s\n",
+              options.socketPath.c_str(), strerror(errno));
+    exit(-1);
+  }
+}
+
+
+FrameBusPublisher::~FrameBusPublisher()
+{
+  running = false;
+  if (serverThread.joinable())
+    serverThread.join();
+
+  for (Client &client : clients)
+    close(client.fd);
+  close(listenFd);
+  unlink(options.socketPath.c_str());
+  munmap(map, mapSize);
+  close(memFd);
+}
+
+
+/**
+ * @brief Create pipeline segment for frame bus, frames are converted to bus
+ *        format and resolution, and given to an appsink.
+ *
+ * @param pipeline: GstPipelineImx pipeline.
+ * @param gstName: name of appsink element.
+ */
+void FrameBusPublisher::addFrameBusToPipeline(GstPipelineImx &pipeline,
+                                              const std::string &gstName)
+{
+  this->gstName = gstName;
+  GstVideoImx videoscale{};
+  videoscale.videoTransform(pipeline, options.format, options.width, options.height, false);
+
+  std::string cmd;
+  cmd = "appsink name=" + gstName;
+  cmd += " emit-signals=true sync=false max-buffers=1 drop=true ";
+  pipeline.addToPipeline(cmd);
+}
+
+
+/**
+ * @brief Connect appsink and start accepting consumers. Pipeline must be parsed.
+ *
+ * @param pipeline: GstPipelineImx pipeline.
+ */
+void FrameBusPublisher::connectFrameBus(GstPipelineImx &pipeline)
+{
+  pipeline.connectToElementSignal(gstName, newSampleCallback, "new-sample", this);
+  running = true;
+  serverThread = std::thread(&FrameBusPublisher::serve, this);
+  log_info("Publishing %dx%d %s frames on %s\n",
+           options.width, options.height, options.format.c_str(), options.socketPath.c_str());
+}
+
+
+/**
+ * @brief Drop references of a consumer which left, slots it held can be
+ *        written again.
+ *
+ * @param client: consumer.
+ */
+void FrameBusPublisher::releaseClient(const Client &client)
+{
+  uint32_t bit = 1u << client.consumer;
+  for (int i = 0; i < options.numSlots; i++)
+    header->slots[i].holders.fetch_and(~bit);
+  usedConsumers &= ~bit;
+  close(client.fd);
+  log_info("Frame bus consumer %u left\n", client.consumer);
+}
+
+
+/**
+ * @brief Accept consumers, give them the shared memory, and release the
+ *        ones whose socket closed, including after a crash.
+ */
+void FrameBusPublisher::serve()
+{
+  std::vector<struct pollfd> fds;
+  while (running) {
+    fds.clear();
+    fds.push_back({listenFd, POLLIN, 0});
+    {
+      std::lock_guard<std::mutex> lock(clientsMutex);
+      for (const Client &client : clients)
+        fds.push_back({client.fd, POLLIN, 0});
+    }
+    if (::poll(fds.data(), fds.size(), FRAME_BUS_POLL_MS) <= 0)
+      continue;
+
+    // Consumers never send data, readable means closed
+    {
+      std::lock_guard<std::mutex> lock(clientsMutex);
+      for (size_t i = 1; i < fds.size(); i++) {
+        if (fds[i].revents == 0)
+          continue;
+        auto it = std::find_if(clients.begin(), clients.end(),
+                               [&](const Client &client) { return client.fd == fds[i].fd; });
+        releaseClient(*it);
+        clients.erase(it);
+      }
+    }
+
+    if ((fds[0].revents & POLLIN) == 0)
+      continue;
+    int fd = accept4(listenFd, NULL, NULL, SOCK_CLOEXEC);
+    if (fd < 0)
+      continue;
+    if (usedConsumers == UINT32_MAX) {
+      log_error("Frame bus has already %d consumers\n", FRAME_BUS_MAX_CONSUMERS);
+      close(fd);
+      continue;
+    }
+    uint32_t consumer = __builtin_ctz(~usedConsumers);
+
+    // Shared memory is given with the hello message
+    FrameBusHello hello = {FRAME_BUS_MAGIC, consumer, mapSize};
+    struct iovec iov = {&hello, sizeof(hello)};
+    char control[CMSG_SPACE(sizeof(int))] = {};
+    struct msghdr message = {};
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(cmsg), &memFd, sizeof(int));
+    if (sendmsg(fd, &message, MSG_NOSIGNAL) < 0) {
+      close(fd);
+      continue;
+    }
+
+    std::lock_guard<std::mutex> lock(clientsMutex);
+    usedConsumers |= 1u << consumer;
+    clients.push_back({fd, consumer});
+    log_info("Frame bus consumer %u connected\n", consumer);
+  }
+}
+
+
+/**
+ * @brief Find a slot neither held by a consumer nor holding latest frame.
+ *        Slot sequence is cleared before holders are checked, so that a
+ *        consumer taking the slot concurrently sees it is being written.
+ *
+ * @return slot index, -1 if all slots are held.
+ */
+int FrameBusPublisher::acquireFreeSlot()
+{
+  uint32_t latestSlot = header->latest.load() & 0xff;
+  bool hasLatest = (header->latest.load() != 0);
+  for (int i = 0; i < options.numSlots; i++) {
+    uint32_t index = (nextSlot + i) % options.numSlots;
+    if (hasLatest && (index == latestSlot))
+      continue;
+
+    FrameBusSlot &slot = header->slots[index];
+    if (slot.holders.load() != 0)
+      continue;
+    slot.sequence.store(0);
+    if (slot.holders.load() != 0)
+      continue;
+    nextSlot = index + 1;
+    return index;
+  }
+  return -1;
+}
+
+
+/**
+ * @brief Copy a frame in a free slot, publish it as latest frame and notify
+ *        consumers. Frame is dropped if consumers hold all slots.
+ */
+GstFlowReturn FrameBusPublisher::newSampleCallback(GstElement* appsink,
+                                                   gpointer user_data)
+{
+  FrameBusPublisher* bus = (FrameBusPublisher *) user_data;
+
+  GstSample* sample;
+  g_signal_emit_by_name(appsink, "pull-sample", &sample);
+  if (!sample) {
+    log_error("Could not retrieve sample\n");
+    return GST_FLOW_ERROR;
+  }
+
+  int index = bus->acquireFreeSlot();
+  if (index < 0) {
+    log_debug("Frame bus slots all held by consumers, frame dropped\n");
+    gst_sample_unref(sample);
+    return GST_FLOW_OK;
+  }
+
+  GstBuffer* buffer = gst_sample_get_buffer(sample);
+  GstVideoInfo info;
+  GstVideoFrame src;
+  GstVideoFrame dst;
+  uint8_t* data = bus->map + bus->dataOffset + index * bus->slotStride;
+  GstBuffer* slotBuffer = gst_buffer_new_wrapped_full(static_cast<GstMemoryFlags>(0),
+                                                      data,
+                                                      GST_VIDEO_INFO_SIZE(&bus->videoInfo),
+                                                      0,
+                                                      GST_VIDEO_INFO_SIZE(&bus->videoInfo),
+                                                      NULL,
+                                                      NULL);
+  if (!gst_video_info_from_caps(&info, gst_sample_get_caps(sample))
+      || !gst_video_frame_map(&src, &info, buffer, GST_MAP_READ)) {
+    log_error("Can't access buffer in memory\n");
+    exit(-1);
+  }
+  // Strides of the source may differ, planes are copied row by row then
+  gst_video_frame_map(&dst, &bus->videoInfo, slotBuffer, GST_MAP_WRITE);
+  gst_video_frame_copy(&dst, &src);
+  gst_video_frame_unmap(&dst);
+  gst_video_frame_unmap(&src);
+  gst_buffer_unref(slotBuffer);
+
+  FrameBusSlot &slot = bus->header->slots[index];
+  slot.pts = GST_BUFFER_PTS(buffer);
+  slot.duration = GST_BUFFER_DURATION(buffer);
+  bus->sequence += 1;
+  slot.sequence.store(bus->sequence, std::memory_order_release);
+  bus->header->latest.store((bus->sequence << 8) | index, std::memory_order_release);
+  gst_sample_unref(sample);
+
+  // Late consumers have full sockets and skip notifications, they take
+  // latest frame anyway
+  std::lock_guard<std::mutex> lock(bus->clientsMutex);
+  for (const Client &client : bus->clients)
+    send(client.fd, &bus->sequence, sizeof(bus->sequence), MSG_DONTWAIT | MSG_NOSIGNAL);
+  return GST_FLOW_OK;
+}
+
+
+/**
+ * @brief Parameterized constructor, connect to a frame bus and map its
+ *        shared memory. Frame data is mapped read-only.
+ *
+ * @param socketPath: socket of the frame bus publisher.
+ */
+GstFrameBusImx::GstFrameBusImx(const std::filesystem::path &socketPath)
+    : GstSourceImx(0, 0, ""), socketPath(socketPath)
+{
+  struct sockaddr_un address;
+  fillAddress(address, socketPath);
+  socketFd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+  if ((socketFd < 0)
+      || (connect(socketFd, (struct sockaddr *) &address, sizeof(address)) < 0)) {
+    log_error("Could not connect to frame bus %s: %s\n", socketPath.c_str(), strerror(errno));
+    exit(-1);
+  }
+
+  FrameBusHello hello = {};
+  struct iovec iov = {&hello, sizeof(hello)};
+  char control[CMSG_SPACE(sizeof(int))] = {};
+  struct msghdr message = {};
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+  int memFd = -1;
+  if (recvmsg(socketFd, &message, MSG_CMSG_CLOEXEC) == sizeof(hello)) {
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+    if ((cmsg != nullptr) && (cmsg->cmsg_type == SCM_RIGHTS))
+      memcpy(&memFd, CMSG_DATA(cmsg), sizeof(int));
+  }
+  if ((memFd < 0) || (hello.magic != FRAME_BUS_MAGIC)) {
+    log_error("Frame bus %s did not send its memory\n", socketPath.c_str());
+    exit(-1);
+  }
+  consumerBit = 1u << hello.consumer;
+
+  // Only slots state is written by consumers
+  headerMapSize = alignPage(sizeof(FrameBusHeader));
+  void* memory = mmap(NULL, headerMapSize, PROT_READ | PROT_WRITE, MAP_SHARED, memFd, 0);
+  if (memory == MAP_FAILED) {
+    log_error("Could not map frame bus memory: %s\n", strerror(errno));
+    exit(-1);
+  }
+  header = static_cast<FrameBusHeader*>(memory);
+  if ((header->dataOffset != headerMapSize) || (header->dataOffset >= hello.mapSize)) {
+    log_error("Frame bus %s has an unexpected layout\n", socketPath.c_str());
+    exit(-1);
+  }
+  dataMapSize = hello.mapSize - header->dataOffset;
+  memory = mmap(NULL, dataMapSize, PROT_READ, MAP_SHARED, memFd, header->dataOffset);
+  close(memFd);
+  if (memory == MAP_FAILED) {
+    log_error("Could not map frame bus memory: %s\n", strerror(errno));
+    exit(-1);
+  }
+  data = static_cast<const uint8_t*>(memory);
+
+  // Layout is copied once checked, header stays writable by other processes
+  numSlots = header->numSlots;
+  slotStride = header->slotStride;
+  frameSize = header->frameSize;
+  if ((numSlots == 0) || (numSlots > FRAME_BUS_MAX_SLOTS)
+      || (frameSize == 0) || (frameSize > dataMapSize)
+      || (slotStride < frameSize)
+      || ((numSlots - 1) > (dataMapSize - frameSize) / slotStride)) {
+    log_error("Frame bus %s has %u slots of %u bytes every %llu bytes, over %zu bytes\n",
+              socketPath.c_str(), numSlots, frameSize,
+              (unsigned long long) slotStride, dataMapSize);
+    exit(-1);
+  }
+
+  this->width = header->width;
+  this->height = header->height;
+  this->format = std::string(header->format, strnlen(header->format, FRAME_BUS_FORMAT_SIZE));
+  this->framerate = header->framerate;
+  for (uint32_t i = 0; i < FRAME_BUS_MAX_SLOTS; i++)
+    releases[i] = {this, i};
+}
+
+
+GstFrameBusImx::~GstFrameBusImx()
+{
+  running = false;
+  if (readerThread.joinable())
+    readerThread.join();
+  if (appsrc != nullptr)
+    gst_object_unref(appsrc);
+
+  // Publisher releases slots still held when socket closes
+  close(socketFd);
+  munmap(const_cast<uint8_t*>(data), dataMapSize);
+  munmap(header, headerMapSize);
+}
+
+
+/**
+ * @brief Create pipeline segment for frame bus, a live appsrc keeping only
+ *        the latest frame.
+ *
+ * @param pipeline: GstPipelineImx pipeline.
+ * @param gstName: name of appsrc element.
+ */
+void GstFrameBusImx::addFrameBusToPipeline(GstPipelineImx &pipeline,
+                                           const std::string &gstName)
+{
+  pipeline.setDisplayResolution(this->width, this->height);
+  this->gstName = gstName;
+
+  std::string caps;
+  caps = "video/x-raw,format=" + format;
+  caps += ",width=" + std::to_string(width) + ",height=" + std::to_string(height);
+  caps += ",framerate=" + std::to_string(framerate) + "/1";
+
+  std::string cmd;
+  cmd = "appsrc name=" + gstName + " is-live=true format=time do-timestamp=true";
+  cmd += " max-buffers=1 leaky-type=" + std::to_string(static_cast<int>(GstQueueLeaky::downstream));
+  cmd += " caps=" + caps + " ! ";
+  pipeline.addToPipeline(cmd);
+}
+
+
+/**
+ * @brief Start pushing frames of the bus. Pipeline must be parsed.
+ *
+ * @param pipeline: GstPipelineImx pipeline.
+ */
+void GstFrameBusImx::connectFrameBus(GstPipelineImx &pipeline)
+{
+  appsrc = pipeline.getElement(gstName);
+  running = true;
+  readerThread = std::thread(&GstFrameBusImx::reader, this);
+}
+
+
+/**
+ * @brief Release a slot once downstream elements dropped its buffer.
+ *
+ * @param user_data: SlotRelease of the slot.
+ */
+void GstFrameBusImx::releaseSlot(gpointer user_data)
+{
+  SlotRelease* release = (SlotRelease *) user_data;
+  release->bus->header->slots[release->slot].holders.fetch_and(~release->bus->consumerBit,
+                                                                std::memory_order_release);
+}
+
+
+/**
+ * @brief Take latest frame of the bus, if newer than last pushed one.
+ *        Slot is held before its sequence is checked, so that publisher
+ *        either sees the hold or the consumer sees the slot is rewritten.
+ *
+ * @return buffer wrapping the frame, nullptr if no new frame.
+ */
+GstBuffer* GstFrameBusImx::acquireLatest()
+{
+  while (true) {
+    uint64_t latest = header->latest.load(std::memory_order_acquire);
+    uint64_t sequence = latest >> 8;
+    uint32_t index = latest & 0xff;
+    if ((sequence == 0) || (sequence == lastSequence) || (index >= numSlots)
+        || (index * slotStride + frameSize > dataMapSize))
+      return nullptr;
+
+    FrameBusSlot &slot = header->slots[index];
+    slot.holders.fetch_or(consumerBit);
+    if (slot.sequence.load() != sequence) {
+      slot.holders.fetch_and(~consumerBit);
+      continue;
+    }
+    lastSequence = sequence;
+
+    const uint8_t* frame = data + index * slotStride;
+    GstBuffer* buffer = gst_buffer_new_wrapped_full(GST_MEMORY_FLAG_READONLY,
+                                                    const_cast<uint8_t*>(frame),
+                                                    frameSize,
+                                                    0,
+                                                    frameSize,
+                                                    &releases[index],
+                                                    releaseSlot);
+    GST_BUFFER_DURATION(buffer) = slot.duration;
+    return buffer;
+  }
+}
+
+
+/**
+ * @brief Wait for bus notifications and push latest frame. Stream ends
+ *        when the publisher stops.
+ */
+void GstFrameBusImx::reader()
+{
+  struct pollfd pfd = {socketFd, POLLIN, 0};
+  while (running) {
+    if (::poll(&pfd, 1, FRAME_BUS_POLL_MS) <= 0)
+      continue;
+
+    // Only latest frame matters, pending notifications are drained
+    uint64_t notification;
+    ssize_t size = 0;
+    while ((size = recv(socketFd, &notification, sizeof(notification), MSG_DONTWAIT)) > 0) {}
+    if ((size == 0) || ((size < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK))) {
+      log_info("Frame bus %s closed\n", socketPath.c_str());
+      GstFlowReturn ret;
+      g_signal_emit_by_name(appsrc, "end-of-stream", &ret);
+      break;
+    }
+
+    GstBuffer* buffer = acquireLatest();
+    if (buffer == nullptr)
+      continue;
+    GstFlowReturn ret;
+    g_signal_emit_by_name(appsrc, "push-buffer", buffer, &ret);
+    gst_buffer_unref(buffer);
+  }
+}
@@ -0,0 +1,269 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "gst_pinned_task_pool.hpp"
+
+#include <map>
+#include <string>
+#include <thread>
+
+#include "logging.hpp"
+
+// Elements followed downstream of a streaming thread owner to get its role
+#define ROLE_MAX_ELEMENTS   32
+
+
+typedef struct {
+  GstTaskPool parent;
+  ThreadScheduling* scheduling;
+} GstPinnedTaskPool;
+
+typedef struct {
+  GstTaskPoolClass parentClass;
+} GstPinnedTaskPoolClass;
+
+G_DEFINE_TYPE(GstPinnedTaskPool, gst_pinned_task_pool, GST_TYPE_TASK_POOL);
+
+#define GST_PINNED_TASK_POOL(obj) (reinterpret_cast<GstPinnedTaskPool*>(obj))
+
+
+/**
+ * @brief Threads are created on push, nothing to prepare.
+ */
+static void gst_pinned_task_pool_prepare(GstTaskPool* pool, GError** error)
+{
+}
+
+
+static void gst_pinned_task_pool_cleanup(GstTaskPool* pool)
+{
+}
+
+
+/**
+ * @brief Run task function in a new thread with pool scheduling.
+ *
+ * @return thread handle, given back to join.
+ */
+static gpointer gst_pinned_task_pool_push(GstTaskPool* pool,
+                                          GstTaskPoolFunction func,
+                                          gpointer user_data,
+                                          GError** error)
+{
+  ThreadScheduling scheduling = *GST_PINNED_TASK_POOL(pool)->scheduling;
+  return new std::thread([scheduling, func, user_data]() {
+    applyThreadScheduling(scheduling);
+    func(user_data);
+  });
+}
+
+
+static void gst_pinned_task_pool_join(GstTaskPool* pool, gpointer id)
+{
+  std::thread* thread = static_cast<std::thread*>(id);
+  thread->join();
+  delete thread;
+}
+
+
+static void gst_pinned_task_pool_finalize(GObject* object)
+{
+  delete GST_PINNED_TASK_POOL(object)->scheduling;
+  G_OBJECT_CLASS(gst_pinned_task_pool_parent_class)->finalize(object);
+}
+
+
+static void gst_pinned_task_pool_class_init(GstPinnedTaskPoolClass* klass)
+{
+  GObjectClass* objectClass = G_OBJECT_CLASS(klass);
+  GstTaskPoolClass* poolClass = GST_TASK_POOL_CLASS(klass);
+
+  objectClass->finalize = gst_pinned_task_pool_finalize;
+  poolClass->prepare = gst_pinned_task_pool_prepare;
+  poolClass->cleanup = gst_pinned_task_pool_cleanup;
+  poolClass->push = gst_pinned_task_pool_push;
+  poolClass->join = gst_pinned_task_pool_join;
+}
+
+
+static void gst_pinned_task_pool_init(GstPinnedTaskPool* self)
+{
+  self->scheduling = new ThreadScheduling();
+}
+
+
+GstTaskPool* createPinnedTaskPool(const ThreadScheduling &scheduling)
+{
+  GstPinnedTaskPool* pool = GST_PINNED_TASK_POOL(
+      g_object_new(gst_pinned_task_pool_get_type(), nullptr));
+  *pool->scheduling = scheduling;
+  return GST_TASK_POOL(pool);
+}
+
+
+/**
+ * @brief Get factory name of an element, e.g. "tensor_filter".
+ */
+static std::string factoryName(GstElement* element)
+{
+  GstElementFactory* factory = gst_element_get_factory(element);
+  return (factory == nullptr) ? "" : GST_OBJECT_NAME(factory);
+}
+
+
+CoreRole streamingThreadRole(GstElement* owner)
+{
+  if (GST_OBJECT_FLAG_IS_SET(owner, GST_ELEMENT_FLAG_SOURCE))
+    return CoreRole::capture;
+
+  // Follow elements with a single src pad up to the next queue
+  CoreRole role = CoreRole::display;
+  GstElement* element = GST_ELEMENT(gst_object_ref(owner));
+  for (int i = 0; i < ROLE_MAX_ELEMENTS; i++) {
+    GstPad* pad = gst_element_get_static_pad(element, "src");
+    gst_object_unref(element);
+    element = nullptr;
+    if (pad == nullptr)
+      break;
+    GstPad* peer = gst_pad_get_peer(pad);
+    gst_object_unref(pad);
+    if (peer == nullptr)
+      break;
+    element = gst_pad_get_parent_element(peer);
+    gst_object_unref(peer);
+    if (element == nullptr)
+      break;
+
+    std::string name = factoryName(element);
+    if (name == "queue" || name == "queue2")
+      break;
+    if (name == "tensor_filter") {
+      role = CoreRole::inference;
+      break;
+    }
+    if (name == "tensor_decoder" || name == "tensor_sink" || name == "appsink")
+      role = CoreRole::decoder;
+  }
+  if (element != nullptr)
+    gst_object_unref(element);
+  return role;
+}
+
+
+/**
+ * @brief Task pools of streaming threads: pools of elements with their own
+ *        scheduling, then pools of roles, nullptr for default scheduling.
+ */
+typedef struct {
+  std::map<std::string, GstTaskPool*> elementPools;
+  GstTaskPool* rolePools[4];
+} PinnedTaskPools;
+
+
+/**
+ * @brief Get name of a role, for logs.
+ */
+static const char* roleName(const CoreRole &role)
+{
+  switch (role) {
+    case CoreRole::capture:
+      return "capture";
+
+    case CoreRole::inference:
+      return "inference";
+
+    case CoreRole::decoder:
+      return "decoder";
+
+    default:
+      return "display";
+  }
+}
+
+
+/**
+ * @brief Bus synchronous handler giving new streaming tasks the pool of
+ *        their element or of their role, before their thread is created.
+ */
+static GstBusSyncReply streamStatusHandler(GstBus* bus,
+                                           GstMessage* message,
+                                           gpointer user_data)
+{
+  if (GST_MESSAGE_TYPE(message) != GST_MESSAGE_STREAM_STATUS)
+    return GST_BUS_PASS;
+
+  GstStreamStatusType type;
+  GstElement* owner;
+  gst_message_parse_stream_status(message, &type, &owner);
+  const GValue* value = gst_message_get_stream_status_object(message);
+  if (type != GST_STREAM_STATUS_TYPE_CREATE || value == nullptr
+      || G_VALUE_TYPE(value) != GST_TYPE_TASK)
+    return GST_BUS_PASS;
+
+  PinnedTaskPools* pinned = static_cast<PinnedTaskPools*>(user_data);
+  GstTask* task = GST_TASK(g_value_get_object(value));
+  auto elementPool = pinned->elementPools.find(GST_OBJECT_NAME(owner));
+  if (elementPool != pinned->elementPools.end()) {
+    gst_task_set_pool(task, elementPool->second);
+    log_debug("%s streaming thread with its own scheduling\n", GST_OBJECT_NAME(owner));
+    return GST_BUS_PASS;
+  }
+
+  CoreRole role = streamingThreadRole(owner);
+  GstTaskPool* rolePool = pinned->rolePools[static_cast<int>(role)];
+  if (rolePool != nullptr) {
+    gst_task_set_pool(task, rolePool);
+    log_debug("%s streaming thread on %s cores\n", GST_OBJECT_NAME(owner), roleName(role));
+  }
+  return GST_BUS_PASS;
+}
+
+
+static void freePinnedTaskPools(gpointer data)
+{
+  PinnedTaskPools* pinned = static_cast<PinnedTaskPools*>(data);
+  for (auto &elementPool : pinned->elementPools)
+    gst_object_unref(elementPool.second);
+  for (GstTaskPool* pool : pinned->rolePools) {
+    if (pool != nullptr)
+      gst_object_unref(pool);
+  }
+  delete pinned;
+}
+
+
+void scheduleStreamingThreads(GstElement* pipeline,
+                              const CorePlan &plan,
+                              const std::map<std::string, ThreadScheduling> &elements)
+{
+  PinnedTaskPools* pinned = new PinnedTaskPools;
+  for (CoreRole role : {CoreRole::capture, CoreRole::inference,
+                        CoreRole::decoder, CoreRole::display}) {
+    ThreadScheduling scheduling;
+    scheduling.cores = roleCores(plan, role);
+    pinned->rolePools[static_cast<int>(role)] = isDefaultScheduling(scheduling)
+        ? nullptr : createPinnedTaskPool(scheduling);
+  }
+
+  for (auto &element : elements) {
+    GstElement* owner = gst_bin_get_by_name(GST_BIN(pipeline), element.first.c_str());
+    if (owner == nullptr) {
+      log_error("Could not get %s\n", element.first.c_str());
+      exit(-1);
+    }
+    // Threads keep cores of their role when their scheduling has none
+    ThreadScheduling scheduling = element.second;
+    if (scheduling.cores.empty())
+      scheduling.cores = roleCores(plan, streamingThreadRole(owner));
+    gst_object_unref(owner);
+    log_info("%s streaming thread: %s\n", element.first.c_str(),
+             describeScheduling(scheduling).c_str());
+    pinned->elementPools[element.first] = createPinnedTaskPool(scheduling);
+  }
+
+  GstBus* bus = gst_element_get_bus(pipeline);
+  gst_bus_set_sync_handler(bus, streamStatusHandler, pinned, freePinnedTaskPools);
+  gst_object_unref(bus);
+}
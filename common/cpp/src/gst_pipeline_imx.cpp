@@ -4,6 +4,8 @@
  */
 
 #include "gst_pipeline_imx.hpp"
+#include "gst_pinned_task_pool.hpp"
+#include "tensor_record.hpp"
 #include <cmath>
 #include <regex>
 
@@ -134,8 +136,10 @@ gboolean GstPipelineImx::infPerfCallback(gpointer user_data)
 
     for (int j = 0; j < namesVector.size(); j++) {
       if (gApp->filterNames.at(i) == namesVector.at(j)) {
-        if (infVector.size() == namesVector.size())
+        if ((infVector.size() == namesVector.size()) && (infVector.at(j) != latency)) {
           infVector.at(j) = latency;
+          perfGeneration += 1;
+        }
       }
     }
   }
@@ -159,6 +163,7 @@ gboolean GstPipelineImx::pipePerfCallback(gpointer user_data)
     std::string message = fps_msg;
 
     std::string fps;
+    float lastFPS = gApp->FPS;
     if (message.find("current:") != std::string::npos) {
       fps = message.substr(message.find("current:") + 9, 5);
       gApp->FPS = std::stof(fps);
@@ -167,6 +172,8 @@ gboolean GstPipelineImx::pipePerfCallback(gpointer user_data)
       fps = message.substr(message.find("fps:") + 5, 5);
       gApp->FPS = std::stof(fps);
     }
+    if (gApp->FPS != lastFPS)
+      perfGeneration += 1;
   }
   return true;
 }
@@ -189,13 +196,75 @@ void GstPipelineImx::parse(char *graphPath)
   log_debug("%s\n\n", strPipeline.c_str());
   gApp.gstPipeline = gst_parse_launch(strPipeline.c_str(), NULL);
 
-  /* bus and message callback */
-  gApp.bus = gst_element_get_bus(gApp.gstPipeline);
-  gst_bus_add_signal_watch(gApp.bus);
-  g_signal_connect(gApp.bus, "message", G_CALLBACK (busCallback), &gApp);
+  /* offline pipelines are run without main loop, see runToCompletion() */
+  if (!offline) {
+    /* bus and message callback */
+    gApp.bus = gst_element_get_bus(gApp.gstPipeline);
+    gst_bus_add_signal_watch(gApp.bus);
+    g_signal_connect(gApp.bus, "message", G_CALLBACK (busCallback), &gApp);
+
+    /* shutdowm pipeline with SIGINT signal */
+    g_unix_signal_add(SIGINT, sigintSignalHandler, &gApp);
+  }
+
+  recordTensorSinks();
+}
+
+
+/**
+ * @brief Run offline pipeline from calling thread until end of stream or
+ *        error, then release it. Several offline pipelines can run at the
+ *        same time from different threads.
+ *
+ * @return true if end of stream was reached.
+ */
+bool GstPipelineImx::runToCompletion()
+{
+  scheduleThreads();
+  gst_element_set_state(gApp.gstPipeline, GST_STATE_PLAYING);
+
+  GstBus* bus = gst_element_get_bus(gApp.gstPipeline);
+  GstMessage* message = gst_bus_timed_pop_filtered(
+      bus,
+      GST_CLOCK_TIME_NONE,
+      static_cast<GstMessageType>(GST_MESSAGE_EOS | GST_MESSAGE_ERROR));
+  bool success = (GST_MESSAGE_TYPE(message) == GST_MESSAGE_EOS);
+  if (!success) {
+    GError *err;
+    gchar *debugInfo;
+    gst_message_parse_error(message, &err, &debugInfo);
+    log_error("Received error from %s: %s\n", GST_OBJECT_NAME(message->src), err->message);
+    g_clear_error(&err);
+    g_free(debugInfo);
+  }
+  gst_message_unref(message);
+  gst_object_unref(bus);
+
+  gst_element_set_state(gApp.gstPipeline, GST_STATE_NULL);
+  gst_object_unref(gApp.gstPipeline);
+  gApp.gstPipeline = NULL;
+  recorders.clear();
+  return success;
+}
+
+
+/**
+ * @brief Record buffers of all tensor_sink elements when TENSOR_RECORD_DIR
+ *        environment variable is set, in <directory>/<tensor_sink name>.tensors.
+ */
+void GstPipelineImx::recordTensorSinks()
+{
+  const char* recordDir = std::getenv("TENSOR_RECORD_DIR");
+  if ((recordDir == nullptr) || (recordDir[0] == '\0'))
+    return;
 
-  /* shutdowm pipeline with SIGINT signal */
-  g_unix_signal_add(SIGINT, sigintSignalHandler, &gApp);
+  for (const std::string &name : tensorSinkNames) {
+    std::string path = std::string(recordDir) + "/" + name + ".tensors";
+    auto recorder = std::make_shared<TensorRecorder>(path);
+    recorder->connectToTensorSink(*this, name);
+    recorders.push_back(recorder);
+    log_info("Recording %s in %s\n", name.c_str(), path.c_str());
+  }
 }
 
 
@@ -217,6 +286,7 @@ void GstPipelineImx::run()
   runCount += 1;
 
   /* start pipeline */
+  scheduleThreads();
   gst_element_set_state(gApp.gstPipeline, GST_STATE_PLAYING);
 
   if (runCount == pipeCount) {
@@ -253,6 +323,9 @@ void GstPipelineImx::freeData()
     gst_object_unref(gApp.gstPipeline);
     gApp.gstPipeline = NULL;
   }
+
+  /* pipeline is stopped, write remaining recorded buffers */
+  recorders.clear();
 }
 
 
@@ -281,17 +354,30 @@ void GstPipelineImx::addQueue(const GstQueueOptions &options)
   std::string cmd;
   std::string cmdName;
   std::string cmdMaxSizeBuffer;
+  std::string cmdMaxSizeTime;
   std::string cmdLeak;
 
-  if (options.queueName.length() != 0)
-    cmdName = " name=" + options.queueName;
+  std::string queueName = options.queueName;
+  // Streaming thread scheduling is found from queue name
+  if (queueName.length() == 0 && !isDefaultScheduling(options.scheduling)) {
+    queueName = "queue_" + std::to_string(elemNameCount);
+    elemNameCount += 1;
+  }
+  if (!isDefaultScheduling(options.scheduling))
+    setThreadScheduling(queueName, options.scheduling);
+
+  if (queueName.length() != 0)
+    cmdName = " name=" + queueName;
   if (options.maxSizeBuffer != -1)
     cmdMaxSizeBuffer = " max-size-buffers="
                        + std::to_string(options.maxSizeBuffer);
-  if (options.leakType != GstQueueLeaky::no)
+  if (options.maxSizeTime != -1)
+    cmdMaxSizeTime = " max-size-time=" + std::to_string(options.maxSizeTime);
+  // Offline pipelines process every frame
+  if ((options.leakType != GstQueueLeaky::no) && !offline)
     cmdLeak = " leaky=" + std::to_string(static_cast<int>(options.leakType));
 
-  cmd = "queue" + cmdName + cmdMaxSizeBuffer + cmdLeak + " ! ";
+  cmd = "queue" + cmdName + cmdMaxSizeBuffer + cmdMaxSizeTime + cmdLeak + " ! ";
 
   addToPipeline(cmd);
 }
@@ -419,15 +505,20 @@ void GstPipelineImx::linkToTextOverlay(const std::string &gstName)
 
 
 /**
- * @brief Add tensor_sink element to retrieve tensors.
+ * @brief Add tensor_sink element to retrieve tensors. QoS and clock
+ *        sync are disabled for offline pipelines.
  * 
  * @param gstName: name of tensor_sink element.
+ * @param qos: drop late buffers.
  */
 void GstPipelineImx::addTensorSink(const std::string &gstName, const bool &qos)
 {
   addToPipeline("tensor_sink name=" + gstName + " ");
-  if (qos == false)
+  tensorSinkNames.push_back(gstName);
+  if ((qos == false) || offline)
     addToPipeline("qos=false ");
+  if (offline)
+    addToPipeline("sync=false ");
 }
 
 
@@ -453,6 +544,54 @@ GstElement* GstPipelineImx::getElement(const std::string &gstName)
 }
 
 
+/**
+ * @brief Pin threads to cores of their role: streaming threads with
+ *        pinned task pools when pipeline starts, and calling thread to
+ *        inference cores, since tensor_filter creates XNNPACK threads from
+ *        the thread starting the pipeline. To call after parse(), before
+ *        run().
+ *
+ * @param plan: cores assignment, e.g. planCores().
+ */
+void GstPipelineImx::pinThreads(const CorePlan &plan)
+{
+  log_info("Cores: %s\n", describeCorePlan(plan).c_str());
+  corePlan = plan;
+  pinned = true;
+  if (!pinCurrentThread(plan.inference))
+    log_debug("Can't pin application thread\n");
+}
+
+
+/**
+ * @brief Set scheduling policy, priority and cores of the streaming thread
+ *        owned by an element, e.g. a camera source or a queue. Queues can
+ *        also be given a scheduling in their options. To call before run().
+ *
+ * @param gstName: name of element owning the streaming thread.
+ * @param scheduling: scheduling of its streaming thread.
+ */
+void GstPipelineImx::setThreadScheduling(const std::string &gstName,
+                                         const ThreadScheduling &scheduling)
+{
+  threadScheduling[gstName] = scheduling;
+}
+
+
+/**
+ * @brief Give streaming threads their scheduling before pipeline starts.
+ */
+void GstPipelineImx::scheduleThreads()
+{
+  if (!pinned && threadScheduling.empty())
+    return;
+  scheduleStreamingThreads(gApp.gstPipeline, corePlan, threadScheduling);
+  // Bus synchronous handler can't be replaced, e.g. when run again
+  pinned = false;
+  threadScheduling.clear();
+}
+
+
 /**
  * @brief Display performances of models inference and pipeline duration.
  * 
@@ -538,11 +677,13 @@ void GstPipelineImx::perfDrawCallback(GstElement* overlay,
   if (infVector.size() != namesVector.size())
     return;
 
-  cairo_select_font_face(cr,
-                         "Arial",
-                         CAIRO_FONT_SLANT_NORMAL,
-                         CAIRO_FONT_WEIGHT_NORMAL);
-  cairo_set_font_size(cr, perfFontSize);
+  // Performances are updated by timers, far less often than frames are drawn
+  cairo_t* layer = perfOverlay.beginRender(cr, perfGeneration);
+  if (layer == nullptr) {
+    perfOverlay.paint(cr);
+    return;
+  }
+  cairo_set_font_size(layer, perfFontSize);
 
   std::string pipeDuration;
   std::string FPS;
@@ -556,7 +697,7 @@ void GstPipelineImx::perfDrawCallback(GstElement* overlay,
       pipeDuration.append(" / ");
   }
 
-  outlineText(cr, 14, width * firstLineSpace, ("Pipeline: " + pipeDuration + FPS), perfColor);
+  outlineText(layer, 14, width * firstLineSpace, ("Pipeline: " + pipeDuration + FPS), perfColor);
 
   std::string inference;
   std::string IPS;
@@ -569,8 +710,9 @@ void GstPipelineImx::perfDrawCallback(GstElement* overlay,
       if (perfType == PerformanceType::all)
         inference.append(" / ");
     }
-    outlineText(cr, 14, width * textSpace + width * lineSpace * i, ("Inference for " + namesVector.at(i) + " : " + inference + IPS), perfColor);
+    outlineText(layer, 14, width * textSpace + width * lineSpace * i, ("Inference for " + namesVector.at(i) + " : " + inference + IPS), perfColor);
   }
+  perfOverlay.paint(cr);
 }
 
 
@@ -0,0 +1,347 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "gst_preprocess_cpu.hpp"
+
+#include <gst/base/gstbasetransform.h>
+#include <gst/video/video.h>
+
+#include "preprocess_kernel.hpp"
+
+
+typedef struct {
+  GstBaseTransform parent;
+  gint width;
+  gint height;
+  gchar* format;
+  gchar* normalization;
+  gboolean letterbox;
+  GstVideoInfo inputInfo;
+  PreprocessKernel* kernel;
+} GstPreprocessCpu;
+
+typedef struct {
+  GstBaseTransformClass parentClass;
+} GstPreprocessCpuClass;
+
+enum {
+  PROP_0,
+  PROP_WIDTH,
+  PROP_HEIGHT,
+  PROP_FORMAT,
+  PROP_NORMALIZATION,
+  PROP_LETTERBOX,
+};
+
+static GstStaticPadTemplate sinkTemplate = GST_STATIC_PAD_TEMPLATE(
+    "sink", GST_PAD_SINK, GST_PAD_ALWAYS,
+    GST_STATIC_CAPS(GST_VIDEO_CAPS_MAKE(PREPROCESS_VIDEO_FORMATS)));
+
+static GstStaticPadTemplate srcTemplate = GST_STATIC_PAD_TEMPLATE(
+    "src", GST_PAD_SRC, GST_PAD_ALWAYS,
+    GST_STATIC_CAPS("other/tensors,format=static,num_tensors=1"));
+
+G_DEFINE_TYPE(GstPreprocessCpu, gst_preprocess_cpu, GST_TYPE_BASE_TRANSFORM);
+
+#define GST_PREPROCESS_CPU(obj) (reinterpret_cast<GstPreprocessCpu*>(obj))
+
+
+/**
+ * @brief Get normalization selected by element property.
+ */
+static Normalization getNormalization(GstPreprocessCpu* self)
+{
+  return selectFromDictionary(std::string(self->normalization), normDictionary);
+}
+
+
+/**
+ * @brief Get size in bytes of output tensor.
+ */
+static size_t getTensorSize(GstPreprocessCpu* self)
+{
+  size_t channels = (g_strcmp0(self->format, "GRAY8") == 0) ? 1 : 3;
+  return channels * self->width * self->height
+         * PreprocessKernel::getTensorTypeSize(getNormalization(self));
+}
+
+
+static void gst_preprocess_cpu_set_property(GObject* object,
+                                            guint propId,
+                                            const GValue* value,
+                                            GParamSpec* pspec)
+{
+  GstPreprocessCpu* self = GST_PREPROCESS_CPU(object);
+  switch (propId) {
+    case PROP_WIDTH:
+      self->width = g_value_get_int(value);
+      break;
+
+    case PROP_HEIGHT:
+      self->height = g_value_get_int(value);
+      break;
+
+    case PROP_FORMAT:
+      if (!PreprocessKernel::isOutputFormatSupported(g_value_get_string(value))) {
+        log_error("%s does not support %s format\n",
+                  PREPROCESS_ELEMENT_NAME, g_value_get_string(value));
+        break;
+      }
+      g_free(self->format);
+      self->format = g_value_dup_string(value);
+      break;
+
+    case PROP_NORMALIZATION:
+      g_free(self->normalization);
+      self->normalization = g_value_dup_string(value);
+      break;
+
+    case PROP_LETTERBOX:
+      self->letterbox = g_value_get_boolean(value);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(object, propId, pspec);
+      break;
+  }
+}
+
+
+static void gst_preprocess_cpu_get_property(GObject* object,
+                                            guint propId,
+                                            GValue* value,
+                                            GParamSpec* pspec)
+{
+  GstPreprocessCpu* self = GST_PREPROCESS_CPU(object);
+  switch (propId) {
+    case PROP_WIDTH:
+      g_value_set_int(value, self->width);
+      break;
+
+    case PROP_HEIGHT:
+      g_value_set_int(value, self->height);
+      break;
+
+    case PROP_FORMAT:
+      g_value_set_string(value, self->format);
+      break;
+
+    case PROP_NORMALIZATION:
+      g_value_set_string(value, self->normalization);
+      break;
+
+    case PROP_LETTERBOX:
+      g_value_set_boolean(value, self->letterbox);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID(object, propId, pspec);
+      break;
+  }
+}
+
+
+static void gst_preprocess_cpu_finalize(GObject* object)
+{
+  GstPreprocessCpu* self = GST_PREPROCESS_CPU(object);
+  delete self->kernel;
+  g_free(self->format);
+  g_free(self->normalization);
+  G_OBJECT_CLASS(gst_preprocess_cpu_parent_class)->finalize(object);
+}
+
+
+/**
+ * @brief Output tensor caps for video caps and video caps for tensor caps,
+ *        framerate is kept.
+ */
+static GstCaps* gst_preprocess_cpu_transform_caps(GstBaseTransform* trans,
+                                                  GstPadDirection direction,
+                                                  GstCaps* caps,
+                                                  GstCaps* filter)
+{
+  GstPreprocessCpu* self = GST_PREPROCESS_CPU(trans);
+  GstCaps* result;
+
+  if (direction == GST_PAD_SINK) {
+    int channels = (g_strcmp0(self->format, "GRAY8") == 0) ? 1 : 3;
+    std::string tensorCaps = "other/tensors,format=static,num_tensors=1,dimensions="
+                             + std::to_string(channels) + ":"
+                             + std::to_string(self->width) + ":"
+                             + std::to_string(self->height) + ":1,types="
+                             + PreprocessKernel::getTensorType(getNormalization(self));
+    result = gst_caps_from_string(tensorCaps.c_str());
+  } else {
+    result = gst_caps_make_writable(gst_static_pad_template_get_caps(&sinkTemplate));
+  }
+
+  if (gst_caps_get_size(caps) > 0) {
+    const GValue* framerate = gst_structure_get_value(gst_caps_get_structure(caps, 0), "framerate");
+    if (framerate != nullptr)
+      gst_structure_set_value(gst_caps_get_structure(result, 0), "framerate", framerate);
+  }
+
+  if (filter != nullptr) {
+    GstCaps* intersection = gst_caps_intersect_full(filter, result, GST_CAPS_INTERSECT_FIRST);
+    gst_caps_unref(result);
+    result = intersection;
+  }
+  return result;
+}
+
+
+/**
+ * @brief Create kernel for negotiated input.
+ */
+static gboolean gst_preprocess_cpu_set_caps(GstBaseTransform* trans,
+                                            GstCaps* incaps,
+                                            GstCaps* outcaps)
+{
+  GstPreprocessCpu* self = GST_PREPROCESS_CPU(trans);
+  if (!gst_video_info_from_caps(&self->inputInfo, incaps)) {
+    log_error("%s can't parse input caps\n", PREPROCESS_ELEMENT_NAME);
+    return FALSE;
+  }
+
+  GstVideoInfo* info = &self->inputInfo;
+  delete self->kernel;
+  self->kernel = new PreprocessKernel(
+      gst_video_format_to_string(GST_VIDEO_INFO_FORMAT(info)),
+      GST_VIDEO_INFO_WIDTH(info),
+      GST_VIDEO_INFO_HEIGHT(info),
+      self->format,
+      self->width,
+      self->height,
+      getNormalization(self),
+      self->letterbox,
+      info->colorimetry.matrix == GST_VIDEO_COLOR_MATRIX_BT709,
+      info->colorimetry.range == GST_VIDEO_COLOR_RANGE_0_255);
+  return TRUE;
+}
+
+
+static gboolean gst_preprocess_cpu_transform_size(GstBaseTransform* trans,
+                                                  GstPadDirection direction,
+                                                  GstCaps* caps,
+                                                  gsize size,
+                                                  GstCaps* othercaps,
+                                                  gsize* othersize)
+{
+  GstPreprocessCpu* self = GST_PREPROCESS_CPU(trans);
+  if (direction == GST_PAD_SINK) {
+    *othersize = getTensorSize(self);
+    return TRUE;
+  }
+
+  GstVideoInfo info;
+  if (!gst_video_info_from_caps(&info, othercaps))
+    return FALSE;
+  *othersize = GST_VIDEO_INFO_SIZE(&info);
+  return TRUE;
+}
+
+
+static GstFlowReturn gst_preprocess_cpu_transform(GstBaseTransform* trans,
+                                                  GstBuffer* inbuf,
+                                                  GstBuffer* outbuf)
+{
+  GstPreprocessCpu* self = GST_PREPROCESS_CPU(trans);
+  if (self->kernel == nullptr)
+    return GST_FLOW_NOT_NEGOTIATED;
+
+  GstVideoFrame frame;
+  if (!gst_video_frame_map(&frame, &self->inputInfo, inbuf, GST_MAP_READ)) {
+    log_error("%s can't map input frame\n", PREPROCESS_ELEMENT_NAME);
+    return GST_FLOW_ERROR;
+  }
+  GstMapInfo output;
+  if (!gst_buffer_map(outbuf, &output, GST_MAP_WRITE)) {
+    gst_video_frame_unmap(&frame);
+    log_error("%s can't map output tensor\n", PREPROCESS_ELEMENT_NAME);
+    return GST_FLOW_ERROR;
+  }
+
+  const uint8_t* planes[PREPROCESS_MAX_PLANES] = {};
+  int strides[PREPROCESS_MAX_PLANES] = {};
+  for (guint p = 0; p < GST_VIDEO_FRAME_N_PLANES(&frame) && p < PREPROCESS_MAX_PLANES; p++) {
+    planes[p] = static_cast<const uint8_t*>(GST_VIDEO_FRAME_PLANE_DATA(&frame, p));
+    strides[p] = GST_VIDEO_FRAME_PLANE_STRIDE(&frame, p);
+  }
+  self->kernel->process(planes, strides, output.data);
+
+  gst_buffer_unmap(outbuf, &output);
+  gst_video_frame_unmap(&frame);
+  return GST_FLOW_OK;
+}
+
+
+static void gst_preprocess_cpu_class_init(GstPreprocessCpuClass* klass)
+{
+  GObjectClass* objectClass = G_OBJECT_CLASS(klass);
+  GstElementClass* elementClass = GST_ELEMENT_CLASS(klass);
+  GstBaseTransformClass* transformClass = GST_BASE_TRANSFORM_CLASS(klass);
+  GParamFlags flags = static_cast<GParamFlags>(G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
+  objectClass->set_property = gst_preprocess_cpu_set_property;
+  objectClass->get_property = gst_preprocess_cpu_get_property;
+  objectClass->finalize = gst_preprocess_cpu_finalize;
+
+  g_object_class_install_property(objectClass, PROP_WIDTH,
+      g_param_spec_int("width", "Width", "Model input width",
+                       1, G_MAXINT, 224, flags));
+  g_object_class_install_property(objectClass, PROP_HEIGHT,
+      g_param_spec_int("height", "Height", "Model input height",
+                       1, G_MAXINT, 224, flags));
+  g_object_class_install_property(objectClass, PROP_FORMAT,
+      g_param_spec_string("format", "Format", "Model input layout (RGB, BGR or GRAY8)",
+                          "RGB", flags));
+  g_object_class_install_property(objectClass, PROP_NORMALIZATION,
+      g_param_spec_string("normalization", "Normalization",
+                          "Model input normalization (none, centered, scaled or centeredScaled)",
+                          "none", flags));
+  g_object_class_install_property(objectClass, PROP_LETTERBOX,
+      g_param_spec_boolean("letterbox", "Letterbox",
+                           "Keep frame aspect ratio, padding it with black",
+                           FALSE, flags));
+
+  gst_element_class_set_static_metadata(elementClass,
+      "CPU preprocessing", "Filter/Converter/Video",
+      "Resize, convert and normalize video frames to a model input tensor in one pass",
+      "NXP");
+  gst_element_class_add_static_pad_template(elementClass, &sinkTemplate);
+  gst_element_class_add_static_pad_template(elementClass, &srcTemplate);
+
+  transformClass->transform_caps = gst_preprocess_cpu_transform_caps;
+  transformClass->set_caps = gst_preprocess_cpu_set_caps;
+  transformClass->transform_size = gst_preprocess_cpu_transform_size;
+  transformClass->transform = gst_preprocess_cpu_transform;
+  transformClass->passthrough_on_same_caps = FALSE;
+}
+
+
+static void gst_preprocess_cpu_init(GstPreprocessCpu* self)
+{
+  self->width = 224;
+  self->height = 224;
+  self->format = g_strdup("RGB");
+  self->normalization = g_strdup("none");
+  self->letterbox = FALSE;
+  self->kernel = nullptr;
+}
+
+
+/**
+ * @brief Register preprocess_cpu element for the application.
+ *
+ * @return true if element is available.
+ */
+bool registerPreprocessElement()
+{
+  static gboolean registered = gst_element_register(nullptr,
+                                                    PREPROCESS_ELEMENT_NAME,
+                                                    GST_RANK_NONE,
+                                                    gst_preprocess_cpu_get_type());
+  return registered == TRUE;
+}
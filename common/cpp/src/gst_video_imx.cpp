@@ -1,39 +1,50 @@
 /**
- * Copyright 2024-2025 NXP
+ * Copyright 2024-2026 NXP
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
-#include <unordered_map>
 #include "gst_video_imx.hpp"
 
 
-using FormatMap = std::unordered_map<std::string, bool>;
-
-
-/** 
- * @brief Array of SoC features.
+/**
+ * @brief Plan accelerated video formatting and csc with the format planner,
+ *        to minimize CPU-touched bytes per frame.
+ *
+ * @param pipeline: GstPipelineImx pipeline.
+ * @param format: GStreamer video format.
+ * @param width: output video width after rescale.
+ * @param height: output video height after rescale.
+ * @param flip: horizontal flip.
+ * @param useCPU: use CPU instead of acceleration.
  */
-std::unordered_map<std::string, FormatMap> isFormatSupported = {
-    {"i.MX 8M Plus", {
-        {"RGB", false}, {"RGB16", true}, {"RGBA", true}, {"ARGB", true}, {"RGBx", true},{"xRGB", true},
-        {"BGR", false}, {"BGR16", true}, {"BGRA", true}, {"ABGR", true}, {"BGRx", true}, {"xBGR", true},
-        {"UYVY", false}, {"YUY2", false}, {"NV12", false}, {"GRAY8", false}
-    }},
-    {"i.MX 93", {
-        {"RGB", false}, {"RGB16", true}, {"RGBA", false}, {"ARGB", false}, {"RGBx", false},{"xRGB", false},
-        {"BGR", true}, {"BGR16", false}, {"BGRA", true}, {"ABGR", false}, {"BGRx", true}, {"xBGR", false},
-        {"UYVY", true}, {"YUY2", false}, {"NV12", false}, {"GRAY8", true}
-    }},
-    {"i.MX 95", {
-        {"RGB", true}, {"RGB16", true}, {"RGBA", true}, {"ARGB", true}, {"RGBx", true},{"xRGB", true},
-        {"BGR", false}, {"BGR16", true}, {"BGRA", true}, {"ABGR", true}, {"BGRx", true}, {"xBGR", true},
-        {"UYVY", false}, {"YUY2", false}, {"NV12", false}, {"GRAY8", false}
-    }}
-};
+ConversionPlan GstVideoImx::planTransform(GstPipelineImx &pipeline,
+                                          const std::string &format,
+                                          const int &width,
+                                          const int &height,
+                                          const bool &flip,
+                                          const bool &useCPU)
+{
+  ConversionRequest request = {
+    .sourceFormats = {},
+    .sourceWidth   = (pipeline.getDisplayWidth() > 0) ? pipeline.getDisplayWidth() : -1,
+    .sourceHeight  = (pipeline.getDisplayHeight() > 0) ? pipeline.getDisplayHeight() : -1,
+    .outputFormats = {},
+    .width         = width,
+    .height        = height,
+    .flip          = flip,
+    .useCPU        = useCPU,
+    .allowGpu3d    = allowGpu3d,
+  };
+  if (!format.empty())
+    request.outputFormats.push_back(format);
+  return planConversion(imx.socId(), request);
+}
 
 
 /**
  * @brief Create pipeline segment for accelerated video formatting and csc.
+ *        Converter and intermediate format are chosen by the format planner,
+ *        to minimize CPU-touched bytes per frame.
  * 
  * @param pipeline: GstPipelineImx pipeline.
  * @param format: GStreamer video format.
@@ -51,58 +62,74 @@ void GstVideoImx::videoTransform(GstPipelineImx &pipeline,
                                  const bool &aspectRatio,
                                  const bool &useCPU)
 {
-  /**
-   * imxvideoconvert_g2d and imxvideoconvert_pxp
-   * do not support width and height lower than 16
-   */
-  std::string cmd;
-  std::string cmdFormat;
-  std::string name;
-  int dimLimit = 16;
-  bool isValidDimensions = (width > dimLimit || width == -1) && (height > dimLimit || height == -1);
-  bool validFormat = true;
-
-  if (!format.empty()) {
-    cmdFormat = ",format=" + format;
-    validFormat = isFormatSupported[imx.socName()][format];
-  }
-
-  if (!isValidDimensions || useCPU || !validFormat)
-    goto cpu_implementation;
+  addPlanToPipeline(pipeline,
+                    planTransform(pipeline, format, width, height, flip, useCPU),
+                    aspectRatio);
+}
 
-  if (this->imx.hasGPU2d()) {
-    name = (flip  ? "name=scale_csc_flip_g2d_" : "name=scale_csc_g2d_") +
-            std::to_string(pipeline.elemNameCount) + " ";
-    cmd = "imxvideoconvert_g2d " + name + (flip ? "rotation=4 ! " : "! ");
-    goto build_caps;
-  }
 
-  if (this->imx.hasPxP()) {
-    name = (flip ? "name=scale_csc_flip_pxp_" : "name=scale_csc_pxp_") +
-            std::to_string(pipeline.elemNameCount) + " ";
-    cmd = "imxvideoconvert_pxp " + name + (flip ? "rotation=4 ! " : "! ");
-    goto build_caps;
+/**
+ * @brief Create pipeline segment of a conversion plan.
+ *
+ * @param pipeline: GstPipelineImx pipeline.
+ * @param plan: conversion plan, from planConversion().
+ * @param aspectRatio: add pixel aspect ratio of 1/1.
+ */
+void GstVideoImx::addPlanToPipeline(GstPipelineImx &pipeline,
+                                    const ConversionPlan &plan,
+                                    const bool &aspectRatio)
+{
+  std::string cmd;
+  std::string name;
+  std::string count = std::to_string(pipeline.elemNameCount);
+  log_debug("format plan %s: %s\n", count.c_str(), describePlan(plan).c_str());
+  plans.push_back(plan);
+
+  switch (plan.converter) {
+    case Converter::g2d:
+      name = (plan.flip ? "name=scale_csc_flip_g2d_" : "name=scale_csc_g2d_") + count + " ";
+      cmd = "imxvideoconvert_g2d " + name + (plan.flip ? "rotation=4 ! " : "! ");
+      break;
+
+    case Converter::pxp:
+      name = (plan.flip ? "name=scale_csc_flip_pxp_" : "name=scale_csc_pxp_") + count + " ";
+      cmd = "imxvideoconvert_pxp " + name + (plan.flip ? "rotation=4 ! " : "! ");
+      break;
+
+    case Converter::ocl:
+      cmd = "imxvideoconvert_ocl name=scale_csc_ocl_" + count + " ! ";
+      break;
+
+    default:
+      cmd = "videoscale name=scale_cpu_" + count + " ! ";
+      cmd += "videoconvert name=csc_cpu_" + count + " ";
+      cmd += (plan.flip ? "! videoflip video-direction=4 ! " : "! ");
+      break;
   }
-
-cpu_implementation:
-  name = "name=scale_cpu_" + std::to_string(pipeline.elemNameCount);
-  cmd = "videoscale " + name + " ! ";
-
-  name = "name=csc_cpu_" + std::to_string(pipeline.elemNameCount);
-  cmd += "videoconvert " + name + " ";
-  cmd += (flip ? "! videoflip video-direction=4 ! " : "! ");
-
-build_caps:
   pipeline.elemNameCount += 1;
 
-  if (width > 0 && height > 0) {
-    cmd += "video/x-raw,width=" + std::to_string(width) + 
-           ",height=" + std::to_string(height) + cmdFormat;
+  std::string cmdFormat;
+  if (!plan.convertFormat.empty())
+    cmdFormat = ",format=" + plan.convertFormat;
+
+  if (plan.width > 0 && plan.height > 0) {
+    cmd += "video/x-raw,width=" + std::to_string(plan.width) + 
+           ",height=" + std::to_string(plan.height) + cmdFormat;
     cmd += (aspectRatio == true) ? ",pixel-aspect-ratio=1/1 ! " : " ! ";
-  } else if (!format.empty()) {
+  } else if (!cmdFormat.empty()) {
       cmd += "video/x-raw" + cmdFormat + " ! ";
   }
 
+  if (plan.convertFormat != plan.outputFormat) {
+    /**
+     * Converter does not support output format,
+     * CPU converts the cheapest supported format
+     */
+    name = "name=csc_convert_cpu_" + std::to_string(pipeline.elemNameCount);
+    pipeline.elemNameCount += 1;
+    cmd += "videoconvert " + name + " ! video/x-raw,format=" + plan.outputFormat + " ! ";
+  }
+
   pipeline.addToPipeline(cmd);
 }
 
@@ -119,40 +146,36 @@ void GstVideoImx::videoscaleToRGB(GstPipelineImx &pipeline,
                                   const int &width,
                                   const int &height)
 {
-  std::string cmd;
-  std::string name;
-  if (this->imx.hasGPU2d()) {
-    if (this->imx.isIMX8()) {
-      /**
-       * imxvideoconvert_g2d does not support RGB sink on i.MX 8 boards
-       * and uses CPU to convert RGBA to RGB
-       */ 
-      videoTransform(pipeline, "RGBA", width, height, false);
-      name = "name=rgb_convert_cpu_" + std::to_string(pipeline.elemNameCount);
-      pipeline.elemNameCount += 1;
-      cmd = "videoconvert ";
-      cmd += name;
-      cmd += " ! video/x-raw,format=RGB ! ";
-    } else {
-      videoTransform(pipeline, "RGB", width, height, false);
-    }
-    pipeline.addToPipeline(cmd);
-  } else if (this->imx.hasPxP()) {
-    /** 
-     * imxvideoconvert_pxp does not support RGB sink
-     * and uses CPU to convert BGR to RGB
-     */
-    videoTransform(pipeline, "BGR", width, height, false);
-    name = "name=rgb_convert_cpu_" + std::to_string(pipeline.elemNameCount);
-    pipeline.elemNameCount += 1;
-    cmd = "videoconvert ";
-    cmd += name;
-    cmd += " ! video/x-raw,format=RGB ! ";
-    pipeline.addToPipeline(cmd);
-  } else {
-    /* no acceleration */
-    videoTransform(pipeline, "RGB", width, height, false);
-  }
+  /**
+   * imxvideoconvert_g2d on i.MX 8 and imxvideoconvert_pxp do not support
+   * RGB sink, planner picks another converter or a CPU conversion
+   */
+  videoTransform(pipeline, "RGB", width, height, false);
+}
+
+
+/**
+ * @brief Create pipeline segment padding a resized frame to model input
+ *        size with black borders, as placed by computeLetterbox().
+ *
+ * @param pipeline: GstPipelineImx pipeline.
+ * @param letterbox: placement of resized frame in model input.
+ */
+void GstVideoImx::videoLetterbox(GstPipelineImx &pipeline,
+                                 const Letterbox &letterbox)
+{
+  int right = letterbox.width - letterbox.scaledWidth - letterbox.left;
+  int bottom = letterbox.height - letterbox.scaledHeight - letterbox.top;
+
+  // Negative borders of videobox add padding
+  std::string cmd = "videobox name=letterbox_" + std::to_string(pipeline.elemNameCount);
+  cmd += " left=" + std::to_string(-letterbox.left);
+  cmd += " right=" + std::to_string(-right);
+  cmd += " top=" + std::to_string(-letterbox.top);
+  cmd += " bottom=" + std::to_string(-bottom);
+  cmd += " fill=black ! ";
+  pipeline.elemNameCount += 1;
+  pipeline.addToPipeline(cmd);
 }
 
 
@@ -4,6 +4,9 @@
  */
 
 #include "gst_video_post_process.hpp"
+#include "gst_video_imx.hpp"
+
+#include <cstdlib>
 
 /** 
  * @brief Dictionary of color in big-endian ARGB.
@@ -17,7 +20,9 @@ std::map<std::string, int> DictionaryColorARGB = {
 
 
 /**
- * @brief Display GStreamer pipeline output.
+ * @brief Display GStreamer pipeline output. Video sink can be replaced
+ *        with VIDEO_SINK environment variable, e.g. "fakesink sync=false"
+ *        to run headless.
  * 
  * @param pipeline: GstPipelineImx pipeline.
  * @param perfType: type of performances to display.
@@ -28,15 +33,17 @@ void GstVideoPostProcess::display(GstPipelineImx &pipeline,
                                   const std::string &color)
 {
   pipeline.enablePerfDisplay(perfType, color);
+  const char* envSink = std::getenv("VIDEO_SINK");
+  std::string videoSink = (envSink != nullptr) ? envSink : "waylandsink";
   std::string cmd;
   if (pipeline.isPerfAvailable() != PerformanceType::none) {
     if (cairoNeeded == true) {
       cmd = "cairooverlay name=perf ! ";
       cairoNeeded = false;
     }
-    cmd += "fpsdisplaysink name=img_tensor text-overlay=false video-sink=waylandsink ";
+    cmd += "fpsdisplaysink name=img_tensor text-overlay=false video-sink=\"" + videoSink + "\" ";
   } else {
-    cmd = "waylandsink ";
+    cmd = videoSink + " ";
   }
 
   pipeline.addToPipeline(cmd);
@@ -179,7 +186,46 @@ void GstVideoPostProcess::addAppSink(GstPipelineImx &pipeline,
 
 
 /**
- * @brief Link video to compositor.
+ * @brief Parameterized constructor.
+ *
+ * @param gstName: compositor element name.
+ * @param layoutOptions: CompositorLayoutOptions structure, setup inputs layout.
+ */
+GstVideoCompositorImx::GstVideoCompositorImx(const std::string &gstName,
+                                             const CompositorLayoutOptions &layoutOptions)
+    : gstName(gstName),
+      displayArea(getDisplayArea(layoutOptions)),
+      layoutEngine(layoutOptions.layout,
+                   layoutOptions.numInputs,
+                   displayArea.width,
+                   displayArea.height)
+{
+}
+
+
+/**
+ * @brief Get compositor output area, from options if set, otherwise from
+ *        connected display, and full HD if no display is found.
+ *
+ * @param layoutOptions: CompositorLayoutOptions structure, setup inputs layout.
+ */
+LayoutTile GstVideoCompositorImx::getDisplayArea(const CompositorLayoutOptions &layoutOptions)
+{
+  LayoutTile area = {0, 0, 1920, 1080};
+  if ((layoutOptions.width > 0) && (layoutOptions.height > 0)) {
+    area.width = layoutOptions.width;
+    area.height = layoutOptions.height;
+  } else if (!CompositorLayoutEngine::readDisplayResolution(area.width, area.height)) {
+    log_info("No connected display found, using %dx%d compositor output\n",
+             area.width, area.height);
+  }
+  return area;
+}
+
+
+/**
+ * @brief Link video to compositor. When possible the video is scaled here,
+ *        directly to its final size, so that compositor only blits it.
  * 
  * @param pipeline: GstPipelineImx pipeline.
  * @param inputParams: structure of parameters for an input video.
@@ -187,9 +233,25 @@ void GstVideoPostProcess::addAppSink(GstPipelineImx &pipeline,
 void GstVideoCompositorImx::addToCompositor(GstPipelineImx &pipeline,
                                             const compositorInputParams &inputParams)
 {
-  pipeline.addToPipeline(this->gstName + ".sink_" + std::to_string(sinkNumber) + " ");
+  int index = this->compositorInputs.size();
+  LayoutTile tile = this->layoutEngine.getTile(index);
+  bool sourceKnown = (inputParams.sourceWidth > 0) && (inputParams.sourceHeight > 0);
+  if ((inputParams.keepRatio == true) && sourceKnown)
+    tile = CompositorLayoutEngine::letterbox(tile,
+                                             inputParams.sourceWidth,
+                                             inputParams.sourceHeight);
+
+  // Without source size, compositor scaling keeps the ratio instead
+  bool scaled = (inputParams.keepRatio == false) || sourceKnown;
+  if (scaled == true) {
+    GstVideoImx videoImx{};
+    videoImx.videoTransform(pipeline, "", tile.width, tile.height, false);
+  }
+
+  pipeline.addToPipeline(this->gstName + ".sink_" + std::to_string(index) + " ");
   this->compositorInputs.push_back(inputParams);
-  sinkNumber += 1;
+  this->compositorTiles.push_back(tile);
+  this->compositorScaled.push_back(scaled);
 }
 
 /**
@@ -214,38 +276,19 @@ void GstVideoCompositorImx::addCompositorToPipeline(GstPipelineImx &pipeline,
 
   for (int i=0; i < this->compositorInputs.size(); i++) {
     compositorInputParams inputParams = compositorInputs.at(i);
+    LayoutTile tile = compositorTiles.at(i);
     std::string stream = "sink_" + std::to_string(i);
     customParams += stream + "::zorder=" + std::to_string(inputParams.order) + " ";
 
     if (inputParams.transparency == true)
       customParams += stream + "::alpha=" + alphaValue + " ";
-  
-    switch (inputParams.position)
-    {
-      case displayPosition::left:
-        customParams += stream + "::xpos=0 ";
-        customParams += stream + "::ypos=0 ";
-        customParams += stream + "::width=960 ";
-        customParams += stream + "::height=720 ";
-        if (inputParams.keepRatio == true)
-          customParams += stream + "::keep-ratio=true ";
-        break;
-
-      case displayPosition::right:
-        customParams += stream + "::xpos=960 ";
-        customParams += stream + "::ypos=0 ";
-        customParams += stream + "::width=960 ";
-        customParams += stream + "::height=720 ";
-        if (inputParams.keepRatio == true)
-          customParams += stream + "::keep-ratio=true ";
-        break;
-
-      case displayPosition::center:
-        break;
-
-      default:
-        break;
-    }
+
+    customParams += stream + "::xpos=" + std::to_string(tile.x) + " ";
+    customParams += stream + "::ypos=" + std::to_string(tile.y) + " ";
+    customParams += stream + "::width=" + std::to_string(tile.width) + " ";
+    customParams += stream + "::height=" + std::to_string(tile.height) + " ";
+    if (compositorScaled.at(i) == false)
+      customParams += stream + "::keep-ratio=true ";
   }
 
   if(this->imx.hasGPU2d())
@@ -261,6 +304,8 @@ void GstVideoCompositorImx::addCompositorToPipeline(GstPipelineImx &pipeline,
     cmd += " ";
   }
 
-  cmd += "! ";
+  cmd += "! video/x-raw,width=" + std::to_string(displayArea.width);
+  cmd += ",height=" + std::to_string(displayArea.height) + " ! ";
   pipeline.addToPipeline(cmd);
+  pipeline.setDisplayResolution(displayArea.width, displayArea.height);
 }
\ No newline at end of file
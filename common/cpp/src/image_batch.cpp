@@ -0,0 +1,336 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "image_batch.hpp"
+#include "core_planner.hpp"
+#include "logging.hpp"
+
+#include <algorithm>
+#include <csetjmp>
+#include <cstdio>
+#include <cstring>
+#include <jpeglib.h>
+
+
+/**
+ * @brief libjpeg error manager, jumping back to decoder instead of exiting.
+ */
+typedef struct {
+  struct jpeg_error_mgr manager;
+  jmp_buf jump;
+} JpegError;
+
+
+static void jpegErrorExit(j_common_ptr cinfo)
+{
+  JpegError* error = reinterpret_cast<JpegError*>(cinfo->err);
+  longjmp(error->jump, 1);
+}
+
+
+/**
+ * @brief Row stride of a RGB video frame, rows are 4 bytes aligned.
+ */
+static int rgbStride(const int &width)
+{
+  return (width * 3 + 3) & ~3;
+}
+
+
+/**
+ * @brief Bilinear resize of a RGB image.
+ *
+ * @param src: source pixels, packed rows.
+ * @param srcWidth: source width.
+ * @param srcHeight: source height.
+ * @param dst: destination pixels.
+ * @param dstWidth: destination width.
+ * @param dstHeight: destination height.
+ * @param dstStride: destination row stride in bytes.
+ */
+static void resizeBilinear(const uint8_t* src,
+                           const int &srcWidth,
+                           const int &srcHeight,
+                           uint8_t* dst,
+                           const int &dstWidth,
+                           const int &dstHeight,
+                           const int &dstStride)
+{
+  if ((srcWidth == dstWidth) && (srcHeight == dstHeight)) {
+    for (int y = 0; y < dstHeight; y++)
+      memcpy(dst + y * dstStride, src + y * srcWidth * 3, dstWidth * 3);
+    return;
+  }
+
+  float scaleX = static_cast<float>(srcWidth) / dstWidth;
+  float scaleY = static_cast<float>(srcHeight) / dstHeight;
+  for (int y = 0; y < dstHeight; y++) {
+    float fy = std::max(0.0f, (y + 0.5f) * scaleY - 0.5f);
+    int y0 = std::min(static_cast<int>(fy), srcHeight - 1);
+    int y1 = std::min(y0 + 1, srcHeight - 1);
+    float wy = fy - y0;
+    const uint8_t* row0 = src + y0 * srcWidth * 3;
+    const uint8_t* row1 = src + y1 * srcWidth * 3;
+    uint8_t* out = dst + y * dstStride;
+
+    for (int x = 0; x < dstWidth; x++) {
+      float fx = std::max(0.0f, (x + 0.5f) * scaleX - 0.5f);
+      int x0 = std::min(static_cast<int>(fx), srcWidth - 1);
+      int x1 = std::min(x0 + 1, srcWidth - 1);
+      float wx = fx - x0;
+      for (int c = 0; c < 3; c++) {
+        float top = row0[x0 * 3 + c] + wx * (row0[x1 * 3 + c] - row0[x0 * 3 + c]);
+        float bottom = row1[x0 * 3 + c] + wx * (row1[x1 * 3 + c] - row1[x0 * 3 + c]);
+        out[x * 3 + c] = static_cast<uint8_t>(top + wy * (bottom - top) + 0.5f);
+      }
+    }
+  }
+}
+
+
+/**
+ * @brief Parameterized constructor, list JPEG images of a directory and
+ *        its subdirectories, in path order.
+ *
+ * @param directory: images directory.
+ * @param width: output width, usually model width.
+ * @param height: output height, usually model height.
+ * @param numWorkers: number of decoding threads, number of usable cores by
+ *                    default.
+ */
+GstImageBatchImx::GstImageBatchImx(const std::filesystem::path &directory,
+                                   const int &width,
+                                   const int &height,
+                                   const int &numWorkers)
+    : GstSourceImx(width, height, "RGB"),
+      numWorkers(numWorkers)
+{
+  std::error_code error;
+  for (const auto &entry : std::filesystem::recursive_directory_iterator(directory, error)) {
+    std::string extension = entry.path().extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    if (entry.is_regular_file() && ((extension == ".jpg") || (extension == ".jpeg")))
+      images.push_back(entry.path());
+  }
+  if (error || images.empty()) {
+    log_error("No JPEG image found in %s\n", directory.c_str());
+    exit(-1);
+  }
+  std::sort(images.begin(), images.end());
+
+  if (this->numWorkers <= 0)
+    this->numWorkers = usableCores().size();
+  slots.resize(this->numWorkers * IMAGE_BATCH_PREFETCH);
+}
+
+
+GstImageBatchImx::~GstImageBatchImx()
+{
+  {
+    std::lock_guard<std::mutex> lock(slotsMutex);
+    running = false;
+  }
+  slotsCondition.notify_all();
+  for (std::thread &thread : workers)
+    thread.join();
+
+  for (Slot &slot : slots) {
+    if (slot.buffer != nullptr)
+      gst_buffer_unref(slot.buffer);
+  }
+}
+
+
+/**
+ * @brief Create pipeline segment for image batch, an appsrc giving RGB
+ *        frames at output resolution.
+ *
+ * @param pipeline: GstPipelineImx pipeline.
+ * @param gstName: name of appsrc element.
+ */
+void GstImageBatchImx::addImageBatchToPipeline(GstPipelineImx &pipeline,
+                                               const std::string &gstName)
+{
+  pipeline.setDisplayResolution(this->width, this->height);
+  this->gstName = gstName;
+
+  std::string cmd;
+  cmd = "appsrc name=" + gstName + " format=time emit-signals=true";
+  cmd += " caps=video/x-raw,format=RGB,width=" + std::to_string(this->width);
+  cmd += ",height=" + std::to_string(this->height);
+  cmd += ",framerate=" + std::to_string(IMAGE_BATCH_FRAMERATE) + "/1 ! ";
+  pipeline.addToPipeline(cmd);
+}
+
+
+/**
+ * @brief Connect appsrc and start decoding threads. Pipeline must be parsed.
+ *
+ * @param pipeline: GstPipelineImx pipeline.
+ */
+void GstImageBatchImx::connectImageBatch(GstPipelineImx &pipeline)
+{
+  pipeline.connectToElementSignal(gstName, needDataCallback, "need-data", this);
+
+  running = true;
+  for (int i = 0; i < numWorkers; i++)
+    workers.emplace_back(&GstImageBatchImx::worker, this);
+  log_info("Decoding %zu images with %d threads\n", images.size(), numWorkers);
+}
+
+
+/**
+ * @brief Get image of a buffer, from its timestamp.
+ *
+ * @param pts: buffer timestamp.
+ */
+const std::filesystem::path& GstImageBatchImx::getImagePath(const GstClockTime &pts) const
+{
+  size_t index = gst_util_uint64_scale_round(pts, IMAGE_BATCH_FRAMERATE, GST_SECOND);
+  return images[std::min(index, images.size() - 1)];
+}
+
+
+/**
+ * @brief Decode a JPEG image to RGB at output resolution. Large images are
+ *        downscaled by the IDCT first, which skips most of the decoding work.
+ *
+ * @param path: image path.
+ * @param rgb: output frame.
+ * @param scratch: decoded image before resize, reused between images.
+ * @return false if image can't be decoded.
+ */
+bool GstImageBatchImx::decode(const std::filesystem::path &path,
+                              uint8_t* rgb,
+                              std::vector<uint8_t> &scratch)
+{
+  FILE* file = fopen(path.c_str(), "rb");
+  if (file == nullptr)
+    return false;
+
+  struct jpeg_decompress_struct cinfo;
+  JpegError error;
+  cinfo.err = jpeg_std_error(&error.manager);
+  error.manager.error_exit = jpegErrorExit;
+  if (setjmp(error.jump)) {
+    jpeg_destroy_decompress(&cinfo);
+    fclose(file);
+    return false;
+  }
+
+  jpeg_create_decompress(&cinfo);
+  jpeg_stdio_src(&cinfo, file);
+  jpeg_read_header(&cinfo, TRUE);
+  cinfo.out_color_space = JCS_RGB;
+  cinfo.dct_method = JDCT_IFAST;
+  cinfo.scale_num = 1;
+  cinfo.scale_denom = 1;
+  for (unsigned int denom = 8; denom > 1; denom /= 2) {
+    if ((cinfo.image_width / denom >= static_cast<unsigned int>(width))
+        && (cinfo.image_height / denom >= static_cast<unsigned int>(height))) {
+      cinfo.scale_denom = denom;
+      break;
+    }
+  }
+
+  jpeg_start_decompress(&cinfo);
+  int srcWidth = cinfo.output_width;
+  int srcHeight = cinfo.output_height;
+  scratch.resize(srcWidth * srcHeight * 3);
+  while (cinfo.output_scanline < cinfo.output_height) {
+    JSAMPROW row = scratch.data() + cinfo.output_scanline * srcWidth * 3;
+    jpeg_read_scanlines(&cinfo, &row, 1);
+  }
+  jpeg_finish_decompress(&cinfo);
+  jpeg_destroy_decompress(&cinfo);
+  fclose(file);
+
+  resizeBilinear(scratch.data(), srcWidth, srcHeight, rgb, width, height, rgbStride(width));
+  return true;
+}
+
+
+/**
+ * @brief Decoding thread, images are taken in order and decoded at most
+ *        a prefetch window ahead of the pushed one.
+ */
+void GstImageBatchImx::worker()
+{
+  std::vector<uint8_t> scratch;
+  gsize size = rgbStride(width) * height;
+  while (true) {
+    size_t index = nextDecode.fetch_add(1);
+    if (index >= images.size())
+      break;
+
+    {
+      std::unique_lock<std::mutex> lock(slotsMutex);
+      slotsCondition.wait(lock, [&] { return (index < nextPush + slots.size()) || !running; });
+      if (!running)
+        break;
+    }
+
+    GstBuffer* buffer = gst_buffer_new_allocate(NULL, size, NULL);
+    GstMapInfo info;
+    gst_buffer_map(buffer, &info, GST_MAP_WRITE);
+    bool decoded = decode(images[index], info.data, scratch);
+    gst_buffer_unmap(buffer, &info);
+    if (decoded) {
+      GST_BUFFER_PTS(buffer) = gst_util_uint64_scale(index, GST_SECOND, IMAGE_BATCH_FRAMERATE);
+      GST_BUFFER_DURATION(buffer) = gst_util_uint64_scale(1, GST_SECOND, IMAGE_BATCH_FRAMERATE);
+    } else {
+      log_error("Could not decode %s, skipped\n", images[index].c_str());
+      gst_buffer_unref(buffer);
+      buffer = nullptr;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(slotsMutex);
+      Slot &slot = slots[index % slots.size()];
+      slot.buffer = buffer;
+      slot.ready = true;
+    }
+    slotsCondition.notify_all();
+  }
+}
+
+
+/**
+ * @brief Push next decoded image when appsrc queue runs low, end the stream
+ *        after last image.
+ *
+ * @param appsrc: appsrc element.
+ * @param length: amount of bytes needed, unused.
+ * @param user_data: GstImageBatchImx.
+ */
+void GstImageBatchImx::needDataCallback(GstElement* appsrc,
+                                        guint length,
+                                        gpointer user_data)
+{
+  GstImageBatchImx* batch = (GstImageBatchImx *) user_data;
+  GstBuffer* buffer = nullptr;
+  {
+    std::unique_lock<std::mutex> lock(batch->slotsMutex);
+    while ((buffer == nullptr) && (batch->nextPush < batch->images.size())) {
+      Slot &slot = batch->slots[batch->nextPush % batch->slots.size()];
+      batch->slotsCondition.wait(lock, [&] { return slot.ready || !batch->running; });
+      if (!batch->running)
+        return;
+      buffer = slot.buffer;
+      slot.buffer = nullptr;
+      slot.ready = false;
+      batch->nextPush += 1;
+    }
+  }
+  batch->slotsCondition.notify_all();
+
+  GstFlowReturn ret;
+  if (buffer == nullptr) {
+    g_signal_emit_by_name(appsrc, "end-of-stream", &ret);
+    return;
+  }
+  g_signal_emit_by_name(appsrc, "push-buffer", buffer, &ret);
+  gst_buffer_unref(buffer);
+}
@@ -0,0 +1,300 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <algorithm>
+#include <chrono>
+
+#include "inference_arbiter.hpp"
+
+
+/**
+ * @brief Monotonic time in nanoseconds.
+ */
+static uint64_t monotonicNs()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+/**
+ * @brief Exponential moving average of durations, first sample is used
+ *        as is.
+ */
+static uint64_t averageNs(const uint64_t &average, const uint64_t &sample)
+{
+  return (average == 0) ? sample : (3 * average + sample) / 4;
+}
+
+
+/**
+ * @brief Register a model, before pipeline is parsed or run.
+ *
+ * @param options: model filter, gate, priority and target rate.
+ * @return model index.
+ */
+int InferenceArbiter::addModel(const ArbiterModelOptions &options)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  ArbitratedModel model = {};
+  model.arbiter = this;
+  model.index = models.size();
+  model.options = options;
+  if (options.targetFps > 0)
+    model.periodNs = (uint64_t) (1e9 / options.targetFps);
+  models.push_back(model);
+  return model.index;
+}
+
+
+/**
+ * @brief Add admission and completion probes to parsed pipeline.
+ *
+ * @param pipeline: GstPipelineImx pipeline, parsed.
+ */
+void InferenceArbiter::attach(GstPipelineImx &pipeline)
+{
+  for (ArbitratedModel &model : models) {
+    GstElement* filter = pipeline.getElement(model.options.filterName);
+    if (filter == nullptr) {
+      log_error("Could not get %s\n", model.options.filterName.c_str());
+      exit(-1);
+    }
+
+    GstPad* gatePad;
+    if (model.options.gateName.empty()) {
+      gatePad = gst_element_get_static_pad(filter, "sink");
+    } else {
+      GstElement* gate = pipeline.getElement(model.options.gateName);
+      if (gate == nullptr) {
+        log_error("Could not get %s\n", model.options.gateName.c_str());
+        exit(-1);
+      }
+      gatePad = gst_element_get_static_pad(gate, "src");
+      gst_object_unref(gate);
+    }
+    GstPad* donePad = gst_element_get_static_pad(filter, "src");
+    gst_object_unref(filter);
+    if ((gatePad == nullptr) || (donePad == nullptr)) {
+      log_error("Could not get pads of %s\n", model.options.filterName.c_str());
+      exit(-1);
+    }
+
+    gst_pad_add_probe(gatePad, GST_PAD_PROBE_TYPE_BUFFER, gateProbe, &model, nullptr);
+    gst_pad_add_probe(donePad, GST_PAD_PROBE_TYPE_BUFFER, doneProbe, &model, nullptr);
+    gst_object_unref(gatePad);
+    gst_object_unref(donePad);
+  }
+}
+
+
+/**
+ * @brief Decide admission of a frame, mutex held.
+ *
+ * @param model: model receiving the frame.
+ * @param nowNs: monotonic time of decision.
+ * @param newFrame: first decision for this frame.
+ */
+ArbiterDecision InferenceArbiter::decide(ArbitratedModel &model,
+                                         const uint64_t &nowNs,
+                                         const bool &newFrame)
+{
+  if (newFrame) {
+    if (model.lastArrivalNs != 0)
+      model.arrivalIntervalNs = averageNs(model.arrivalIntervalNs, nowNs - model.lastArrivalNs);
+    model.lastArrivalNs = nowNs;
+  }
+
+  ArbiterDecision decision = ArbiterDecision::admit;
+  if ((model.periodNs > 0) && (nowNs < model.nextDueNs))
+    decision = ArbiterDecision::drop;
+
+  for (const ArbitratedModel &other : models) {
+    if ((decision == ArbiterDecision::drop)
+        || (other.options.priority <= model.options.priority))
+      continue;
+
+    if (other.inFlight && (nowNs - other.admittedAtNs < ARBITER_INFLIGHT_TIMEOUT_NS)) {
+      decision = ArbiterDecision::wait;
+      continue;
+    }
+
+    // Inference must end before next frame of higher priority model
+    if (other.arrivalIntervalNs == 0)
+      continue;
+    uint64_t nextNeedNs = std::max(other.lastArrivalNs + other.arrivalIntervalNs,
+                                   other.nextDueNs);
+    bool stalled = (nowNs > nextNeedNs + other.arrivalIntervalNs);
+    if (!stalled && (nowNs + model.latencyNs > nextNeedNs)) {
+      // Estimate of a model starved for a while decays, so that an
+      // outlier latency can not starve it forever
+      if (nowNs - model.admittedAtNs > ARBITER_RATE_WINDOW_NS)
+        model.latencyNs -= model.latencyNs / 16;
+      decision = ArbiterDecision::drop;
+    }
+  }
+
+  if (decision == ArbiterDecision::admit) {
+    model.inFlight = true;
+    model.admittedAtNs = nowNs;
+    model.admitted += 1;
+    if (model.periodNs > 0) {
+      // Frames late on schedule only catch up half a period
+      uint64_t earliest = (nowNs > model.periodNs / 2) ? nowNs - model.periodNs / 2 : 0;
+      model.nextDueNs = std::max(model.nextDueNs, earliest) + model.periodNs;
+    }
+  } else if (decision == ArbiterDecision::drop) {
+    model.dropped += 1;
+  }
+  return decision;
+}
+
+
+/**
+ * @brief Decide admission of a frame, without waiting.
+ *
+ * @param model: model index.
+ * @param nowNs: monotonic time of decision.
+ * @param newFrame: first decision for this frame.
+ */
+ArbiterDecision InferenceArbiter::admit(const int &model,
+                                        const uint64_t &nowNs,
+                                        const bool &newFrame)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return decide(models.at(model), nowNs, newFrame);
+}
+
+
+/**
+ * @brief Record end of an inference.
+ *
+ * @param model: model index.
+ * @param nowNs: monotonic time of inference output.
+ */
+void InferenceArbiter::complete(const int &model, const uint64_t &nowNs)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    ArbitratedModel &arbitrated = models.at(model);
+    if (arbitrated.inFlight)
+      arbitrated.latencyNs = averageNs(arbitrated.latencyNs, nowNs - arbitrated.admittedAtNs);
+    arbitrated.inFlight = false;
+
+    if (arbitrated.windowStartNs == 0)
+      arbitrated.windowStartNs = nowNs;
+    arbitrated.windowCount += 1;
+    if (nowNs - arbitrated.windowStartNs >= ARBITER_RATE_WINDOW_NS) {
+      arbitrated.achievedFps = arbitrated.windowCount * 1e9 / (nowNs - arbitrated.windowStartNs);
+      arbitrated.windowStartNs = nowNs;
+      arbitrated.windowCount = 0;
+    }
+  }
+  done.notify_all();
+}
+
+
+/**
+ * @brief Admission probe: drop frame, or let it reach tensor_filter, once
+ *        higher priority inferences it waits for are done.
+ */
+GstPadProbeReturn InferenceArbiter::gateProbe(GstPad* pad,
+                                              GstPadProbeInfo* info,
+                                              gpointer user_data)
+{
+  ArbitratedModel* model = static_cast<ArbitratedModel*>(user_data);
+  InferenceArbiter* arbiter = model->arbiter;
+
+  std::unique_lock<std::mutex> lock(arbiter->mutex);
+  ArbiterDecision decision = arbiter->decide(*model, monotonicNs(), true);
+  while (decision == ArbiterDecision::wait) {
+    arbiter->done.wait_for(lock, std::chrono::nanoseconds(ARBITER_INFLIGHT_TIMEOUT_NS));
+    decision = arbiter->decide(*model, monotonicNs(), false);
+  }
+  return (decision == ArbiterDecision::admit) ? GST_PAD_PROBE_OK : GST_PAD_PROBE_DROP;
+}
+
+
+/**
+ * @brief Completion probe on tensor_filter output.
+ */
+GstPadProbeReturn InferenceArbiter::doneProbe(GstPad* pad,
+                                              GstPadProbeInfo* info,
+                                              gpointer user_data)
+{
+  ArbitratedModel* model = static_cast<ArbitratedModel*>(user_data);
+  model->arbiter->complete(model->index, monotonicNs());
+  return GST_PAD_PROBE_OK;
+}
+
+
+/**
+ * @brief Get admission statistics and achieved rate of each model.
+ */
+std::vector<ArbiterModelStats> InferenceArbiter::getStats()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  uint64_t nowNs = monotonicNs();
+  std::vector<ArbiterModelStats> stats;
+  for (ArbitratedModel &model : models) {
+    // Rate of a model without recent output decreases
+    if ((model.windowStartNs != 0) && (nowNs - model.windowStartNs >= 2 * ARBITER_RATE_WINDOW_NS))
+      model.achievedFps = model.windowCount * 1e9 / (nowNs - model.windowStartNs);
+
+    stats.push_back({
+      .filterName  = model.options.filterName,
+      .priority    = model.options.priority,
+      .targetFps   = model.options.targetFps,
+      .achievedFps = model.achievedFps,
+      .latencyMs   = model.latencyNs / 1e6f,
+      .admitted    = model.admitted,
+      .dropped     = model.dropped,
+    });
+  }
+  return stats;
+}
+
+
+/**
+ * @brief Log admission statistics and achieved rate of each model.
+ */
+void InferenceArbiter::logStats()
+{
+  for (const ArbiterModelStats &stats : getStats()) {
+    log_info("%s: priority %d, target %.1f fps, achieved %.1f fps, latency %.1f ms, "
+             "%llu frames admitted, %llu dropped\n",
+             stats.filterName.c_str(), stats.priority, stats.targetFps,
+             stats.achievedFps, stats.latencyMs,
+             (unsigned long long) stats.admitted, (unsigned long long) stats.dropped);
+  }
+}
+
+
+/**
+ * @brief Log statistics periodically from main loop while pipeline runs.
+ *
+ * @param periodSeconds: logging period in seconds.
+ */
+void InferenceArbiter::logStatsPeriodically(const guint &periodSeconds)
+{
+  if (statsSource != 0)
+    g_source_remove(statsSource);
+  statsSource = g_timeout_add_seconds(periodSeconds, statsCallback, this);
+}
+
+
+gboolean InferenceArbiter::statsCallback(gpointer user_data)
+{
+  InferenceArbiter* arbiter = static_cast<InferenceArbiter*>(user_data);
+  arbiter->logStats();
+  return true;
+}
+
+
+InferenceArbiter::~InferenceArbiter()
+{
+  if (statsSource != 0)
+    g_source_remove(statsSource);
+}
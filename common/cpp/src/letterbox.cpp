@@ -0,0 +1,116 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "letterbox.hpp"
+
+
+/**
+ * @brief Compute placement of a source frame in model input. Letterbox of
+ *        an already letterboxed frame keeps the same placement, so frames
+ *        can be resized by an accelerator and padded afterwards.
+ *
+ * @param sourceWidth: source frame width.
+ * @param sourceHeight: source frame height.
+ * @param width: model input width.
+ * @param height: model input height.
+ * @param keepAspectRatio: pad frame to keep its aspect ratio, otherwise
+ *                         frame is stretched.
+ */
+Letterbox computeLetterbox(const int &sourceWidth,
+                           const int &sourceHeight,
+                           const int &width,
+                           const int &height,
+                           const bool &keepAspectRatio)
+{
+  Letterbox letterbox = {sourceWidth, sourceHeight, width, height, width, height, 0, 0};
+  if (!keepAspectRatio || (sourceWidth <= 0) || (sourceHeight <= 0))
+    return letterbox;
+
+  if ((long) sourceWidth * height >= (long) sourceHeight * width) {
+    // Wider than model input, pad top and bottom
+    letterbox.scaledHeight = (int) std::lround((double) sourceHeight * width / sourceWidth);
+    letterbox.scaledHeight = std::clamp(letterbox.scaledHeight, 1, height);
+  } else {
+    // Taller than model input, pad left and right
+    letterbox.scaledWidth = (int) std::lround((double) sourceWidth * height / sourceHeight);
+    letterbox.scaledWidth = std::clamp(letterbox.scaledWidth, 1, width);
+  }
+  letterbox.left = (width - letterbox.scaledWidth) / 2;
+  letterbox.top = (height - letterbox.scaledHeight) / 2;
+  return letterbox;
+}
+
+
+/**
+ * @brief Check if model input is padded.
+ */
+bool isLetterboxed(const Letterbox &letterbox)
+{
+  return (letterbox.scaledWidth != letterbox.width)
+         || (letterbox.scaledHeight != letterbox.height);
+}
+
+
+/**
+ * @brief Map a model output abscissa, normalized to model input width,
+ *        to source frame pixels.
+ *
+ * @param letterbox: placement of source frame in model input.
+ * @param x: abscissa in [0, 1] of model input.
+ */
+float letterboxToSourceX(const Letterbox &letterbox, const float &x)
+{
+  return (x * letterbox.width - letterbox.left)
+         * letterbox.sourceWidth / letterbox.scaledWidth;
+}
+
+
+/**
+ * @brief Map a model output ordinate, normalized to model input height,
+ *        to source frame pixels.
+ *
+ * @param letterbox: placement of source frame in model input.
+ * @param y: ordinate in [0, 1] of model input.
+ */
+float letterboxToSourceY(const Letterbox &letterbox, const float &y)
+{
+  return (y * letterbox.height - letterbox.top)
+         * letterbox.sourceHeight / letterbox.scaledHeight;
+}
+
+
+/**
+ * @brief Map a model output abscissa, normalized to model input width,
+ *        to an abscissa normalized to frame width. Unchanged when model
+ *        input is not padded, e.g. for decoders scaling to another frame.
+ *
+ * @param letterbox: placement of source frame in model input.
+ * @param x: abscissa in [0, 1] of model input.
+ */
+float letterboxToFrameX(const Letterbox &letterbox, const float &x)
+{
+  if (!isLetterboxed(letterbox))
+    return x;
+  return (x * letterbox.width - letterbox.left) / letterbox.scaledWidth;
+}
+
+
+/**
+ * @brief Map a model output ordinate, normalized to model input height,
+ *        to an ordinate normalized to frame height. Unchanged when model
+ *        input is not padded.
+ *
+ * @param letterbox: placement of source frame in model input.
+ * @param y: ordinate in [0, 1] of model input.
+ */
+float letterboxToFrameY(const Letterbox &letterbox, const float &y)
+{
+  if (!isLetterboxed(letterbox))
+    return y;
+  return (y * letterbox.height - letterbox.top) / letterbox.scaledHeight;
+}
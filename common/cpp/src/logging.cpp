@@ -0,0 +1,332 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "logging.hpp"
+
+#include <chrono>
+#include <cstdarg>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#define LOG_RING_SIZE         128
+#define LOG_MESSAGE_SIZE      1024
+#define LOG_DRAIN_PERIOD_MS   10
+// Maximum number of identical messages of a call site in a rate limiting window
+#define LOG_RATE_LIMIT        10
+#define LOG_RATE_WINDOW_NS    1000000000ULL
+
+// Set when the logger is destroyed at exit, while other threads may still log
+static std::atomic<bool> loggerDestroyed{false};
+
+
+/**
+ * @brief Slot of the ring buffer, its sequence tells if it is free or
+ *        holds a message. Messages longer than the slot are allocated.
+ */
+typedef struct {
+  std::atomic<size_t> sequence;
+  int level;
+  uint32_t suppressed;
+  char* longText;
+  char text[LOG_MESSAGE_SIZE];
+} LogMessage;
+
+
+/**
+ * @brief Bounded ring buffer with lock-free producers, drained by a
+ *        background thread.
+ */
+class AsyncLogger {
+  private:
+    LogMessage ring[LOG_RING_SIZE];
+    std::atomic<size_t> enqueuePos{0};
+    size_t dequeuePos = 0;
+    std::atomic<uint32_t> dropped{0};
+    std::mutex drainMutex;
+    std::atomic<bool> running{true};
+    std::thread worker;
+
+    void run();
+
+  public:
+    AsyncLogger();
+
+    ~AsyncLogger();
+
+    LogMessage* reserve();
+
+    void commit(LogMessage* message);
+
+    void drop() { dropped.fetch_add(1, std::memory_order_relaxed); }
+
+    void drain();
+};
+
+
+AsyncLogger::AsyncLogger()
+{
+  for (size_t i = 0; i < LOG_RING_SIZE; i++) {
+    ring[i].sequence.store(i, std::memory_order_relaxed);
+    ring[i].longText = nullptr;
+  }
+  worker = std::thread(&AsyncLogger::run, this);
+}
+
+
+AsyncLogger::~AsyncLogger()
+{
+  loggerDestroyed = true;
+  running = false;
+  if (worker.joinable())
+    worker.join();
+  drain();
+}
+
+
+/**
+ * @brief Reserve a free slot, producer side.
+ *
+ * @return reserved slot, or nullptr if ring buffer is full.
+ */
+LogMessage* AsyncLogger::reserve()
+{
+  size_t pos = enqueuePos.load(std::memory_order_relaxed);
+  while (true) {
+    LogMessage* message = &ring[pos % LOG_RING_SIZE];
+    size_t sequence = message->sequence.load(std::memory_order_acquire);
+    intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+    if (diff == 0) {
+      if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        return message;
+    } else if (diff < 0) {
+      return nullptr;
+    } else {
+      pos = enqueuePos.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+
+/**
+ * @brief Make a filled slot available to the background thread.
+ */
+void AsyncLogger::commit(LogMessage* message)
+{
+  size_t pos = message->sequence.load(std::memory_order_relaxed);
+  message->sequence.store(pos + 1, std::memory_order_release);
+}
+
+
+/**
+ * @brief Write all pending messages to stdout.
+ */
+void AsyncLogger::drain()
+{
+  std::lock_guard<std::mutex> lock(drainMutex);
+  bool written = false;
+  while (true) {
+    LogMessage* message = &ring[dequeuePos % LOG_RING_SIZE];
+    size_t sequence = message->sequence.load(std::memory_order_acquire);
+    if (sequence != dequeuePos + 1)
+      break;
+
+    if (message->level == LOG_LEVEL_DEBUG)
+      fputs("\n\033[1;33mDEBUG:\033[0m ", stdout);
+    else
+      fputs("\n\033[1;32mINFO:\033[0m ", stdout);
+    if (message->longText != nullptr) {
+      fputs(message->longText, stdout);
+      delete[] message->longText;
+      message->longText = nullptr;
+    } else {
+      fputs(message->text, stdout);
+    }
+    if (message->suppressed > 0)
+      printf("(%u identical messages suppressed)\n", message->suppressed);
+
+    message->sequence.store(dequeuePos + LOG_RING_SIZE, std::memory_order_release);
+    dequeuePos += 1;
+    written = true;
+  }
+
+  uint32_t numDropped = dropped.exchange(0, std::memory_order_relaxed);
+  if (numDropped > 0) {
+    printf("\n\033[1;31mERROR:\033[0m %u log messages dropped\n", numDropped);
+    written = true;
+  }
+  if (written)
+    fflush(stdout);
+}
+
+
+/**
+ * @brief Background thread draining ring buffer periodically.
+ */
+void AsyncLogger::run()
+{
+  while (running) {
+    drain();
+    std::this_thread::sleep_for(std::chrono::milliseconds(LOG_DRAIN_PERIOD_MS));
+  }
+}
+
+
+/**
+ * @brief Get runtime level from LOG_LEVEL environment variable, read once.
+ *        Kept out of the logger, so that errors do not need it.
+ */
+static int getLevel()
+{
+  static const int level = []() {
+    const char* env = std::getenv("LOG_LEVEL");
+    std::string value = (env != nullptr) ? env : "";
+    if (value == "debug")
+      return LOG_LEVEL_DEBUG;
+    if (value == "error")
+      return LOG_LEVEL_ERROR;
+    if (value == "none")
+      return LOG_LEVEL_NONE;
+    return LOG_LEVEL_INFO;
+  }();
+  return level;
+}
+
+
+/**
+ * @brief Get logger, started on first use and flushed at exit.
+ */
+static AsyncLogger& getLogger()
+{
+  static AsyncLogger asyncLogger;
+  return asyncLogger;
+}
+
+
+/**
+ * @brief Hash of a formatted message (64 bits FNV-1a).
+ */
+static uint64_t messageHash(const char* text, const size_t &length)
+{
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (size_t i = 0; i < length; i++) {
+    hash ^= (unsigned char) text[i];
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+
+/**
+ * @brief Check if a message repeats the last message of its call site
+ *        more than rate limit allows. Different messages of a call site,
+ *        e.g. results, are not limited.
+ *
+ * @param site: call site state.
+ * @param hash: hash of formatted message.
+ * @return true if message has to be dropped.
+ */
+static bool rateLimited(LogSite &site, const uint64_t &hash)
+{
+  uint64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  if (site.lastHash.exchange(hash, std::memory_order_relaxed) != hash) {
+    site.windowStart.store(now, std::memory_order_relaxed);
+    site.count.store(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  uint64_t start = site.windowStart.load(std::memory_order_relaxed);
+  if ((now - start >= LOG_RATE_WINDOW_NS)
+      && site.windowStart.compare_exchange_strong(start, now, std::memory_order_relaxed))
+    site.count.store(0, std::memory_order_relaxed);
+
+  if (site.count.fetch_add(1, std::memory_order_relaxed) >= LOG_RATE_LIMIT) {
+    site.suppressed.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+  return false;
+}
+
+
+namespace logger {
+
+/**
+ * @brief Queue a message for the background thread, or write an error
+ *        from the calling thread.
+ *
+ * @param level: message level.
+ * @param site: call site state, for rate limiting.
+ * @param format: printf format.
+ */
+void log(const int &level, LogSite &site, const char* format, ...)
+{
+  if (level < getLevel())
+    return;
+
+  // Formatted on the stack first, to compare it with previous message
+  char text[LOG_MESSAGE_SIZE];
+  char* longText = nullptr;
+  va_list args;
+  va_start(args, format);
+  va_list longArgs;
+  va_copy(longArgs, args);
+  int length = vsnprintf(text, LOG_MESSAGE_SIZE, format, args);
+  va_end(args);
+  if (length >= LOG_MESSAGE_SIZE) {
+    longText = new char[length + 1];
+    vsnprintf(longText, length + 1, format, longArgs);
+  }
+  va_end(longArgs);
+  if (length < 0)
+    length = 0;
+
+  // Errors are written at once in a single call, even while exiting
+  if (level >= LOG_LEVEL_ERROR) {
+    fprintf(stderr, "\n\033[1;31mERROR:\033[0m %s", (longText != nullptr) ? longText : text);
+    delete[] longText;
+    return;
+  }
+
+  // Logger may already be destroyed by exit() called from another thread
+  if (loggerDestroyed) {
+    delete[] longText;
+    return;
+  }
+
+  if (rateLimited(site, messageHash((longText != nullptr) ? longText : text, length))) {
+    delete[] longText;
+    return;
+  }
+
+  AsyncLogger &asyncLogger = getLogger();
+  LogMessage* message = asyncLogger.reserve();
+  if (message == nullptr) {
+    delete[] longText;
+    asyncLogger.drop();
+    return;
+  }
+
+  if (longText != nullptr)
+    message->longText = longText;
+  else
+    memcpy(message->text, text, length + 1);
+  message->level = level;
+  message->suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+  asyncLogger.commit(message);
+}
+
+
+/**
+ * @brief Write pending messages from the calling thread.
+ */
+void flush()
+{
+  if (!loggerDestroyed)
+    getLogger().drain();
+}
+
+}
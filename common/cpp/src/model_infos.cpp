@@ -1,9 +1,12 @@
 /**
- * Copyright 2024-2025 NXP
+ * Copyright 2024-2026 NXP
  * SPDX-License-Identifier: BSD-3-Clause 
  */ 
 
 #include "model_infos.hpp"
+#include "backend_selector.hpp"
+#include "gst_preprocess_cpu.hpp"
+#include "preprocess_kernel.hpp"
 
 #include <tensorflow/lite/interpreter.h>
 #include <tensorflow/lite/kernels/register.h>
@@ -34,8 +37,19 @@ ModelInfos::ModelInfos(const std::filesystem::path &path,
                        const int &numThreads)
     : modelPath(path), backend(backend), modelWidth(0), modelHeight(0), modelChannel(0)
 {
+  if (backend == BACKEND_AUTO) {
+    log_error("%s backend is only supported for TFlite models\n", BACKEND_AUTO);
+    exit(-1);
+  }
   setTensorFilterConfig(imx, numThreads);
   tensorData.tensorNormalization = norm;
+  // Model input type is unknown until the model is read, per channel
+  // normalizations are planned then
+  inputQuantization = {InputType::other, {}, {}};
+  if (normDictionary.count(norm) != 0)
+    planInput();
+  // Keep GPU 3D for inference when it runs the model
+  videoscale.setGpu3dAllowed(backend != "GPU");
 }
 
 
@@ -44,21 +58,46 @@ ModelInfos::ModelInfos(const std::filesystem::path &path,
  * 
  * @param pipeline: GstPipelineImx pipeline.
  * @param gstName: tensor_filter element name, empty by default.
- * @param format: tensor_filter input format, RGB by default.
+ * @param format: tensor_filter input format, RGB by default, empty if
+ *                input already has model format and resolution.
  */
 void ModelInfos::addInferenceToPipeline(GstPipelineImx &pipeline,
                                         const std::string &gstName,
                                         const std::string &format)
 {
+  // Frame placement in model input, for decoders to map results back
+  bool keepRatio = keepAspectRatio && !format.empty();
+  if (keepRatio && (pipeline.getDisplayWidth() <= 0 || pipeline.getDisplayHeight() <= 0)) {
+    log_info("Letterbox needs source resolution, frames are stretched\n");
+    keepRatio = false;
+  }
+  letterbox = computeLetterbox(pipeline.getDisplayWidth(), pipeline.getDisplayHeight(),
+                               modelWidth, modelHeight, keepRatio);
+
   std::string cmd;
-  if (format == "RGB") {
-    videoscale.videoscaleToRGB(pipeline, modelWidth, modelHeight);
+  if (addPreprocessToPipeline(pipeline, format)) {
+    tensorData.tensorTransform = "";
   } else {
-    videoscale.videoTransform(pipeline, format, modelWidth, modelHeight, false, false, true);
+    int width = letterbox.scaledWidth;
+    int height = letterbox.scaledHeight;
+    if (format == "RGB") {
+      videoscale.videoscaleToRGB(pipeline, width, height);
+    } else if (format.length() != 0) {
+      videoscale.videoTransform(pipeline, format, width, height, false, false, true);
+    }
+    if (isLetterboxed(letterbox))
+      videoscale.videoLetterbox(pipeline, letterbox);
+    if (inputPlan.hasNormalization) {
+      tensorData.tensorTransform = tensorCustomData.setTensorTransformConfig(
+          normalizationName(inputPlan.normalization), pipeline);
+    } else {
+      tensorData.tensorTransform = tensorCustomData.setAffineTransformConfig(
+          inputPlan.mul, inputPlan.add, inputPlan.channels,
+          inputTypeName(inputPlan.type), pipeline);
+    }
+    cmd += "tensor_converter ! ";
+    cmd += tensorData.tensorTransform;
   }
-  tensorData.tensorTransform = tensorCustomData.setTensorTransformConfig(tensorData.tensorNormalization, pipeline);
-  cmd += "tensor_converter ! ";
-  cmd += tensorData.tensorTransform;
   cmd += "tensor_filter latency=1 framework=" + framework + "  model=";
   cmd += modelPath.string() + " ";
   cmd += tensorData.tensorFilterCustom;
@@ -71,6 +110,92 @@ void ModelInfos::addInferenceToPipeline(GstPipelineImx &pipeline,
 }
 
 
+/**
+ * @brief Plan model input transform from requested normalization and
+ *        model input quantization.
+ */
+void ModelInfos::planInput()
+{
+  inputPlan = planInputTransform(inputQuantization,
+                                 tensorData.tensorNormalization,
+                                 isGrayscale() ? 1 : 3);
+  if (inputQuantization.type != InputType::other)
+    log_debug("%s %s\n", modelPath.filename().c_str(), describeInputPlan(inputPlan).c_str());
+}
+
+
+/**
+ * @brief Create pipeline segment converting video to model input with
+ *        preprocess_cpu element when CPU work remains after accelerators:
+ *        resize, color conversion, letterbox padding and normalization are
+ *        done in one pass instead of videoscale, videoconvert, videobox,
+ *        tensor_converter and tensor_transform elements.
+ *
+ * @param pipeline: GstPipelineImx pipeline.
+ * @param format: tensor_filter input format, empty if input already has
+ *                model format and resolution.
+ * @return false if model input must be created with tensor_converter.
+ */
+bool ModelInfos::addPreprocessToPipeline(GstPipelineImx &pipeline,
+                                         const std::string &format)
+{
+  // Transforms without named normalization are left to tensor_transform
+  if (!inputPlan.hasNormalization)
+    return false;
+  Normalization norm = inputPlan.normalization;
+  std::string modelFormat = format;
+  if (format.empty())
+    modelFormat = isGrayscale() ? "GRAY8" : "RGB";
+  if (!PreprocessKernel::isOutputFormatSupported(modelFormat))
+    return false;
+
+  if (format.empty()) {
+    // Input has model format and resolution, only normalization remains
+    if (norm == Normalization::none)
+      return false;
+  } else {
+    // Formats other than RGB are converted on CPU, as in videoTransform
+    ConversionPlan plan = videoscale.planTransform(pipeline, format, letterbox.scaledWidth,
+                                                   letterbox.scaledHeight, false,
+                                                   format != "RGB");
+    bool cpuConversion = (plan.converter == Converter::cpu)
+                         || (plan.convertFormat != plan.outputFormat);
+    if (!cpuConversion && norm == Normalization::none && !isLetterboxed(letterbox))
+      return false;
+
+    if (plan.converter != Converter::cpu) {
+      // Accelerator scales to the format it supports, CPU does the rest,
+      // letterbox placement is kept from resized frame
+      plan.outputFormat = plan.convertFormat;
+      videoscale.addPlanToPipeline(pipeline, plan);
+    } else {
+      // Source formats preprocess_cpu can not read are converted first, as
+      // videoTransform would, videoconvert is in passthrough otherwise
+      pipeline.addToPipeline("videoconvert name=csc_fallback_cpu_"
+                             + std::to_string(pipeline.elemNameCount)
+                             + " ! video/x-raw,format=(string)" PREPROCESS_VIDEO_FORMATS " ! ");
+      pipeline.elemNameCount += 1;
+    }
+  }
+
+  if (!registerPreprocessElement()) {
+    log_error("Can't register %s element\n", PREPROCESS_ELEMENT_NAME);
+    exit(-1);
+  }
+  std::string cmd = std::string(PREPROCESS_ELEMENT_NAME)
+                    + " name=preprocess_cpu_" + std::to_string(pipeline.elemNameCount)
+                    + " width=" + std::to_string(modelWidth)
+                    + " height=" + std::to_string(modelHeight)
+                    + " format=" + modelFormat
+                    + " normalization=" + normalizationName(norm)
+                    + (isLetterboxed(letterbox) ? " letterbox=true" : "")
+                    + " ! ";
+  pipeline.elemNameCount += 1;
+  pipeline.addToPipeline(cmd);
+  return true;
+}
+
+
 /**
  * @brief Setup tensor configuration, select backend use and create video
  *        compositor segment pipeline.
@@ -124,18 +249,40 @@ void ModelInfos::setTensorFilterConfig(imx::Imx &imx, const int &numThreads)
 }
 
 
+/**
+ * @brief Resolve auto backend of a TFlite model to the fastest backend,
+ *        before tensor_filter configuration.
+ *
+ * @param path: model path.
+ * @param backend: second argument at runtime corresponding to backend use.
+ * @param numThreads: number of threads for XNNPACK (CPU backend).
+ * @return CPU, GPU or NPU, or backend unchanged for other models.
+ */
+std::string TFliteModelInfos::resolveBackend(const std::filesystem::path &path,
+                                             const std::string &backend,
+                                             const int &numThreads)
+{
+  if (backend != BACKEND_AUTO || path.extension() != ".tflite")
+    return backend;
+  imx::Imx imx{};
+  return selectBackend(path, imx, numThreads);
+}
+
+
 /**
  * @brief Parameterized constructor.
  * 
  * @param path: TFlite model path.
- * @param backend: second argument at runtime corresponding to backend use.
+ * @param backend: second argument at runtime corresponding to backend use,
+ *                 auto to select the fastest backend for this model.
  * @param norm: normalization to apply to input data.
+ * @param numThreads: number of threads for XNNPACK (CPU backend).
  */
 TFliteModelInfos::TFliteModelInfos(const std::filesystem::path &path,
                                    const std::string &backend,
                                    const std::string &norm,
                                    const int &numThreads) 
-                  : ModelInfos(path, backend, norm, numThreads)
+                  : ModelInfos(path, resolveBackend(path, backend, numThreads), norm, numThreads)
 {
 if (modelPath.extension() == ".tflite") {
     framework = "tensorflow-lite";
@@ -158,7 +305,7 @@ if (modelPath.extension() == ".tflite") {
     }
 
     /* Add Ethos delegate if we use imx93 NPU. */
-    if (backend == "NPU" and imx.hasEthosNPU()) {     
+    if (this->backend == "NPU" and imx.hasEthosNPU()) {     
       const char* delegateDir = "/usr/lib/libethosu_delegate.so";
       auto delegateOptions = TfLiteExternalDelegateOptionsDefault(delegateDir);
       auto externalDelegate = TfLiteExternalDelegateCreate(&delegateOptions);
@@ -184,6 +331,40 @@ if (modelPath.extension() == ".tflite") {
     modelHeight = interpreter->tensor(input)->dims->data[1];
     modelWidth = interpreter->tensor(input)->dims->data[2];
     modelChannel = interpreter->tensor(input)->dims->data[3];
+
+    /* Get input tensor type and quantization. */
+    TfLiteTensor* inputTensor = interpreter->tensor(input);
+    switch (inputTensor->type) {
+      case kTfLiteUInt8:
+        inputQuantization.type = InputType::uint8;
+        break;
+
+      case kTfLiteInt8:
+        inputQuantization.type = InputType::int8;
+        break;
+
+      case kTfLiteFloat32:
+        inputQuantization.type = InputType::float32;
+        break;
+
+      default:
+        inputQuantization.type = InputType::other;
+        break;
+    }
+    inputQuantization.scales = {inputTensor->params.scale};
+    inputQuantization.zeroPoints = {inputTensor->params.zero_point};
+    if (inputTensor->quantization.type == kTfLiteAffineQuantization) {
+      auto* affine = static_cast<TfLiteAffineQuantization*>(inputTensor->quantization.params);
+      // Per channel quantization of input, on channel dimension
+      if (affine != nullptr && affine->scale != nullptr && affine->zero_point != nullptr
+          && affine->scale->size > 1 && affine->quantized_dimension == 3) {
+        inputQuantization.scales.assign(affine->scale->data,
+                                        affine->scale->data + affine->scale->size);
+        inputQuantization.zeroPoints.assign(affine->zero_point->data,
+                                            affine->zero_point->data + affine->zero_point->size);
+      }
+    }
+    planInput();
   } else {
     log_error("TFlite model needed\n");
     exit(-1);
@@ -1,9 +1,16 @@
 /**
- * Copyright 2024-2025 NXP
+ * Copyright 2024-2026 NXP
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include "nn_decoder.hpp"
+#include "gst_video_post_process.hpp"
+
+// Font size of 15 pixels for an image width of 640 is default
+const float boxesFontFactor = 15.0f/640;
+
+// Pascal VOC classes, including background
+#define DEEPLAB_NUM_CLASSES   21
 
 /**
  * @brief Map of models available for bounding boxes mode.
@@ -36,6 +43,39 @@ void NNDecoder::addImageSegment(GstPipelineImx &pipeline,
 {
   std::string cmd;
   std::string name;
+
+  if (options.nativeDecoder == true) {
+    if (options.modelName != ModeImageSegment::tfliteDeeplab) {
+      log_error("Native decoder is only available for tflite-deeplab\n");
+      exit(-1);
+    }
+    if ((options.maskDim.width <= 0) || (options.maskDim.height <= 0)) {
+      log_error("Mask dimension is needed for native segmentation decoder\n");
+      exit(-1);
+    }
+    // Same runtime customization as video compositor alpha blending
+    const char* envAlpha = std::getenv("ALPHA_VALUE");
+    float alpha = 0.5f;
+    if (envAlpha != nullptr) {
+      char* end = nullptr;
+      float value = strtof(envAlpha, &end);
+      if ((end != envAlpha) && (*end == '\0'))
+        alpha = value;
+      else
+        log_info("Invalid ALPHA_VALUE %s, using %.1f\n", envAlpha, alpha);
+    }
+    int numClass = (options.numClass != -1) ? options.numClass : DEEPLAB_NUM_CLASSES;
+
+    segmentSinkName = "tensor_decode_segmentation_" + std::to_string(pipeline.elemNameCount);
+    pipeline.elemNameCount += 1;
+    segmentationKernel = std::make_unique<SegmentationKernel>(numClass,
+                                                              options.maskDim.width,
+                                                              options.maskDim.height,
+                                                              alpha);
+    pipeline.addTensorSink(segmentSinkName);
+    return;
+  }
+
   // Use a common format decoder output to a compositor for consistent alpha blending
   const std::string videoMixerFormat = "YUY2";
   name = "name=tensor_decode_segmentation_" + std::to_string(pipeline.elemNameCount) + " ";
@@ -53,6 +93,96 @@ void NNDecoder::addImageSegment(GstPipelineImx &pipeline,
 }
 
 
+/**
+ * @brief Callback handing segmentation output over to native kernel.
+ */
+void NNDecoder::newSegmentCallback(GstElement* element,
+                                   GstBuffer* buffer,
+                                   gpointer user_data)
+{
+  NNDecoder* decoder = (NNDecoder *) user_data;
+
+  if (gst_buffer_n_memory(buffer) != 1) {
+    log_error("Number of tensors invalid : %d\n", gst_buffer_n_memory(buffer));
+    exit(-1);
+  }
+  decoder->segmentationKernel->setBuffer(buffer);
+}
+
+
+/**
+ * @brief Callback blending segmentation mask into the display frame.
+ */
+void NNDecoder::drawSegmentCallback(GstElement* overlay,
+                                    cairo_t* cr,
+                                    guint64 timestamp,
+                                    guint64 duration,
+                                    gpointer user_data)
+{
+  NNDecoder* decoder = (NNDecoder *) user_data;
+  cairo_surface_t* surface = cairo_get_target(cr);
+  cairo_format_t format = cairo_image_surface_get_format(surface);
+  if ((format != CAIRO_FORMAT_ARGB32) && (format != CAIRO_FORMAT_RGB24)) {
+    log_error("Native segmentation decoder needs a 32 bits overlay format\n");
+    exit(-1);
+  }
+
+  cairo_surface_flush(surface);
+  decoder->segmentationKernel->blend(cairo_image_surface_get_data(surface),
+                                     cairo_image_surface_get_width(surface),
+                                     cairo_image_surface_get_height(surface),
+                                     cairo_image_surface_get_stride(surface));
+  cairo_surface_mark_dirty(surface);
+}
+
+
+/**
+ * @brief Add cairooverlay blending native segmentation mask on the display
+ *        branch, which avoids colorizing, converting and compositing a frame.
+ *
+ * @param pipeline: GstPipelineImx pipeline.
+ */
+void NNDecoder::addImageSegmentOverlay(GstPipelineImx &pipeline)
+{
+  if (!segmentationKernel) {
+    log_error("Native segmentation decoder is not enabled\n");
+    exit(-1);
+  }
+  segmentOverlayName = segmentSinkName + "_overlay";
+  GstVideoPostProcess postProcess;
+  postProcess.addCairoOverlay(pipeline, segmentOverlayName);
+}
+
+
+/**
+ * @brief Connect native segmentation decoder to its tensor_sink and overlay,
+ *        pipeline needs to be parsed first.
+ *
+ * @param pipeline: GstPipelineImx pipeline.
+ */
+void NNDecoder::connectImageSegment(GstPipelineImx &pipeline)
+{
+  if (!segmentationKernel) {
+    log_error("Native segmentation decoder is not enabled\n");
+    exit(-1);
+  }
+  pipeline.connectToElementSignal(segmentSinkName, newSegmentCallback, "new-data", this);
+  if (segmentOverlayName.length() != 0)
+    pipeline.connectToElementSignal(segmentOverlayName, drawSegmentCallback, "draw", this);
+}
+
+
+/**
+ * @brief Get pixel count of each class from native segmentation decoder.
+ */
+std::vector<int> NNDecoder::getClassPixelCounts()
+{
+  if (!segmentationKernel)
+    return {};
+  return segmentationKernel->getClassPixelCounts();
+}
+
+
 /**
  * @brief Add NNStreamer decoder for image labeling / classification.
  * 
@@ -87,6 +217,35 @@ void NNDecoder::addBoundingBoxes(GstPipelineImx &pipeline,
   imx::Imx imx{};
   std::string cmd;
   std::string name;
+
+  if (options.nativeDecoder == true) {
+    if (options.modelName != ModeBoundingBoxes::mobilenetssd) {
+      log_error("Native decoder is only available for mobilenet-ssd\n");
+      exit(-1);
+    }
+    if (options.trackResult == true) {
+      log_error("Tracking is not available with native decoder\n");
+      exit(-1);
+    }
+    // Decode boxes from tensor_sink callback instead of rendering a frame
+    tensorSinkName = "tensor_decode_bounding_boxes_" + std::to_string(pipeline.elemNameCount);
+    pipeline.elemNameCount += 1;
+    ssdDecoder = std::make_unique<SSDBoxDecoder>(options.option3,
+                                                 options.labelsPath,
+                                                 options.outDim.width,
+                                                 options.outDim.height);
+    ssdDecoder->setLetterbox(options.letterbox);
+    logResult = options.logResult;
+    pipeline.addTensorSink(tensorSinkName);
+    return;
+  }
+
+  // NNStreamer decoder scales boxes from whole model input
+  if (isLetterboxed(options.letterbox)) {
+    log_error("Letterbox is only available with native decoder\n");
+    exit(-1);
+  }
+
   name = "name=tensor_decode_bounding_boxes_" + std::to_string(pipeline.elemNameCount) + " ";
   pipeline.elemNameCount += 1;
   cmd = "tensor_decoder ";
@@ -112,3 +271,184 @@ void NNDecoder::addBoundingBoxes(GstPipelineImx &pipeline,
 
   pipeline.addToPipeline(cmd);
 }
+
+
+
+/**
+ * @brief Callback decoding bounding boxes from tensor_sink output.
+ */
+void NNDecoder::newBoxesCallback(GstElement* element,
+                                 GstBuffer* buffer,
+                                 gpointer user_data)
+{
+  NNDecoder* decoder = (NNDecoder *) user_data;
+
+  if (gst_buffer_n_memory(buffer) != 2) {
+    log_error("Number of tensors invalid : %d\n", gst_buffer_n_memory(buffer));
+    exit(-1);
+  }
+
+  GstMapInfo locationsInfo;
+  GstMapInfo scoresInfo;
+  GstMemory* locationsMem = gst_buffer_peek_memory(buffer, 0);
+  GstMemory* scoresMem = gst_buffer_peek_memory(buffer, 1);
+  if (!gst_memory_map(locationsMem, &locationsInfo, GST_MAP_READ)) {
+    log_error("Can't access buffer in memory\n");
+    exit(-1);
+  }
+  if (!gst_memory_map(scoresMem, &scoresInfo, GST_MAP_READ)) {
+    gst_memory_unmap(locationsMem, &locationsInfo);
+    log_error("Can't access buffer in memory\n");
+    exit(-1);
+  }
+
+  std::vector<DetectedBox> &boxes = decoder->boxes.writeBuffer();
+  decoder->ssdDecoder->decode(reinterpret_cast<float*>(locationsInfo.data),
+                              locationsInfo.size/sizeof(float),
+                              reinterpret_cast<float*>(scoresInfo.data),
+                              scoresInfo.size/sizeof(float),
+                              boxes);
+  gst_memory_unmap(scoresMem, &scoresInfo);
+  gst_memory_unmap(locationsMem, &locationsInfo);
+
+  if (decoder->logResult == true) {
+    for (const DetectedBox &box : boxes) {
+      log_info("%s (%.2f): [%d, %d, %d, %d]\n",
+               decoder->getLabel(box.classId).c_str(),
+               box.score,
+               static_cast<int>(box.x1),
+               static_cast<int>(box.y1),
+               static_cast<int>(box.x2),
+               static_cast<int>(box.y2));
+    }
+  }
+
+  if (decoder->resultsPublisher != nullptr) {
+    FrameResults &results = decoder->frameResults;
+    results.pts = GST_BUFFER_PTS(buffer);
+    results.boxes.clear();
+    for (const DetectedBox &box : boxes) {
+      results.boxes.push_back(makeResultBox(box.x1, box.y1, box.x2, box.y2, box.score,
+                                            box.classId, decoder->getLabel(box.classId)));
+    }
+    decoder->resultsPublisher->publish(results);
+  }
+
+  // Published buffer is not written again before next publish
+  decoder->sinkBoxes = &boxes;
+  decoder->boxes.publish();
+}
+
+
+/**
+ * @brief Callback drawing boxes from native decoder on the display branch.
+ */
+void NNDecoder::drawBoxesCallback(GstElement* overlay,
+                                  cairo_t* cr,
+                                  guint64 timestamp,
+                                  guint64 duration,
+                                  gpointer user_data)
+{
+  NNDecoder* decoder = (NNDecoder *) user_data;
+
+  // Only render boxes again when new ones are available
+  decoder->boxes.update();
+  cairo_t* layer = decoder->boxesOverlay.beginRender(cr, decoder->boxes.getGeneration());
+  if (layer != nullptr) {
+    const std::vector<DetectedBox> &boxes = decoder->boxes.readBuffer();
+    int width = cairo_image_surface_get_width(cairo_get_target(cr));
+    cairo_set_font_size(layer, width * boxesFontFactor);
+    cairo_set_line_width(layer, 2.0);
+    cairo_set_source_rgb(layer, 1, 0, 0);
+
+    for (const DetectedBox &box : boxes)
+      cairo_rectangle(layer, box.x1, box.y1, box.x2 - box.x1, box.y2 - box.y1);
+    cairo_stroke(layer);
+
+    for (const DetectedBox &box : boxes) {
+      cairo_move_to(layer, box.x1 + 2, box.y1 + width * boxesFontFactor);
+      cairo_show_text(layer, decoder->getLabel(box.classId).c_str());
+    }
+  }
+  decoder->boxesOverlay.paint(cr);
+}
+
+
+/**
+ * @brief Add cairooverlay drawing native decoder boxes on the display branch,
+ *        which avoids rendering and blending a full frame of boxes.
+ *
+ * @param pipeline: GstPipelineImx pipeline.
+ */
+void NNDecoder::addBoundingBoxesOverlay(GstPipelineImx &pipeline)
+{
+  if (!ssdDecoder) {
+    log_error("Native bounding boxes decoder is not enabled\n");
+    exit(-1);
+  }
+  overlayName = tensorSinkName + "_overlay";
+  GstVideoPostProcess postProcess;
+  postProcess.addCairoOverlay(pipeline, overlayName);
+}
+
+
+/**
+ * @brief Connect native bounding boxes decoder to its tensor_sink and overlay,
+ *        pipeline needs to be parsed first.
+ *
+ * @param pipeline: GstPipelineImx pipeline.
+ */
+void NNDecoder::connectBoundingBoxes(GstPipelineImx &pipeline)
+{
+  if (!ssdDecoder) {
+    log_error("Native bounding boxes decoder is not enabled\n");
+    exit(-1);
+  }
+  pipeline.connectToElementSignal(tensorSinkName, newBoxesCallback, "new-data", this);
+  if (overlayName.length() != 0)
+    pipeline.connectToElementSignal(overlayName, drawBoxesCallback, "draw", this);
+}
+
+
+/**
+ * @brief Get boxes of last buffer from native bounding boxes decoder, from
+ *        a tensor_sink callback connected after connectBoundingBoxes().
+ *        Boxes are valid until next buffer.
+ */
+const std::vector<DetectedBox>& NNDecoder::getBoundingBoxes() const
+{
+  static const std::vector<DetectedBox> noBoxes;
+  return (sinkBoxes != nullptr) ? *sinkBoxes : noBoxes;
+}
+
+
+/**
+ * @brief Get label of a class detected by native bounding boxes decoder.
+ *
+ * @param classId: class index.
+ */
+std::string NNDecoder::getLabel(const int &classId) const
+{
+  if (!ssdDecoder)
+    return "";
+  return ssdDecoder->getLabel(classId);
+}
+
+
+/**
+ * @brief Publish boxes of native bounding boxes decoder for each frame.
+ *        Must be set before pipeline runs.
+ *
+ * @param publisher: results publisher, owned by caller.
+ * @param source: stream name written in results, decoder sink name by default.
+ */
+void NNDecoder::setResultsPublisher(ResultsPublisher* publisher,
+                                    const std::string &source)
+{
+  if (!ssdDecoder) {
+    log_error("Native bounding boxes decoder is not enabled\n");
+    exit(-1);
+  }
+  resultsPublisher = publisher;
+  frameResults.source = source.empty() ? tensorSinkName : source;
+}
@@ -0,0 +1,100 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "offline_runner.hpp"
+#include "core_planner.hpp"
+#include "logging.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+
+/**
+ * @brief Parameterized constructor, size number of concurrent pipelines.
+ *
+ * @param inputs: files to process.
+ * @param backend: inference backend (CPU, GPU, NPU).
+ * @param numJobs: number of concurrent pipelines, 0 to size it from number
+ *                 of cores for CPU backend, or accelerator capacity.
+ */
+OfflineRunner::OfflineRunner(const std::vector<std::filesystem::path> &inputs,
+                             const std::string &backend,
+                             const int &numJobs)
+    : inputs(inputs), numJobs(numJobs)
+{
+  if (inputs.empty()) {
+    log_error("No input to process\n");
+    exit(-1);
+  }
+
+  int numCores = usableCores().size();
+  if (this->numJobs <= 0) {
+    if (backend == "CPU")
+      this->numJobs = std::max(1, numCores / OFFLINE_CPU_THREADS_PER_JOB);
+    else
+      this->numJobs = std::min(numCores, OFFLINE_ACCELERATOR_JOBS);
+  }
+  this->numJobs = std::min(this->numJobs, static_cast<int>(inputs.size()));
+  threadsPerJob = std::max(1, numCores / this->numJobs);
+}
+
+
+/**
+ * @brief Process inputs one after the other, until all of them are taken.
+ *
+ * @param job: processing of an input.
+ */
+void OfflineRunner::worker(const OfflineJob &job)
+{
+  while (true) {
+    size_t index = nextInput.fetch_add(1);
+    if (index >= inputs.size())
+      break;
+
+    // Pipelines are built one at a time, elements names are shared
+    std::unique_lock<std::mutex> buildLock(buildMutex);
+    auto start = std::chrono::steady_clock::now();
+    uint64_t numFrames = job(inputs[index], buildLock);
+    if (buildLock.owns_lock())
+      buildLock.unlock();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    totalFrames += numFrames;
+    log_info("%s: %lu frames in %.1f s (%.1f FPS)\n",
+             inputs[index].c_str(),
+             static_cast<unsigned long>(numFrames),
+             seconds,
+             (seconds > 0) ? numFrames / seconds : 0.0);
+  }
+}
+
+
+/**
+ * @brief Process all inputs and report aggregate throughput.
+ *
+ * @param job: processing of an input, called from worker threads.
+ * @return total number of processed frames.
+ */
+uint64_t OfflineRunner::run(const OfflineJob &job)
+{
+  log_info("Processing %zu files with %d concurrent pipelines\n", inputs.size(), numJobs);
+  auto start = std::chrono::steady_clock::now();
+
+  std::vector<std::thread> workers;
+  for (int i = 0; i < numJobs; i++)
+    workers.emplace_back(&OfflineRunner::worker, this, std::cref(job));
+  for (std::thread &thread : workers)
+    thread.join();
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  uint64_t numFrames = totalFrames.load();
+  log_info("Processed %lu frames of %zu files in %.1f s, aggregate %.1f FPS\n",
+           static_cast<unsigned long>(numFrames),
+           inputs.size(),
+           seconds,
+           (seconds > 0) ? numFrames / seconds : 0.0);
+  return numFrames;
+}
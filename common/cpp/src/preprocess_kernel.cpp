@@ -0,0 +1,550 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "preprocess_kernel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define PREPROCESS_KERNEL_NEON
+#endif
+
+
+/**
+ * @brief Byte offset of a component of pixel x in its plane row:
+ *        x * pixelStride + (x / 2) * pairStride + offset.
+ */
+typedef struct {
+  int plane;
+  bool halfRows;
+  int pixelStride;
+  int pairStride;
+  int offset;
+} ComponentLayout;
+
+
+/**
+ * @brief Layout of an input format, components are Y, U, V for YUV
+ *        formats and R, G, B otherwise.
+ */
+typedef struct {
+  const char* name;
+  bool isYUV;
+  int numPlanes;
+  ComponentLayout components[3];
+} InputFormatLayout;
+
+
+const InputFormatLayout inputFormats[] = {
+  {"YUY2", true, 1, {{0, false, 2, 0, 0}, {0, false, 0, 4, 1}, {0, false, 0, 4, 3}}},
+  {"UYVY", true, 1, {{0, false, 2, 0, 1}, {0, false, 0, 4, 0}, {0, false, 0, 4, 2}}},
+  {"NV12", true, 2, {{0, false, 1, 0, 0}, {1, true, 0, 2, 0}, {1, true, 0, 2, 1}}},
+  {"I420", true, 3, {{0, false, 1, 0, 0}, {1, true, 0, 1, 0}, {2, true, 0, 1, 0}}},
+  {"RGB", false, 1, {{0, false, 3, 0, 0}, {0, false, 3, 0, 1}, {0, false, 3, 0, 2}}},
+  {"BGR", false, 1, {{0, false, 3, 0, 2}, {0, false, 3, 0, 1}, {0, false, 3, 0, 0}}},
+  {"RGBA", false, 1, {{0, false, 4, 0, 0}, {0, false, 4, 0, 1}, {0, false, 4, 0, 2}}},
+  {"RGBx", false, 1, {{0, false, 4, 0, 0}, {0, false, 4, 0, 1}, {0, false, 4, 0, 2}}},
+  {"BGRA", false, 1, {{0, false, 4, 0, 2}, {0, false, 4, 0, 1}, {0, false, 4, 0, 0}}},
+  {"BGRx", false, 1, {{0, false, 4, 0, 2}, {0, false, 4, 0, 1}, {0, false, 4, 0, 0}}},
+  {"ARGB", false, 1, {{0, false, 4, 0, 1}, {0, false, 4, 0, 2}, {0, false, 4, 0, 3}}},
+  {"xRGB", false, 1, {{0, false, 4, 0, 1}, {0, false, 4, 0, 2}, {0, false, 4, 0, 3}}},
+  {"ABGR", false, 1, {{0, false, 4, 0, 3}, {0, false, 4, 0, 2}, {0, false, 4, 0, 1}}},
+  {"xBGR", false, 1, {{0, false, 4, 0, 3}, {0, false, 4, 0, 2}, {0, false, 4, 0, 1}}},
+  {"GRAY8", false, 1, {{0, false, 1, 0, 0}, {0, false, 1, 0, 0}, {0, false, 1, 0, 0}}},
+};
+
+
+/**
+ * @brief Find layout of an input format.
+ *
+ * @param format: GStreamer video format.
+ * @return layout, nullptr if format is not supported.
+ */
+static const InputFormatLayout* findInputFormat(const std::string &format)
+{
+  for (const InputFormatLayout &layout : inputFormats) {
+    if (format == layout.name)
+      return &layout;
+  }
+  return nullptr;
+}
+
+
+/**
+ * @brief Compute bilinear source index and weight of next index, scaled
+ *        by 256, for each output index, with pixel centers aligned.
+ */
+static void bilinearTable(const int &inputSize,
+                          const int &outputSize,
+                          std::vector<int> &index,
+                          std::vector<uint16_t> &weight)
+{
+  index.resize(outputSize);
+  weight.resize(outputSize);
+  double scale = (double) inputSize / outputSize;
+  for (int i = 0; i < outputSize; i++) {
+    double position = std::max((i + 0.5) * scale - 0.5, 0.0);
+    int first = std::min((int) position, inputSize - 1);
+    int w = (int) std::lround((position - first) * 256);
+    if (w >= 256) {
+      first = std::min(first + 1, inputSize - 1);
+      w = 0;
+    }
+    if (first == inputSize - 1)
+      w = 0;
+    index[i] = first;
+    weight[i] = w;
+  }
+}
+
+
+/**
+ * @brief Parameterized constructor.
+ *
+ * @param inputFormat: GStreamer video format of input frames.
+ * @param inputWidth: input frame width.
+ * @param inputHeight: input frame height.
+ * @param outputFormat: model input layout, RGB, BGR or GRAY8.
+ * @param outputWidth: model input width.
+ * @param outputHeight: model input height.
+ * @param normalization: normalization of model input values.
+ * @param letterbox: keep frame aspect ratio, padding it with black.
+ * @param bt709: YUV input uses BT.709 matrix instead of BT.601.
+ * @param fullRange: YUV input uses full range instead of limited range.
+ */
+PreprocessKernel::PreprocessKernel(const std::string &inputFormat,
+                                   const int &inputWidth,
+                                   const int &inputHeight,
+                                   const std::string &outputFormat,
+                                   const int &outputWidth,
+                                   const int &outputHeight,
+                                   const Normalization &normalization,
+                                   const bool &letterbox,
+                                   const bool &bt709,
+                                   const bool &fullRange)
+    : inputWidth(inputWidth), inputHeight(inputHeight),
+      outputWidth(outputWidth), outputHeight(outputHeight),
+      normalization(normalization)
+{
+  const InputFormatLayout* layout = findInputFormat(inputFormat);
+  if (layout == nullptr) {
+    log_error("Preprocessing does not support %s input\n", inputFormat.c_str());
+    exit(-1);
+  }
+  if (!isOutputFormatSupported(outputFormat)) {
+    log_error("Preprocessing does not support %s output\n", outputFormat.c_str());
+    exit(-1);
+  }
+  if ((inputWidth <= 0) || (inputHeight <= 0) || (outputWidth <= 0) || (outputHeight <= 0)) {
+    log_error("Invalid preprocessing dimensions: %dx%d to %dx%d\n",
+              inputWidth, inputHeight, outputWidth, outputHeight);
+    exit(-1);
+  }
+
+  isYUV = layout->isYUV;
+  outputChannels = (outputFormat == "GRAY8") ? 1 : 3;
+  swapRedBlue = (outputFormat == "BGR");
+  // Gray of YUV input is luma, chroma is not decoded
+  numComponents = (isYUV && outputChannels == 1) ? 1 : 3;
+
+  placement = computeLetterbox(inputWidth, inputHeight, outputWidth, outputHeight, letterbox);
+  int scaledWidth = placement.scaledWidth;
+  std::vector<int> xIndex;
+  bilinearTable(inputWidth, scaledWidth, xIndex, xWeights);
+  bilinearTable(inputHeight, placement.scaledHeight, yIndex, yWeights);
+
+  for (int c = 0; c < numComponents; c++) {
+    const ComponentLayout &component = layout->components[c];
+    componentPlane[c] = component.plane;
+    componentHalfRows[c] = component.halfRows;
+    for (int tap = 0; tap < 2; tap++) {
+      componentOffsets[c][tap].resize(scaledWidth);
+      for (int x = 0; x < scaledWidth; x++) {
+        int source = std::min(xIndex[x] + tap, inputWidth - 1);
+        componentOffsets[c][tap][x] = source * component.pixelStride
+                                      + (source / 2) * component.pairStride
+                                      + component.offset;
+      }
+    }
+    rows[0][c].resize(scaledWidth);
+    rows[1][c].resize(scaledWidth);
+  }
+  rowSource[0] = rowSource[1] = -1;
+  // Padding columns of pixels stay black
+  pixels.assign(outputWidth * outputChannels, 0);
+  paddingRow.resize(outputWidth * outputChannels * getTensorTypeSize(normalization));
+  if (normalization == Normalization::none)
+    std::fill(paddingRow.begin(), paddingRow.end(), 0);
+  else
+    normalizeRow(pixels.data(), paddingRow.data());
+
+  lumaOffset = fullRange ? 0 : 16;
+  if (fullRange) {
+    coefY = 256;
+    coefRV = bt709 ? 403 : 359;
+    coefGU = bt709 ? 48 : 88;
+    coefGV = bt709 ? 120 : 183;
+    coefBU = bt709 ? 475 : 454;
+  } else {
+    coefY = 298;
+    coefRV = bt709 ? 459 : 409;
+    coefGU = bt709 ? 55 : 100;
+    coefGV = bt709 ? 136 : 208;
+    coefBU = bt709 ? 541 : 516;
+  }
+}
+
+
+/**
+ * @brief Decode a source row into a row buffer, interpolated horizontally
+ *        at resized frame width, values scaled by 256.
+ *
+ * @param planes: input planes data.
+ * @param strides: input planes strides in bytes.
+ * @param sourceRow: input row index.
+ * @param slot: row buffer index.
+ */
+void PreprocessKernel::decodeRow(const uint8_t* const planes[],
+                                 const int strides[],
+                                 const int &sourceRow,
+                                 const int &slot)
+{
+  for (int c = 0; c < numComponents; c++) {
+    int plane = componentPlane[c];
+    int row = componentHalfRows[c] ? sourceRow / 2 : sourceRow;
+    const uint8_t* data = planes[plane] + (size_t) row * strides[plane];
+    const int32_t* first = componentOffsets[c][0].data();
+    const int32_t* second = componentOffsets[c][1].data();
+    const uint16_t* weights = xWeights.data();
+    uint16_t* output = rows[slot][c].data();
+    for (int x = 0; x < placement.scaledWidth; x++)
+      output[x] = data[first[x]] * (256 - weights[x]) + data[second[x]] * weights[x];
+  }
+  rowSource[slot] = sourceRow;
+}
+
+
+/**
+ * @brief Interpolate two row buffers vertically and convert them to
+ *        8 bits output layout.
+ *
+ * @param top: row buffer index of upper source row.
+ * @param bottom: row buffer index of lower source row.
+ * @param weight: weight of lower source row, scaled by 256.
+ * @param output: resized frame row, scaledWidth * outputChannels bytes.
+ */
+void PreprocessKernel::convertRow(const int &top,
+                                  const int &bottom,
+                                  const uint16_t &weight,
+                                  uint8_t* output)
+{
+  const uint16_t* topRows[3];
+  const uint16_t* bottomRows[3];
+  for (int c = 0; c < numComponents; c++) {
+    topRows[c] = rows[top][c].data();
+    bottomRows[c] = rows[bottom][c].data();
+  }
+  uint32_t topWeight = 256 - weight;
+  uint32_t bottomWeight = weight;
+
+  int x = 0;
+#ifdef PREPROCESS_KERNEL_NEON
+  uint16x4_t topWeightVec = vdup_n_u16(topWeight);
+  uint16x4_t bottomWeightVec = vdup_n_u16(bottomWeight);
+  auto blend = [&](const int &c) {
+    uint16x8_t t = vld1q_u16(topRows[c] + x);
+    uint16x8_t b = vld1q_u16(bottomRows[c] + x);
+    uint32x4_t low = vmlal_u16(vmull_u16(vget_low_u16(t), topWeightVec),
+                               vget_low_u16(b), bottomWeightVec);
+    uint32x4_t high = vmlal_u16(vmull_u16(vget_high_u16(t), topWeightVec),
+                                vget_high_u16(b), bottomWeightVec);
+    return vcombine_u16(vrshrn_n_u32(low, 16), vrshrn_n_u32(high, 16));
+  };
+  auto toRGB = [&](const int32x4_t &base, const int16x4_t &u, const int16x4_t &v,
+                   int32x4_t &r, int32x4_t &g, int32x4_t &b) {
+    r = vmlal_n_s16(base, v, coefRV);
+    g = vmlsl_n_s16(vmlsl_n_s16(base, u, coefGU), v, coefGV);
+    b = vmlal_n_s16(base, u, coefBU);
+  };
+  auto narrow = [](const int32x4_t &low, const int32x4_t &high) {
+    return vqmovn_u16(vcombine_u16(vqrshrun_n_s32(low, 8), vqrshrun_n_s32(high, 8)));
+  };
+
+  for (; x + 8 <= placement.scaledWidth; x += 8) {
+    uint8x8_t red = vdup_n_u8(0), green = red, blue = red, gray = red;
+    if (isYUV) {
+      int16x8_t luma = vsubq_s16(vreinterpretq_s16_u16(blend(0)), vdupq_n_s16(lumaOffset));
+      int32x4_t baseLow = vmull_n_s16(vget_low_s16(luma), coefY);
+      int32x4_t baseHigh = vmull_n_s16(vget_high_s16(luma), coefY);
+      if (outputChannels == 1) {
+        gray = narrow(baseLow, baseHigh);
+      } else {
+        int16x8_t u = vsubq_s16(vreinterpretq_s16_u16(blend(1)), vdupq_n_s16(128));
+        int16x8_t v = vsubq_s16(vreinterpretq_s16_u16(blend(2)), vdupq_n_s16(128));
+        int32x4_t rLow, gLow, bLow, rHigh, gHigh, bHigh;
+        toRGB(baseLow, vget_low_s16(u), vget_low_s16(v), rLow, gLow, bLow);
+        toRGB(baseHigh, vget_high_s16(u), vget_high_s16(v), rHigh, gHigh, bHigh);
+        red = narrow(rLow, rHigh);
+        green = narrow(gLow, gHigh);
+        blue = narrow(bLow, bHigh);
+      }
+    } else {
+      uint16x8_t r = blend(0);
+      uint16x8_t g = blend(1);
+      uint16x8_t b = blend(2);
+      if (outputChannels == 1) {
+        uint16x8_t sum = vmlaq_n_u16(vmlaq_n_u16(vmulq_n_u16(r, 77), g, 150), b, 29);
+        gray = vrshrn_n_u16(sum, 8);
+      } else {
+        red = vmovn_u16(r);
+        green = vmovn_u16(g);
+        blue = vmovn_u16(b);
+      }
+    }
+
+    if (outputChannels == 1) {
+      vst1_u8(output + x, gray);
+    } else {
+      uint8x8x3_t rgb;
+      rgb.val[0] = swapRedBlue ? blue : red;
+      rgb.val[1] = green;
+      rgb.val[2] = swapRedBlue ? red : blue;
+      vst3_u8(output + 3 * x, rgb);
+    }
+  }
+#endif
+
+  // Members are copied, as 8 bits stores may alias them
+  const int width = placement.scaledWidth;
+  const int32_t offset = lumaOffset;
+  const int32_t cy = coefY, crv = coefRV, cgu = coefGU, cgv = coefGV, cbu = coefBU;
+  const uint16_t* top0 = topRows[0];
+  const uint16_t* top1 = topRows[numComponents > 1 ? 1 : 0];
+  const uint16_t* top2 = topRows[numComponents > 1 ? 2 : 0];
+  const uint16_t* bottom0 = bottomRows[0];
+  const uint16_t* bottom1 = bottomRows[numComponents > 1 ? 1 : 0];
+  const uint16_t* bottom2 = bottomRows[numComponents > 1 ? 2 : 0];
+  auto blendScalar = [&](const uint16_t* t, const uint16_t* b, const int &i) -> int32_t {
+    return (t[i] * topWeight + b[i] * bottomWeight + 32768) >> 16;
+  };
+  auto clamp8 = [](const int32_t &value) {
+    return (uint8_t) std::clamp((value + 128) >> 8, 0, 255);
+  };
+  const int redIndex = swapRedBlue ? 2 : 0;
+  const int blueIndex = swapRedBlue ? 0 : 2;
+
+  if (isYUV && outputChannels == 1) {
+    for (; x < width; x++)
+      output[x] = clamp8((blendScalar(top0, bottom0, x) - offset) * cy);
+  } else if (isYUV) {
+    for (; x < width; x++) {
+      int32_t base = (blendScalar(top0, bottom0, x) - offset) * cy;
+      int32_t u = blendScalar(top1, bottom1, x) - 128;
+      int32_t v = blendScalar(top2, bottom2, x) - 128;
+      output[3 * x + redIndex] = clamp8(base + crv * v);
+      output[3 * x + 1] = clamp8(base - cgu * u - cgv * v);
+      output[3 * x + blueIndex] = clamp8(base + cbu * u);
+    }
+  } else if (outputChannels == 1) {
+    for (; x < width; x++)
+      output[x] = (77 * blendScalar(top0, bottom0, x) + 150 * blendScalar(top1, bottom1, x)
+                   + 29 * blendScalar(top2, bottom2, x) + 128) >> 8;
+  } else {
+    for (; x < width; x++) {
+      output[3 * x + redIndex] = blendScalar(top0, bottom0, x);
+      output[3 * x + 1] = blendScalar(top1, bottom1, x);
+      output[3 * x + blueIndex] = blendScalar(top2, bottom2, x);
+    }
+  }
+}
+
+
+/**
+ * @brief Write a row of 8 bits values with model input normalization.
+ *
+ * @param input: 8 bits values of output row.
+ * @param output: model input row.
+ */
+void PreprocessKernel::normalizeRow(const uint8_t* input, void* output)
+{
+  int size = outputWidth * outputChannels;
+  int i = 0;
+
+  if (normalization == Normalization::centered) {
+    // Same as typecast to int16, add -128 and typecast to int8
+    int8_t* values = static_cast<int8_t*>(output);
+#ifdef PREPROCESS_KERNEL_NEON
+    for (; i + 16 <= size; i += 16)
+      vst1q_s8(values + i, vreinterpretq_s8_u8(veorq_u8(vld1q_u8(input + i), vdupq_n_u8(0x80))));
+#endif
+    for (; i < size; i++)
+      values[i] = (int8_t) (input[i] ^ 0x80);
+    return;
+  }
+
+  float scale = 1.0f / 255;
+  float offset = 0.0f;
+  if (normalization == Normalization::centeredScaled) {
+    scale = 1.0f / 127.5f;
+    offset = -1.0f;
+  }
+  float* values = static_cast<float*>(output);
+#ifdef PREPROCESS_KERNEL_NEON
+  float32x4_t scaleVec = vdupq_n_f32(scale);
+  float32x4_t offsetVec = vdupq_n_f32(offset);
+  for (; i + 8 <= size; i += 8) {
+    uint16x8_t wide = vmovl_u8(vld1_u8(input + i));
+    float32x4_t low = vcvtq_f32_u32(vmovl_u16(vget_low_u16(wide)));
+    float32x4_t high = vcvtq_f32_u32(vmovl_u16(vget_high_u16(wide)));
+    vst1q_f32(values + i, vfmaq_f32(offsetVec, low, scaleVec));
+    vst1q_f32(values + i + 4, vfmaq_f32(offsetVec, high, scaleVec));
+  }
+#endif
+  for (; i < size; i++)
+    values[i] = input[i] * scale + offset;
+}
+
+
+/**
+ * @brief Preprocess a frame into model input.
+ *
+ * @param planes: input planes data.
+ * @param strides: input planes strides in bytes.
+ * @param output: model input, getOutputSize() bytes.
+ */
+void PreprocessKernel::process(const uint8_t* const planes[],
+                               const int strides[],
+                               void* output)
+{
+  // Row buffers are only valid within a frame
+  rowSource[0] = rowSource[1] = -1;
+  size_t rowSize = (size_t) outputWidth * outputChannels * getTensorTypeSize(normalization);
+  uint8_t* outputRow = static_cast<uint8_t*>(output);
+
+  size_t left = (size_t) placement.left * outputChannels;
+  size_t scaledSize = (size_t) placement.scaledWidth * outputChannels;
+  int scaledTop = placement.top;
+  int scaledBottom = placement.top + placement.scaledHeight;
+
+  for (int y = 0; y < outputHeight; y++, outputRow += rowSize) {
+    if ((y < scaledTop) || (y >= scaledBottom)) {
+      std::memcpy(outputRow, paddingRow.data(), rowSize);
+      continue;
+    }
+    int first = yIndex[y - scaledTop];
+    int second = std::min(first + 1, inputHeight - 1);
+    uint16_t weight = yWeights[y - scaledTop];
+
+    // Reuse decoded rows of previous output row
+    int top = (rowSource[0] == first) ? 0 : ((rowSource[1] == first) ? 1 : -1);
+    if (top < 0) {
+      top = (rowSource[0] == second) ? 1 : 0;
+      decodeRow(planes, strides, first, top);
+    }
+    int bottom = top;
+    if (weight != 0) {
+      bottom = 1 - top;
+      if (rowSource[bottom] != second)
+        decodeRow(planes, strides, second, bottom);
+    }
+
+    if (normalization == Normalization::none) {
+      convertRow(top, bottom, weight, outputRow + left);
+      if (scaledSize != rowSize) {
+        std::memset(outputRow, 0, left);
+        std::memset(outputRow + left + scaledSize, 0, rowSize - left - scaledSize);
+      }
+    } else {
+      convertRow(top, bottom, weight, pixels.data() + left);
+      normalizeRow(pixels.data(), outputRow);
+    }
+  }
+}
+
+
+/**
+ * @brief Get size of model input in bytes.
+ */
+size_t PreprocessKernel::getOutputSize() const
+{
+  return (size_t) outputWidth * outputHeight * outputChannels
+         * getTensorTypeSize(normalization);
+}
+
+
+/**
+ * @brief Check if a GStreamer video format can be preprocessed.
+ *
+ * @param format: GStreamer video format.
+ */
+bool PreprocessKernel::isInputFormatSupported(const std::string &format)
+{
+  return findInputFormat(format) != nullptr;
+}
+
+
+/**
+ * @brief Check if a model input layout can be produced.
+ *
+ * @param format: model input layout as GStreamer video format.
+ */
+bool PreprocessKernel::isOutputFormatSupported(const std::string &format)
+{
+  return format == "RGB" || format == "BGR" || format == "GRAY8";
+}
+
+
+/**
+ * @brief Get number of planes of an input format.
+ *
+ * @param format: GStreamer video format.
+ */
+int PreprocessKernel::getNumPlanes(const std::string &format)
+{
+  const InputFormatLayout* layout = findInputFormat(format);
+  return (layout != nullptr) ? layout->numPlanes : 0;
+}
+
+
+/**
+ * @brief Get NNStreamer tensor type of model input for a normalization,
+ *        same as tensor_transform output.
+ *
+ * @param normalization: normalization of model input values.
+ */
+std::string PreprocessKernel::getTensorType(const Normalization &normalization)
+{
+  switch (normalization) {
+    case Normalization::centered:
+      return "int8";
+    case Normalization::scaled:
+    case Normalization::centeredScaled:
+      return "float32";
+    default:
+      return "uint8";
+  }
+}
+
+
+/**
+ * @brief Get size in bytes of a model input value for a normalization.
+ *
+ * @param normalization: normalization of model input values.
+ */
+size_t PreprocessKernel::getTensorTypeSize(const Normalization &normalization)
+{
+  switch (normalization) {
+    case Normalization::centered:
+      return sizeof(int8_t);
+    case Normalization::scaled:
+    case Normalization::centeredScaled:
+      return sizeof(float);
+    default:
+      return sizeof(uint8_t);
+  }
+}
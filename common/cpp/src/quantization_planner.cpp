@@ -0,0 +1,297 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+#include "quantization_planner.hpp"
+
+// Relative tolerance on pixel scale to match model input quantization
+#define QUANT_SCALE_TOLERANCE    0.01f
+// Tolerance on pixel offset to match model input quantization, in levels
+#define QUANT_OFFSET_TOLERANCE   1.0f
+
+
+/**
+ * @brief Pixel normalization of named normalizations.
+ */
+static PixelNormalization namedPixelNormalization(const Normalization &normalization)
+{
+  float mean = 0.0f;
+  float std = 1.0f;
+  switch (normalization) {
+    case Normalization::centered:
+      mean = 128.0f;
+      break;
+
+    case Normalization::scaled:
+      std = 255.0f;
+      break;
+
+    case Normalization::centeredScaled:
+      mean = 127.5f;
+      std = 127.5f;
+      break;
+
+    default:
+      break;
+  }
+
+  PixelNormalization pixelNorm;
+  for (int c = 0; c < INPUT_MAX_CHANNELS; c++) {
+    pixelNorm.mean[c] = mean;
+    pixelNorm.std[c] = std;
+  }
+  return pixelNorm;
+}
+
+
+/**
+ * @brief Parse values separated by ':', a single value is used for all
+ *        channels.
+ *
+ * @return false if values are invalid.
+ */
+static bool parseChannelValues(const std::string &text, float values[])
+{
+  std::vector<float> parsed;
+  std::stringstream stream(text);
+  std::string item;
+  while (std::getline(stream, item, ':')) {
+    try {
+      size_t end;
+      parsed.push_back(std::stof(item, &end));
+      if (end != item.length())
+        return false;
+    } catch (const std::exception &e) {
+      return false;
+    }
+  }
+  if (parsed.size() != 1 && parsed.size() != INPUT_MAX_CHANNELS)
+    return false;
+  for (int c = 0; c < INPUT_MAX_CHANNELS; c++)
+    values[c] = parsed[(parsed.size() == 1) ? 0 : c];
+  return true;
+}
+
+
+/**
+ * @brief Parse a normalization: a named normalization (none, centered,
+ *        scaled or centeredScaled), or per channel mean and standard
+ *        deviation as "mean=R:G:B/std=R:G:B", e.g. ImageNet
+ *        "mean=123.675:116.28:103.53/std=58.395:57.12:57.375".
+ *
+ * @param norm: normalization string.
+ * @param pixelNorm: parsed pixel normalization.
+ * @return false if normalization is invalid.
+ */
+bool parsePixelNormalization(const std::string &norm,
+                             PixelNormalization &pixelNorm)
+{
+  if (normDictionary.count(norm) != 0) {
+    pixelNorm = namedPixelNormalization(normDictionary[norm]);
+    return true;
+  }
+
+  size_t separator = norm.find('/');
+  if (separator == std::string::npos)
+    return false;
+  std::string mean = norm.substr(0, separator);
+  std::string std = norm.substr(separator + 1);
+  if ((mean.rfind("mean=", 0) != 0) || (std.rfind("std=", 0) != 0))
+    return false;
+  if (!parseChannelValues(mean.substr(5), pixelNorm.mean)
+      || !parseChannelValues(std.substr(4), pixelNorm.std))
+    return false;
+
+  for (int c = 0; c < INPUT_MAX_CHANNELS; c++) {
+    if (pixelNorm.std[c] == 0.0f)
+      return false;
+  }
+  return true;
+}
+
+
+/**
+ * @brief Plan of a named normalization, as applied without model
+ *        quantization information.
+ */
+static InputPlan namedPlan(const Normalization &normalization, const int &channels)
+{
+  InputPlan plan;
+  plan.hasNormalization = true;
+  plan.normalization = normalization;
+  plan.channels = channels;
+  switch (normalization) {
+    case Normalization::centered:
+      plan.transform = InputTransform::zeroPointShift;
+      plan.type = InputType::int8;
+      break;
+
+    case Normalization::scaled:
+    case Normalization::centeredScaled:
+      plan.transform = InputTransform::affine;
+      plan.type = InputType::float32;
+      break;
+
+    default:
+      plan.transform = InputTransform::none;
+      plan.type = InputType::uint8;
+      break;
+  }
+
+  PixelNormalization pixelNorm = namedPixelNormalization(normalization);
+  for (int c = 0; c < INPUT_MAX_CHANNELS; c++) {
+    plan.mul[c] = 1.0f / pixelNorm.std[c];
+    plan.add[c] = -pixelNorm.mean[c] / pixelNorm.std[c] + 0.0f;
+  }
+  return plan;
+}
+
+
+/**
+ * @brief Plan minimal transform from 8 bits pixels to model input.
+ *
+ * Float models get the requested normalization. For uint8 and int8 models,
+ * quantization of the requested normalization is computed: when it matches
+ * model input quantization, pixels are fed as is (uint8) or shifted by 128
+ * (int8). Otherwise, a per channel mean and standard deviation is
+ * requantized on the CPU, while a named normalization is ignored, since
+ * model input quantization already describes its input values.
+ *
+ * @param quantization: model input type and quantization.
+ * @param norm: requested normalization, see parsePixelNormalization().
+ * @param channels: number of model input channels.
+ * @return model input transform.
+ */
+InputPlan planInputTransform(const InputQuantization &quantization,
+                             const std::string &norm,
+                             const int &channels)
+{
+  PixelNormalization pixelNorm;
+  if (!parsePixelNormalization(norm, pixelNorm)) {
+    log_error("Invalid normalization %s\n", norm.c_str());
+    exit(-1);
+  }
+  bool named = (normDictionary.count(norm) != 0);
+  int numChannels = std::min(std::max(channels, 1), INPUT_MAX_CHANNELS);
+
+  if (quantization.type == InputType::other) {
+    if (!named) {
+      log_error("Per channel normalization needs uint8, int8 or float32 model input\n");
+      exit(-1);
+    }
+    return namedPlan(normDictionary[norm], numChannels);
+  }
+
+  if (quantization.type == InputType::float32) {
+    if (named && (normDictionary[norm] == Normalization::scaled
+                  || normDictionary[norm] == Normalization::centeredScaled))
+      return namedPlan(normDictionary[norm], numChannels);
+
+    InputPlan plan = namedPlan(Normalization::scaled, numChannels);
+    plan.hasNormalization = false;
+    for (int c = 0; c < INPUT_MAX_CHANNELS; c++) {
+      plan.mul[c] = 1.0f / pixelNorm.std[c];
+      plan.add[c] = -pixelNorm.mean[c] / pixelNorm.std[c] + 0.0f;
+    }
+    return plan;
+  }
+
+  // Quantized value of pixel: pixel / (std * scale) + zeroPoint - mean / (std * scale)
+  bool isInt8 = (quantization.type == InputType::int8);
+  float targetOffset = isInt8 ? -128.0f : 0.0f;
+  InputPlan plan = namedPlan(isInt8 ? Normalization::centered : Normalization::none,
+                             numChannels);
+  bool matches = true;
+  for (int c = 0; c < INPUT_MAX_CHANNELS; c++) {
+    size_t index = (quantization.scales.size() > (size_t) c) ? c : 0;
+    float scale = quantization.scales.empty() ? 1.0f : quantization.scales[index];
+    int32_t zeroPoint = quantization.zeroPoints.empty() ? 0 : quantization.zeroPoints[index];
+    if (scale <= 0.0f)
+      scale = 1.0f;
+    plan.mul[c] = 1.0f / (pixelNorm.std[c] * scale);
+    plan.add[c] = zeroPoint - pixelNorm.mean[c] / (pixelNorm.std[c] * scale);
+    if (c < numChannels) {
+      matches = matches && (std::fabs(plan.mul[c] - 1.0f) <= QUANT_SCALE_TOLERANCE)
+                && (std::fabs(plan.add[c] - targetOffset) <= QUANT_OFFSET_TOLERANCE);
+    }
+  }
+
+  if (matches || named) {
+    if (!matches && norm != "none") {
+      log_info("%s normalization does not match %s model input quantization, "
+               "ignored\n", norm.c_str(), inputTypeName(quantization.type).c_str());
+    }
+    return namedPlan(plan.normalization, numChannels);
+  }
+
+  plan.transform = InputTransform::affine;
+  plan.hasNormalization = false;
+  return plan;
+}
+
+
+/**
+ * @brief Get NNStreamer name of a model input type.
+ */
+std::string inputTypeName(const InputType &type)
+{
+  switch (type) {
+    case InputType::uint8:
+      return "uint8";
+    case InputType::int8:
+      return "int8";
+    case InputType::float32:
+      return "float32";
+    default:
+      return "other";
+  }
+}
+
+
+/**
+ * @brief Get name of a normalization, as used by normDictionary.
+ */
+std::string normalizationName(const Normalization &normalization)
+{
+  for (auto &pair : normDictionary) {
+    if (pair.second == normalization)
+      return pair.first;
+  }
+  return "none";
+}
+
+
+/**
+ * @brief Describe an input plan, e.g. "int8 input: zero point shift".
+ */
+std::string describeInputPlan(const InputPlan &plan)
+{
+  std::string description = inputTypeName(plan.type) + " input: ";
+  switch (plan.transform) {
+    case InputTransform::none:
+      return description + "none";
+
+    case InputTransform::zeroPointShift:
+      return description + "zero point shift";
+
+    default:
+      break;
+  }
+
+  if (plan.hasNormalization)
+    return description + normalizationName(plan.normalization);
+
+  std::string mul;
+  std::string add;
+  for (int c = 0; c < plan.channels; c++) {
+    mul += ((c == 0) ? "" : ":") + std::to_string(plan.mul[c]);
+    add += ((c == 0) ? "" : ":") + std::to_string(plan.add[c]);
+  }
+  return description + "pixel * " + mul + " + " + add;
+}
@@ -0,0 +1,328 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <algorithm>
+#include <chrono>
+
+#include "queue_autotuner.hpp"
+
+
+/**
+ * @brief Monotonic time in nanoseconds.
+ */
+static uint64_t monotonicNs()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+/**
+ * @brief Exponential moving average of durations, first sample is used
+ *        as is.
+ */
+static uint64_t averageNs(const uint64_t &average, const uint64_t &sample)
+{
+  return (average == 0) ? sample : (3 * average + sample) / 4;
+}
+
+
+/**
+ * @brief Register a queue, before pipeline is parsed or run.
+ *
+ * @param options: queue name and bounds of its settings.
+ * @return queue index.
+ */
+int QueueAutotuner::addQueue(const AutotuneQueueOptions &options)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  TunedQueue queue = {};
+  queue.autotuner = this;
+  queue.index = queues.size();
+  queue.options = options;
+  queue.options.minBuffers = std::max(1, options.minBuffers);
+  queue.options.maxBuffers = std::max(queue.options.minBuffers, options.maxBuffers);
+  queue.maxSizeBuffers = queue.options.minBuffers;
+  queue.maxSizeTimeNs = options.maxTimeNs;
+  queues.push_back(queue);
+  return queue.index;
+}
+
+
+/**
+ * @brief Set queue limits. Size in bytes is not limited, so that large
+ *        frames do not limit depth before buffers and time do.
+ */
+void QueueAutotuner::applySettings(GstElement* element,
+                                   const int &maxSizeBuffers,
+                                   const uint64_t &maxSizeTimeNs)
+{
+  g_object_set(G_OBJECT(element),
+               "max-size-buffers", (guint) maxSizeBuffers,
+               "max-size-time", (guint64) maxSizeTimeNs,
+               "max-size-bytes", (guint) 0,
+               NULL);
+}
+
+
+/**
+ * @brief Add occupancy probes and overrun and underrun callbacks to parsed
+ *        pipeline. Tuning starts from max-size-buffers of the queue, within
+ *        bounds.
+ *
+ * @param pipeline: GstPipelineImx pipeline, parsed.
+ */
+void QueueAutotuner::attach(GstPipelineImx &pipeline)
+{
+  for (TunedQueue &queue : queues) {
+    GstElement* element = pipeline.getElement(queue.options.queueName);
+    if (element == nullptr) {
+      log_error("Could not get %s\n", queue.options.queueName.c_str());
+      exit(-1);
+    }
+
+    guint maxSizeBuffers = 0;
+    g_object_get(G_OBJECT(element), "max-size-buffers", &maxSizeBuffers, NULL);
+    queue.maxSizeBuffers = std::clamp(static_cast<int>(maxSizeBuffers),
+                                      queue.options.minBuffers,
+                                      queue.options.maxBuffers);
+    applySettings(element, queue.maxSizeBuffers, queue.maxSizeTimeNs);
+
+    GstPad* sinkPad = gst_element_get_static_pad(element, "sink");
+    GstPad* srcPad = gst_element_get_static_pad(element, "src");
+    if ((sinkPad == nullptr) || (srcPad == nullptr)) {
+      log_error("Could not get pads of %s\n", queue.options.queueName.c_str());
+      exit(-1);
+    }
+    gst_pad_add_probe(sinkPad, GST_PAD_PROBE_TYPE_BUFFER, arrivalProbe, &queue, nullptr);
+    gst_pad_add_probe(srcPad, GST_PAD_PROBE_TYPE_BUFFER, departureProbe, &queue, nullptr);
+    gst_object_unref(sinkPad);
+    gst_object_unref(srcPad);
+
+    // Signals are only emitted when queue is not silent, its default
+    g_signal_connect(element, "overrun", G_CALLBACK(overrunCallback), &queue);
+    g_signal_connect(element, "underrun", G_CALLBACK(underrunCallback), &queue);
+    gst_object_unref(element);
+  }
+}
+
+
+/**
+ * @brief Record arrival of a buffer in a queue, to measure frame interval.
+ *
+ * @param queue: queue index.
+ * @param nowNs: monotonic time of arrival.
+ */
+void QueueAutotuner::arrive(const int &queue, const uint64_t &nowNs)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  TunedQueue &tuned = queues[queue];
+  if (tuned.lastArrivalNs != 0)
+    tuned.arrivalIntervalNs = averageNs(tuned.arrivalIntervalNs, nowNs - tuned.lastArrivalNs);
+  tuned.lastArrivalNs = nowNs;
+}
+
+
+/**
+ * @brief Record departure of a buffer from a queue, and tune queue at end
+ *        of each window.
+ *
+ * @param queue: queue index.
+ * @param level: buffers still waiting in queue.
+ * @param nowNs: monotonic time of departure.
+ * @return true if settings changed.
+ */
+bool QueueAutotuner::depart(const int &queue, const int &level, const uint64_t &nowNs)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  TunedQueue &tuned = queues[queue];
+  if (tuned.windowStartNs == 0)
+    tuned.windowStartNs = nowNs;
+  tuned.windowDepartures += 1;
+  tuned.windowLevelSum += level;
+  if (nowNs - tuned.windowStartNs < AUTOTUNE_WINDOW_NS)
+    return false;
+
+  bool changed = tune(tuned);
+  tuned.windowStartNs = nowNs;
+  tuned.windowDepartures = 0;
+  tuned.windowLevelSum = 0;
+  tuned.windowOverruns = 0;
+  tuned.windowUnderruns = 0;
+  return changed;
+}
+
+
+/**
+ * @brief Tune a queue from occupancy of the last window, mutex held.
+ *
+ * @return true if settings changed.
+ */
+bool QueueAutotuner::tune(TunedQueue &queue)
+{
+  queue.meanLevel = static_cast<float>(queue.windowLevelSum) / queue.windowDepartures;
+
+  int maxSizeBuffers = queue.maxSizeBuffers;
+  // Queue dropped or blocked frames and still starved its downstream
+  // stage: arrival jitter is larger than queue depth
+  bool starved = (queue.windowOverruns > 0) && (queue.windowUnderruns > 0);
+  if (starved && maxSizeBuffers < queue.options.maxBuffers) {
+    queue.starvedBuffers = std::max(queue.starvedBuffers, maxSizeBuffers);
+    maxSizeBuffers += 1;
+  }
+
+  // Downstream stage always had waiting buffers: they only add latency.
+  // Depth which starved is not tried again.
+  int minBuffers = std::max(queue.options.minBuffers, queue.starvedBuffers + 1);
+  bool backlog = (queue.windowUnderruns == 0) && (queue.meanLevel >= AUTOTUNE_BACKLOG_LEVEL);
+  if (!starved && backlog && maxSizeBuffers > minBuffers)
+    maxSizeBuffers -= 1;
+
+  // Half a frame interval more than buffers, so time limit is only reached
+  // when frames slow down. Rounded to milliseconds, not to follow jitter.
+  uint64_t maxSizeTimeNs = queue.options.maxTimeNs;
+  if (queue.arrivalIntervalNs != 0) {
+    uint64_t timeNs = maxSizeBuffers * queue.arrivalIntervalNs + queue.arrivalIntervalNs / 2;
+    maxSizeTimeNs = std::min(maxSizeTimeNs, (timeNs / 1000000 + 1) * 1000000);
+  }
+
+  bool changed = (maxSizeBuffers != queue.maxSizeBuffers);
+  queue.maxSizeBuffers = maxSizeBuffers;
+  // Time limit follows frame interval, it only resets convergence with buffers
+  bool timeChanged = (maxSizeTimeNs != queue.maxSizeTimeNs);
+  queue.maxSizeTimeNs = maxSizeTimeNs;
+  if (changed) {
+    queue.stableWindows = 0;
+    queue.converged = false;
+    log_debug("%s: max-size-buffers=%d, mean level %.2f, %llu overruns, %llu underruns\n",
+              queue.options.queueName.c_str(), maxSizeBuffers, queue.meanLevel,
+              (unsigned long long) queue.windowOverruns,
+              (unsigned long long) queue.windowUnderruns);
+  } else if (!queue.converged && ++queue.stableWindows >= AUTOTUNE_STABLE_WINDOWS) {
+    queue.converged = true;
+    log_info("%s converged: .maxSizeBuffer = %d, .maxSizeTime = %llu\n",
+             queue.options.queueName.c_str(), queue.maxSizeBuffers,
+             (unsigned long long) queue.maxSizeTimeNs);
+  }
+  return changed || timeChanged;
+}
+
+
+GstPadProbeReturn QueueAutotuner::arrivalProbe(GstPad* pad,
+                                               GstPadProbeInfo* info,
+                                               gpointer user_data)
+{
+  TunedQueue* queue = static_cast<TunedQueue*>(user_data);
+  queue->autotuner->arrive(queue->index, monotonicNs());
+  return GST_PAD_PROBE_OK;
+}
+
+
+/**
+ * @brief Sample queue level on each buffer pushed downstream, and apply
+ *        new settings. Queue lock is not held while it pushes.
+ */
+GstPadProbeReturn QueueAutotuner::departureProbe(GstPad* pad,
+                                                 GstPadProbeInfo* info,
+                                                 gpointer user_data)
+{
+  TunedQueue* queue = static_cast<TunedQueue*>(user_data);
+  GstElement* element = gst_pad_get_parent_element(pad);
+  if (element == nullptr)
+    return GST_PAD_PROBE_OK;
+
+  guint level = 0;
+  g_object_get(G_OBJECT(element), "current-level-buffers", &level, NULL);
+  QueueAutotuner* autotuner = queue->autotuner;
+  if (autotuner->depart(queue->index, level, monotonicNs())) {
+    int maxSizeBuffers;
+    uint64_t maxSizeTimeNs;
+    {
+      std::lock_guard<std::mutex> lock(autotuner->mutex);
+      maxSizeBuffers = queue->maxSizeBuffers;
+      maxSizeTimeNs = queue->maxSizeTimeNs;
+    }
+    applySettings(element, maxSizeBuffers, maxSizeTimeNs);
+  }
+  gst_object_unref(element);
+  return GST_PAD_PROBE_OK;
+}
+
+
+void QueueAutotuner::overrunCallback(GstElement* element, gpointer user_data)
+{
+  TunedQueue* queue = static_cast<TunedQueue*>(user_data);
+  queue->autotuner->countOverrun(queue->index);
+}
+
+
+void QueueAutotuner::underrunCallback(GstElement* element, gpointer user_data)
+{
+  TunedQueue* queue = static_cast<TunedQueue*>(user_data);
+  queue->autotuner->countUnderrun(queue->index);
+}
+
+
+/**
+ * @brief Count a full queue, dropping or blocking a buffer.
+ */
+void QueueAutotuner::countOverrun(const int &queue)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  queues[queue].windowOverruns += 1;
+  queues[queue].overruns += 1;
+}
+
+
+/**
+ * @brief Count an empty queue, its downstream stage waiting for a buffer.
+ */
+void QueueAutotuner::countUnderrun(const int &queue)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  queues[queue].windowUnderruns += 1;
+  queues[queue].underruns += 1;
+}
+
+
+/**
+ * @brief Get current settings and occupancy of each queue.
+ */
+std::vector<AutotuneQueueSettings> QueueAutotuner::getSettings()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  std::vector<AutotuneQueueSettings> settings;
+  for (const TunedQueue &queue : queues) {
+    settings.push_back({
+      .queueName      = queue.options.queueName,
+      .maxSizeBuffers = queue.maxSizeBuffers,
+      .maxSizeTimeNs  = queue.maxSizeTimeNs,
+      .meanLevel      = queue.meanLevel,
+      .overruns       = queue.overruns,
+      .underruns      = queue.underruns,
+      .converged      = queue.converged,
+    });
+  }
+  return settings;
+}
+
+
+/**
+ * @brief Log settings of each queue, to set them in GstQueueOptions of
+ *        production pipelines.
+ */
+void QueueAutotuner::logSettings()
+{
+  for (const AutotuneQueueSettings &settings : getSettings()) {
+    log_info("%s: .maxSizeBuffer = %d, .maxSizeTime = %llu (%s), mean level %.2f, "
+             "%llu overruns, %llu underruns\n",
+             settings.queueName.c_str(), settings.maxSizeBuffers,
+             (unsigned long long) settings.maxSizeTimeNs,
+             settings.converged ? "converged" : "not converged",
+             settings.meanLevel,
+             (unsigned long long) settings.overruns,
+             (unsigned long long) settings.underruns);
+  }
+}
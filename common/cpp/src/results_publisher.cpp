@@ -0,0 +1,495 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "results_publisher.hpp"
+#include "logging.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+// Period at which accept thread checks for shutdown
+#define RESULTS_ACCEPT_POLL_MS  100
+// Ring records alignment, keeps headers and floats aligned
+#define RESULTS_RING_ALIGNMENT  8
+
+
+static uint64_t alignRecord(const uint64_t &size)
+{
+  return (size + RESULTS_RING_ALIGNMENT - 1) & ~static_cast<uint64_t>(RESULTS_RING_ALIGNMENT - 1);
+}
+
+
+static uint64_t monotonicNs()
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + now.tv_nsec;
+}
+
+
+/**
+ * @brief Quote a string for JSON results.
+ *
+ * @param text: string to quote.
+ * @return quoted and escaped string.
+ */
+std::string toJsonString(const std::string &text)
+{
+  std::string json = "\"";
+  for (char c : text) {
+    if ((c == '"') || (c == '\\')) {
+      json += '\\';
+      json += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      json += escaped;
+    } else {
+      json += c;
+    }
+  }
+  return json + "\"";
+}
+
+
+/**
+ * @brief Build a result box, label is truncated to fit the record.
+ */
+ResultBox makeResultBox(const float &x1,
+                        const float &y1,
+                        const float &x2,
+                        const float &y2,
+                        const float &score,
+                        const int &classId,
+                        const std::string &label)
+{
+  ResultBox box = {x1, y1, x2, y2, score, classId, {}};
+  strncpy(box.label, label.c_str(), RESULTS_LABEL_SIZE - 1);
+  return box;
+}
+
+
+/**
+ * @brief Parameterized constructor, open the socket and the shared memory
+ *        ring enabled in options.
+ *
+ * @param options: ResultsPublisherOptions structure.
+ */
+ResultsPublisher::ResultsPublisher(const ResultsPublisherOptions &options)
+    : options(options)
+{
+  if (!options.socketPath.empty()) {
+    struct sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (options.socketPath.string().size() >= sizeof(address.sun_path)) {
+      log_error("Results socket path too long: %s\n", options.socketPath.c_str());
+      exit(-1);
+    }
+    strncpy(address.sun_path, options.socketPath.c_str(), sizeof(address.sun_path) - 1);
+    unlink(options.socketPath.c_str());
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if ((listenFd < 0)
+        || (bind(listenFd, (struct sockaddr *) &address, sizeof(address)) < 0)
+        || (listen(listenFd, 8) < 0)) {
+      log_error("Could not open results socket %s: %s\n",
+                options.socketPath.c_str(), strerror(errno));
+      exit(-1);
+    }
+    acceptThread = std::thread(&ResultsPublisher::acceptClients, this);
+    log_info("Publishing results on %s\n", options.socketPath.c_str());
+  }
+
+  if (!options.shmName.empty()) {
+    uint64_t capacity = alignRecord(std::max(options.shmSize, sizeof(ResultsHeader)));
+    ringMapSize = sizeof(ResultsRingHeader) + capacity;
+    int fd = shm_open(options.shmName.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0600);
+    if ((fd < 0) || (ftruncate(fd, ringMapSize) < 0)) {
+      log_error("Could not create shared memory %s: %s\n",
+                options.shmName.c_str(), strerror(errno));
+      exit(-1);
+    }
+    void* map = mmap(NULL, ringMapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+      log_error("Could not map shared memory %s: %s\n",
+                options.shmName.c_str(), strerror(errno));
+      exit(-1);
+    }
+    ring = static_cast<uint8_t*>(map);
+
+    ResultsRingHeader* header = reinterpret_cast<ResultsRingHeader*>(ring);
+    header->headerSize = sizeof(ResultsRingHeader);
+    header->capacity = capacity;
+    header->writePos.store(0, std::memory_order_relaxed);
+    header->reservePos.store(0, std::memory_order_relaxed);
+    header->lastPos.store(0, std::memory_order_relaxed);
+    // Readers check magic last, once ring is initialized
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = RESULTS_MAGIC;
+    log_info("Publishing results on shared memory %s\n", options.shmName.c_str());
+  }
+}
+
+
+ResultsPublisher::~ResultsPublisher()
+{
+  running = false;
+  if (acceptThread.joinable())
+    acceptThread.join();
+
+  if (listenFd >= 0) {
+    close(listenFd);
+    unlink(options.socketPath.c_str());
+  }
+  for (Client &client : clients)
+    close(client.fd);
+
+  if (ring != nullptr) {
+    munmap(ring, ringMapSize);
+    shm_unlink(options.shmName.c_str());
+  }
+}
+
+
+/**
+ * @brief Accept socket clients until publisher is destroyed.
+ */
+void ResultsPublisher::acceptClients()
+{
+  struct pollfd pfd = {listenFd, POLLIN, 0};
+  while (running) {
+    if (::poll(&pfd, 1, RESULTS_ACCEPT_POLL_MS) <= 0)
+      continue;
+
+    int fd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0)
+      continue;
+
+    std::lock_guard<std::mutex> lock(clientsMutex);
+    clients.push_back({fd, {}});
+    log_info("Results client connected (%zu)\n", clients.size());
+  }
+}
+
+
+/**
+ * @brief Send a message to all socket clients without blocking. Bytes a
+ *        client can't take yet are kept, and a client falling too far
+ *        behind is disconnected.
+ *
+ * @param data: message.
+ * @param size: message size in bytes.
+ */
+void ResultsPublisher::sendToClients(const uint8_t* data, const size_t &size)
+{
+  std::lock_guard<std::mutex> lock(clientsMutex);
+  for (auto it = clients.begin(); it != clients.end();) {
+    Client &client = *it;
+    bool connected = true;
+
+    if (!client.pending.empty()) {
+      ssize_t sent = send(client.fd, client.pending.data(), client.pending.size(),
+                          MSG_DONTWAIT | MSG_NOSIGNAL);
+      if (sent > 0)
+        client.pending.erase(client.pending.begin(), client.pending.begin() + sent);
+      else if ((sent < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK))
+        connected = false;
+    }
+
+    if (connected && client.pending.empty()) {
+      ssize_t sent = send(client.fd, data, size, MSG_DONTWAIT | MSG_NOSIGNAL);
+      if ((sent < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK))
+        connected = false;
+      else if (static_cast<size_t>(std::max<ssize_t>(sent, 0)) < size)
+        client.pending.assign(data + std::max<ssize_t>(sent, 0), data + size);
+    } else if (connected) {
+      client.pending.insert(client.pending.end(), data, data + size);
+    }
+
+    if (client.pending.size() > RESULTS_SOCKET_BACKLOG) {
+      log_error("Results client too slow, disconnected\n");
+      connected = false;
+    }
+
+    if (!connected) {
+      close(client.fd);
+      it = clients.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+
+/**
+ * @brief Append a record to the shared memory ring. Oldest records are
+ *        overwritten, the reserved position is published first so that
+ *        readers can detect records overwritten while they copy them.
+ *
+ * @param data: binary record.
+ * @param size: record size in bytes.
+ */
+void ResultsPublisher::writeToRing(const uint8_t* data, const size_t &size)
+{
+  ResultsRingHeader* header = reinterpret_cast<ResultsRingHeader*>(ring);
+  uint8_t* base = ring + sizeof(ResultsRingHeader);
+  uint64_t capacity = header->capacity;
+  uint64_t recordSize = alignRecord(size);
+  if (recordSize > capacity) {
+    log_error("Results record of %zu bytes larger than shared memory, dropped\n", size);
+    return;
+  }
+
+  uint64_t pos = header->writePos.load(std::memory_order_relaxed);
+  uint64_t offset = pos % capacity;
+  uint64_t padding = (offset + recordSize > capacity) ? capacity - offset : 0;
+  uint64_t end = pos + padding + recordSize;
+
+  header->reservePos.store(end, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  if (padding != 0) {
+    uint32_t wrap = 0;
+    memcpy(base + offset, &wrap, sizeof(wrap));
+  }
+  memcpy(base + (pos + padding) % capacity, data, size);
+  header->lastPos.store(pos + padding, std::memory_order_relaxed);
+  header->writePos.store(end, std::memory_order_release);
+}
+
+
+/**
+ * @brief Publish results of a frame on enabled transports. Records are
+ *        serialized once per format and sent without blocking.
+ *
+ * @param results: decoder outputs of a frame.
+ */
+void ResultsPublisher::publish(const FrameResults &results)
+{
+  std::lock_guard<std::mutex> lock(publishMutex);
+  sequence += 1;
+
+  bool socketBinary = (listenFd >= 0) && (options.socketFormat == ResultsFormat::binary);
+  if ((ring != nullptr) || socketBinary)
+    serialize(results, sequence, binary);
+  if (ring != nullptr)
+    writeToRing(binary.data(), binary.size());
+
+  if (listenFd < 0)
+    return;
+  {
+    std::lock_guard<std::mutex> clientsLock(clientsMutex);
+    if (clients.empty())
+      return;
+  }
+  if (socketBinary) {
+    sendToClients(binary.data(), binary.size());
+  } else {
+    toJson(results, sequence, json);
+    sendToClients(reinterpret_cast<const uint8_t*>(json.data()), json.size());
+  }
+}
+
+
+/**
+ * @brief Serialize results to a binary record: a ResultsHeader followed by
+ *        boxes and keypoints, in host byte order.
+ *
+ * @param results: decoder outputs of a frame.
+ * @param sequence: record sequence number.
+ * @param binary: output record, reused between frames.
+ */
+void ResultsPublisher::serialize(const FrameResults &results,
+                                 const uint64_t &sequence,
+                                 std::vector<uint8_t> &binary)
+{
+  size_t boxesSize = results.boxes.size() * sizeof(ResultBox);
+  size_t keypointsSize = results.keypoints.size() * sizeof(ResultKeypoint);
+  binary.resize(sizeof(ResultsHeader) + boxesSize + keypointsSize);
+
+  ResultsHeader header = {};
+  header.magic = RESULTS_MAGIC;
+  header.size = binary.size();
+  header.sequence = sequence;
+  header.pts = results.pts;
+  header.monotonicNs = monotonicNs();
+  header.numBoxes = results.boxes.size();
+  header.numKeypoints = results.keypoints.size();
+  strncpy(header.source, results.source.c_str(), RESULTS_SOURCE_SIZE - 1);
+
+  uint8_t* data = binary.data();
+  memcpy(data, &header, sizeof(header));
+  data += sizeof(header);
+  if (boxesSize != 0)
+    memcpy(data, results.boxes.data(), boxesSize);
+  data += boxesSize;
+  if (keypointsSize != 0)
+    memcpy(data, results.keypoints.data(), keypointsSize);
+}
+
+
+/**
+ * @brief Serialize results to a JSON line, pts is in nanoseconds or null.
+ *
+ * @param results: decoder outputs of a frame.
+ * @param sequence: record sequence number.
+ * @param json: output line, reused between frames.
+ */
+void ResultsPublisher::toJson(const FrameResults &results,
+                              const uint64_t &sequence,
+                              std::string &json)
+{
+  char number[160];
+  json.clear();
+  json += "{\"source\": " + toJsonString(results.source);
+  if (results.pts == GST_CLOCK_TIME_NONE) {
+    snprintf(number, sizeof(number), ", \"sequence\": %lu, \"pts\": null",
+             static_cast<unsigned long>(sequence));
+  } else {
+    snprintf(number, sizeof(number), ", \"sequence\": %lu, \"pts\": %lu",
+             static_cast<unsigned long>(sequence),
+             static_cast<unsigned long>(results.pts));
+  }
+  json += number;
+  snprintf(number, sizeof(number), ", \"monotonic_ns\": %lu",
+           static_cast<unsigned long>(monotonicNs()));
+  json += number;
+
+  json += ", \"boxes\": [";
+  for (size_t i = 0; i < results.boxes.size(); i++) {
+    const ResultBox &box = results.boxes[i];
+    json += (i == 0) ? "{\"label\": " : ", {\"label\": ";
+    json += toJsonString(std::string(box.label, strnlen(box.label, RESULTS_LABEL_SIZE)));
+    snprintf(number, sizeof(number),
+             ", \"class_id\": %d, \"score\": %.4f, \"box\": [%.1f, %.1f, %.1f, %.1f]}",
+             box.classId, box.score, box.x1, box.y1, box.x2, box.y2);
+    json += number;
+  }
+
+  json += "], \"keypoints\": [";
+  for (size_t i = 0; i < results.keypoints.size(); i++) {
+    const ResultKeypoint &keypoint = results.keypoints[i];
+    snprintf(number, sizeof(number), "%s[%.1f, %.1f, %.4f, %d]",
+             (i == 0) ? "" : ", ",
+             keypoint.x, keypoint.y, keypoint.score, keypoint.group);
+    json += number;
+  }
+
+  json += "]}\n";
+}
+
+
+/**
+ * @brief Parameterized constructor, map a results ring read-only. Reading
+ *        starts with the next published record.
+ *
+ * @param shmName: shared memory name given to the publisher.
+ */
+ResultsSubscriber::ResultsSubscriber(const std::string &shmName)
+{
+  int fd = shm_open(shmName.c_str(), O_RDONLY, 0);
+  struct stat info;
+  if ((fd < 0) || (fstat(fd, &info) < 0)
+      || (static_cast<size_t>(info.st_size) < sizeof(ResultsRingHeader))) {
+    log_error("Could not open shared memory %s\n", shmName.c_str());
+    exit(-1);
+  }
+  ringMapSize = info.st_size;
+  void* map = mmap(NULL, ringMapSize, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    log_error("Could not map shared memory %s: %s\n", shmName.c_str(), strerror(errno));
+    exit(-1);
+  }
+  ring = static_cast<const uint8_t*>(map);
+
+  const ResultsRingHeader* header = reinterpret_cast<const ResultsRingHeader*>(ring);
+  if ((header->magic != RESULTS_MAGIC)
+      || (header->headerSize + header->capacity > ringMapSize)) {
+    log_error("Shared memory %s is not a results ring\n", shmName.c_str());
+    exit(-1);
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  readPos = header->writePos.load(std::memory_order_acquire);
+}
+
+
+ResultsSubscriber::~ResultsSubscriber()
+{
+  munmap(const_cast<uint8_t*>(ring), ringMapSize);
+}
+
+
+/**
+ * @brief Read next binary record of the ring, without blocking. When the
+ *        publisher overran the reader, it skips to the latest record and
+ *        missed ones are counted as lost.
+ *
+ * @param record: output record, a ResultsHeader followed by its payload.
+ * @return false if no new record is available.
+ */
+bool ResultsSubscriber::poll(std::vector<uint8_t> &record)
+{
+  const ResultsRingHeader* header = reinterpret_cast<const ResultsRingHeader*>(ring);
+  const uint8_t* base = ring + header->headerSize;
+  uint64_t capacity = header->capacity;
+
+  while (true) {
+    uint64_t writePos = header->writePos.load(std::memory_order_acquire);
+    if (readPos == writePos)
+      return false;
+
+    if (writePos - readPos > capacity) {
+      readPos = header->lastPos.load(std::memory_order_relaxed);
+      continue;
+    }
+
+    uint64_t offset = readPos % capacity;
+    uint32_t magic = 0;
+    uint32_t size = 0;
+    memcpy(&magic, base + offset, sizeof(magic));
+    if (magic == RESULTS_MAGIC) {
+      memcpy(&size, base + offset + sizeof(magic), sizeof(size));
+      if ((size >= sizeof(ResultsHeader)) && (offset + size <= capacity))
+        record.assign(base + offset, base + offset + size);
+      else
+        size = 0;
+    }
+
+    // Record is valid only if publisher did not start overwriting it
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (header->reservePos.load(std::memory_order_relaxed) - readPos > capacity) {
+      readPos = header->lastPos.load(std::memory_order_relaxed);
+      continue;
+    }
+
+    if (magic != RESULTS_MAGIC) {
+      readPos += capacity - offset;
+      continue;
+    }
+    if (size == 0) {
+      readPos = header->lastPos.load(std::memory_order_relaxed);
+      continue;
+    }
+    readPos += alignRecord(size);
+
+    ResultsHeader results;
+    memcpy(&results, record.data(), sizeof(results));
+    if ((lastSequence != 0) && (results.sequence > lastSequence + 1))
+      lost += results.sequence - lastSequence - 1;
+    lastSequence = results.sequence;
+    return true;
+  }
+}
@@ -0,0 +1,253 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "segmentation_kernel.hpp"
+
+#include <algorithm>
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define SEGMENTATION_KERNEL_NEON
+#endif
+
+#define SEGMENTATION_MAX_CLASSES    256
+
+
+/**
+ * @brief Exact division by 255 of a value up to 255 * 255.
+ */
+static inline uint8_t div255(uint32_t value)
+{
+  value += 128;
+  return (value + (value >> 8)) >> 8;
+}
+
+
+/**
+ * @brief Parameterized constructor.
+ *
+ * @param numClasses: number of classes in model output, background is class 0.
+ * @param maskWidth: width of model output.
+ * @param maskHeight: height of model output.
+ * @param alpha: opacity of the mask, between 0 and 1.
+ */
+SegmentationKernel::SegmentationKernel(const int &numClasses,
+                                       const int &maskWidth,
+                                       const int &maskHeight,
+                                       const float &alpha)
+    : numClasses(numClasses), maskWidth(maskWidth), maskHeight(maskHeight)
+{
+  if ((numClasses < 1) || (numClasses > SEGMENTATION_MAX_CLASSES)) {
+    log_error("Invalid number of classes for segmentation: %d\n", numClasses);
+    exit(-1);
+  }
+  if ((maskWidth <= 0) || (maskHeight <= 0)) {
+    log_error("Invalid segmentation mask dimension: %dx%d\n", maskWidth, maskHeight);
+    exit(-1);
+  }
+
+  // PASCAL VOC color map, stored as native endian ARGB32 cairo pixels
+  uint8_t opacity = static_cast<uint8_t>(std::clamp(alpha, 0.0f, 1.0f) * 255);
+  for (int label = 0; label < SEGMENTATION_MAX_CLASSES; label++) {
+    uint32_t r = 0, g = 0, b = 0;
+    int id = label;
+    for (int shift = 7; shift >= 0; shift--) {
+      r |= ((id >> 0) & 1) << shift;
+      g |= ((id >> 1) & 1) << shift;
+      b |= ((id >> 2) & 1) << shift;
+      id >>= 3;
+    }
+    palette[label] = (r << 16) | (g << 8) | b;
+    // Background is left untouched
+    paletteAlpha[label] = (label == 0) ? 0 : opacity;
+  }
+
+  labels.resize(maskWidth * maskHeight);
+  counts.resize(numClasses, 0);
+  publishedCounts.resize(numClasses, 0);
+}
+
+
+SegmentationKernel::~SegmentationKernel()
+{
+  if (pendingBuffer != nullptr)
+    gst_buffer_unref(pendingBuffer);
+  if (currentBuffer != nullptr)
+    gst_buffer_unref(currentBuffer);
+}
+
+
+/**
+ * @brief Hand over latest model output, the buffer is kept without copy
+ *        until the next one is drawn.
+ *
+ * @param buffer: tensor_sink output buffer.
+ */
+void SegmentationKernel::setBuffer(GstBuffer* buffer)
+{
+  gst_buffer_ref(buffer);
+  std::lock_guard<std::mutex> lock(bufferMutex);
+  if (pendingBuffer != nullptr)
+    gst_buffer_unref(pendingBuffer);
+  pendingBuffer = buffer;
+}
+
+
+/**
+ * @brief Compute labels of a mask row and accumulate class pixel counts.
+ *
+ * @param logits: model output, numClasses values per pixel.
+ * @param row: mask row index.
+ */
+void SegmentationKernel::computeRow(const float* logits, const int &row)
+{
+  const float* scores = logits + row * maskWidth * numClasses;
+  uint8_t* rowLabels = labels.data() + row * maskWidth;
+
+  for (int x = 0; x < maskWidth; x++, scores += numClasses) {
+    int best = 0;
+#ifdef SEGMENTATION_KERNEL_NEON
+    // Find max value with vector reduction, then its first index
+    int c = 0;
+    float32x4_t maxVec = vdupq_n_f32(scores[0]);
+    for (; c + 4 <= numClasses; c += 4)
+      maxVec = vmaxq_f32(maxVec, vld1q_f32(scores + c));
+    float maxValue = vmaxvq_f32(maxVec);
+    for (; c < numClasses; c++)
+      maxValue = std::max(maxValue, scores[c]);
+    while ((scores[best] != maxValue) && (best < numClasses - 1))
+      best++;
+#else
+    float maxValue = scores[0];
+    for (int c = 1; c < numClasses; c++) {
+      if (scores[c] > maxValue) {
+        maxValue = scores[c];
+        best = c;
+      }
+    }
+#endif
+    rowLabels[x] = best;
+    counts[best]++;
+  }
+}
+
+
+/**
+ * @brief Blend latest mask into a cairo ARGB32/RGB24 frame. Whole mask is
+ *        decoded once for each new model output, so that class counts do
+ *        not depend on display size, and upscaled to the frame size with
+ *        nearest neighbour while blending.
+ *
+ * @param frame: frame data.
+ * @param width: frame width.
+ * @param height: frame height.
+ * @param stride: frame stride in bytes.
+ */
+void SegmentationKernel::blend(uint8_t* frame,
+                               const int &width,
+                               const int &height,
+                               const int &stride)
+{
+  bool updated = false;
+  {
+    std::lock_guard<std::mutex> lock(bufferMutex);
+    if (pendingBuffer != nullptr) {
+      if (currentBuffer != nullptr)
+        gst_buffer_unref(currentBuffer);
+      currentBuffer = pendingBuffer;
+      pendingBuffer = nullptr;
+      updated = true;
+    }
+  }
+  if (currentBuffer == nullptr)
+    return;
+
+  GstMapInfo info;
+  GstMemory* memory = gst_buffer_peek_memory(currentBuffer, 0);
+  if (!gst_memory_map(memory, &info, GST_MAP_READ)) {
+    log_error("Can't access buffer in memory\n");
+    exit(-1);
+  }
+  if (info.size != maskWidth * maskHeight * numClasses * sizeof(float)) {
+    log_error("Unexpected segmentation output size: %zu\n", info.size);
+    exit(-1);
+  }
+  const float* logits = reinterpret_cast<const float*>(info.data);
+
+  if (updated == true) {
+    std::fill(counts.begin(), counts.end(), 0);
+    for (int row = 0; row < maskHeight; row++)
+      computeRow(logits, row);
+    std::lock_guard<std::mutex> lock(countsMutex);
+    publishedCounts = counts;
+  }
+
+  if (width != lastWidth) {
+    xIndex.resize(width);
+    for (int x = 0; x < width; x++)
+      xIndex[x] = x * maskWidth / width;
+    lastWidth = width;
+  }
+
+  for (int y = 0; y < height; y++) {
+    int row = y * maskHeight / height;
+    const uint8_t* rowLabels = labels.data() + row * maskWidth;
+    uint8_t* pixels = frame + y * stride;
+
+    int x = 0;
+#ifdef SEGMENTATION_KERNEL_NEON
+    for (; x + 8 <= width; x += 8) {
+      uint8_t blue[8], green[8], red[8], alpha[8];
+      uint8_t visible = 0;
+      for (int i = 0; i < 8; i++) {
+        uint8_t label = rowLabels[xIndex[x + i]];
+        uint32_t color = palette[label];
+        blue[i] = color;
+        green[i] = color >> 8;
+        red[i] = color >> 16;
+        alpha[i] = paletteAlpha[label];
+        visible |= alpha[i];
+      }
+      if (visible == 0)
+        continue;
+
+      uint8x8x4_t px = vld4_u8(pixels + 4 * x);
+      uint8x8_t a = vld1_u8(alpha);
+      uint8x8_t na = vmvn_u8(a);
+      uint8x8_t colors[3] = {vld1_u8(blue), vld1_u8(green), vld1_u8(red)};
+      for (int ch = 0; ch < 3; ch++) {
+        uint16x8_t acc = vmull_u8(px.val[ch], na);
+        acc = vmlal_u8(acc, colors[ch], a);
+        acc = vaddq_u16(acc, vdupq_n_u16(128));
+        px.val[ch] = vaddhn_u16(acc, vshrq_n_u16(acc, 8));
+      }
+      vst4_u8(pixels + 4 * x, px);
+    }
+#endif
+    for (; x < width; x++) {
+      uint8_t label = rowLabels[xIndex[x]];
+      uint32_t a = paletteAlpha[label];
+      if (a == 0)
+        continue;
+      uint32_t color = palette[label];
+      uint8_t* px = pixels + 4 * x;
+      px[0] = div255(px[0] * (255 - a) + (color & 0xff) * a);
+      px[1] = div255(px[1] * (255 - a) + ((color >> 8) & 0xff) * a);
+      px[2] = div255(px[2] * (255 - a) + ((color >> 16) & 0xff) * a);
+    }
+  }
+  gst_memory_unmap(memory, &info);
+}
+
+
+/**
+ * @brief Get pixel count of each class over the whole mask of the latest
+ *        model output.
+ */
+std::vector<int> SegmentationKernel::getClassPixelCounts()
+{
+  std::lock_guard<std::mutex> lock(countsMutex);
+  return publishedCounts;
+}
@@ -0,0 +1,232 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "ssd_box_decoder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+#define SSD_BOX_PRIORS_ROWS   4
+#define SSD_MAX_DETECTIONS    100
+
+
+/**
+ * @brief Parameterized constructor.
+ *
+ * @param option3: mobilenet-ssd options string, same layout as tensor_decoder
+ *                 option3 (boxesPath[:threshold:yScale:xScale:hScale:wScale:IOU]).
+ * @param labelsPath: model labels path.
+ * @param outWidth: width of the output coordinates space.
+ * @param outHeight: height of the output coordinates space.
+ */
+SSDBoxDecoder::SSDBoxDecoder(const std::string &option3,
+                             const std::filesystem::path &labelsPath,
+                             const int &outWidth,
+                             const int &outHeight)
+    : outWidth(outWidth), outHeight(outHeight)
+{
+  std::vector<std::string> fields;
+  std::stringstream stream(option3);
+  std::string field;
+  while (std::getline(stream, field, ':'))
+    fields.push_back(field);
+
+  if (fields.empty()) {
+    log_error("Box priors path is needed for mobilenet-ssd decoder\n");
+    exit(-1);
+  }
+
+  float* params[] = {&threshold, &yScale, &xScale, &hScale, &wScale, &iouThreshold};
+  for (int i = 1; (i < fields.size()) && (i <= 6); i++)
+    *params[i - 1] = std::stof(fields.at(i));
+
+  // sigmoid(x) >= threshold <=> x >= log(threshold / (1 - threshold))
+  logitThreshold = std::log(threshold / (1.0f - threshold));
+
+  loadPriors(fields.at(0));
+  loadLabels(labelsPath);
+  candidates.reserve(numAnchors);
+}
+
+
+/**
+ * @brief Load box priors file into the packed priors table.
+ *
+ * @param boxesPath: box priors path, 4 lines of ycenter, xcenter, h and w.
+ */
+void SSDBoxDecoder::loadPriors(const std::filesystem::path &boxesPath)
+{
+  std::ifstream file(boxesPath);
+  if (!file) {
+    log_error("Unable to open box priors file %s\n", boxesPath.c_str());
+    exit(-1);
+  }
+
+  std::vector<std::vector<float>> rows;
+  std::string line;
+  while (std::getline(file, line) && (rows.size() < SSD_BOX_PRIORS_ROWS)) {
+    std::vector<float> row;
+    std::stringstream stream(line);
+    float value;
+    while (stream >> value)
+      row.push_back(value);
+    if (!row.empty())
+      rows.push_back(row);
+  }
+
+  if ((rows.size() != SSD_BOX_PRIORS_ROWS)
+      || rows.at(0).empty()
+      || (rows.at(0).size() != rows.at(1).size())
+      || (rows.at(0).size() != rows.at(2).size())
+      || (rows.at(0).size() != rows.at(3).size())) {
+    log_error("Invalid box priors file %s\n", boxesPath.c_str());
+    exit(-1);
+  }
+
+  numAnchors = rows.at(0).size();
+  priors.resize(SSD_BOX_PRIORS_ROWS * numAnchors);
+  for (int row = 0; row < SSD_BOX_PRIORS_ROWS; row++)
+    std::copy(rows.at(row).begin(), rows.at(row).end(), priors.begin() + row * numAnchors);
+}
+
+
+/**
+ * @brief Load labels file, one label per line.
+ *
+ * @param labelsPath: model labels path.
+ */
+void SSDBoxDecoder::loadLabels(const std::filesystem::path &labelsPath)
+{
+  std::ifstream file(labelsPath);
+  if (!file) {
+    log_error("Unable to open labels file %s\n", labelsPath.c_str());
+    exit(-1);
+  }
+
+  std::string line;
+  while (std::getline(file, line))
+    labels.push_back(line);
+}
+
+
+/**
+ * @brief Get label of a class.
+ *
+ * @param classId: class index.
+ * @return label, or an empty string if the index is out of range.
+ */
+std::string SSDBoxDecoder::getLabel(const int &classId) const
+{
+  if ((classId < 0) || (classId >= labels.size()))
+    return "";
+  return labels.at(classId);
+}
+
+
+/**
+ * @brief Remove overlapping boxes, keeping the highest score.
+ *
+ * @param boxes: decoded boxes, sorted by descending score on return.
+ */
+void SSDBoxDecoder::nonMaximumSuppression(std::vector<DetectedBox> &boxes)
+{
+  std::sort(boxes.begin(), boxes.end(),
+            [](const DetectedBox &a, const DetectedBox &b) { return a.score > b.score; });
+
+  int kept = 0;
+  for (int i = 0; (i < boxes.size()) && (kept < SSD_MAX_DETECTIONS); i++) {
+    const DetectedBox &box = boxes.at(i);
+    float area = (box.x2 - box.x1) * (box.y2 - box.y1);
+    bool valid = true;
+    for (int j = 0; j < kept; j++) {
+      const DetectedBox &ref = boxes.at(j);
+      float w = std::min(box.x2, ref.x2) - std::max(box.x1, ref.x1);
+      float h = std::min(box.y2, ref.y2) - std::max(box.y1, ref.y1);
+      if ((w <= 0) || (h <= 0))
+        continue;
+      float inter = w * h;
+      float refArea = (ref.x2 - ref.x1) * (ref.y2 - ref.y1);
+      if (inter / (area + refArea - inter) > iouThreshold) {
+        valid = false;
+        break;
+      }
+    }
+    if (valid)
+      boxes.at(kept++) = box;
+  }
+  boxes.resize(kept);
+}
+
+
+/**
+ * @brief Decode raw MobileNet-SSD output into boxes.
+ *
+ * @param locations: box encodings, 4 values per anchor.
+ * @param locationsSize: number of values in locations tensor.
+ * @param scores: class logits, numClasses values per anchor.
+ * @param scoresSize: number of values in scores tensor.
+ * @param boxes: decoded boxes after non-maximum suppression.
+ */
+void SSDBoxDecoder::decode(const float* locations,
+                           const int &locationsSize,
+                           const float* scores,
+                           const int &scoresSize,
+                           std::vector<DetectedBox> &boxes)
+{
+  // Model outputs must match priors file
+  if (locationsSize != numAnchors * SSD_BOX_PRIORS_ROWS) {
+    log_error("Invalid box locations size: %d, expected %d for %d priors\n",
+              locationsSize, numAnchors * SSD_BOX_PRIORS_ROWS, numAnchors);
+    exit(-1);
+  }
+  if ((scoresSize % numAnchors != 0) || (scoresSize / numAnchors < 2)) {
+    log_error("Invalid scores size: %d, expected background and at least one "
+              "class for %d priors\n", scoresSize, numAnchors);
+    exit(-1);
+  }
+  numClasses = scoresSize / numAnchors;
+
+  const float* priorY = priors.data();
+  const float* priorX = priorY + numAnchors;
+  const float* priorH = priorX + numAnchors;
+  const float* priorW = priorH + numAnchors;
+
+  candidates.clear();
+  for (int d = 0; d < numAnchors; d++) {
+    // Class 0 is background
+    const float* logits = scores + d * numClasses;
+    float maxLogit = logits[1];
+    for (int c = 2; c < numClasses; c++)
+      maxLogit = std::max(maxLogit, logits[c]);
+    if (maxLogit < logitThreshold)
+      continue;
+
+    const float* loc = locations + d * SSD_BOX_PRIORS_ROWS;
+    float yCenter = loc[0] / yScale * priorH[d] + priorY[d];
+    float xCenter = loc[1] / xScale * priorW[d] + priorX[d];
+    float h = std::exp(loc[2] / hScale) * priorH[d];
+    float w = std::exp(loc[3] / wScale) * priorW[d];
+
+    // Letterbox padding is removed before clamping to the frame
+    DetectedBox box;
+    box.x1 = std::clamp(letterboxToFrameX(letterbox, xCenter - w / 2), 0.0f, 1.0f) * outWidth;
+    box.y1 = std::clamp(letterboxToFrameY(letterbox, yCenter - h / 2), 0.0f, 1.0f) * outHeight;
+    box.x2 = std::clamp(letterboxToFrameX(letterbox, xCenter + w / 2), 0.0f, 1.0f) * outWidth;
+    box.y2 = std::clamp(letterboxToFrameY(letterbox, yCenter + h / 2), 0.0f, 1.0f) * outHeight;
+
+    for (int c = 1; c < numClasses; c++) {
+      if (logits[c] < logitThreshold)
+        continue;
+      box.score = 1.0f / (1.0f + std::exp(-logits[c]));
+      box.classId = c;
+      candidates.push_back(box);
+    }
+  }
+
+  nonMaximumSuppression(candidates);
+  boxes.assign(candidates.begin(), candidates.end());
+}
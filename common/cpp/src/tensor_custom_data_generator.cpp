@@ -1,5 +1,5 @@
 /**
- * Copyright 2024-2025 NXP
+ * Copyright 2024-2026 NXP
  * SPDX-License-Identifier: BSD-3-Clause 
  */
 
@@ -129,4 +129,62 @@ std::string TensorCustomGenerator::setTensorTransformConfig(const std::string &n
       break;
   }
   return tensorTransformCustom;
-}
\ No newline at end of file
+}
+
+
+/**
+ * @brief Add elements for affine normalization to pipeline: value =
+ *        pixel * mul + add for each channel, rounded and clamped for
+ *        uint8 and int8 model inputs.
+ *
+ * @param mul: multiplier of each channel.
+ * @param add: offset of each channel.
+ * @param channels: number of channels.
+ * @param type: model input type, uint8, int8 or float32.
+ * @param pipeline: GstPipelineImx pipeline.
+ */
+std::string TensorCustomGenerator::setAffineTransformConfig(const float mul[],
+                                                            const float add[],
+                                                            const int &channels,
+                                                            const std::string &type,
+                                                            GstPipelineImx &pipeline)
+{
+  bool quantized = (type != "float32");
+  // Values are computed as uint8 for int8 input, then shifted
+  float bias = quantized ? 0.5f : 0.0f;
+  if (type == "int8")
+    bias += 128.0f;
+
+  bool perChannel = false;
+  for (int c = 1; c < channels; c++)
+    perChannel = perChannel || (mul[c] != mul[0]) || (add[c] != add[0]);
+
+  std::string option = "option=typecast:float32";
+  if (perChannel) {
+    option += ",per-channel:true@0";
+    for (int c = 0; c < channels; c++)
+      option += ",mul:" + std::to_string(mul[c]) + "@" + std::to_string(c);
+    for (int c = 0; c < channels; c++)
+      option += ",add:" + std::to_string(add[c] + bias) + "@" + std::to_string(c);
+  } else {
+    option += ",mul:" + std::to_string(mul[0]);
+    option += ",add:" + std::to_string(add[0] + bias);
+  }
+
+  std::string name = "name=tensor_preprocess_affine_normalization_"
+                     + std::to_string(pipeline.elemNameCount) + " ";
+  pipeline.elemNameCount += 1;
+  std::string tensorTransformCustom = "tensor_transform mode=arithmetic ";
+  tensorTransformCustom += name;
+  tensorTransformCustom += option + " ! ";
+  if (quantized) {
+    tensorTransformCustom += "tensor_transform mode=clamp option=0:255 ! ";
+    tensorTransformCustom += "tensor_transform mode=typecast option=uint8 ! ";
+  }
+  if (type == "int8") {
+    tensorTransformCustom += "tensor_transform mode=arithmetic ";
+    tensorTransformCustom += "option=typecast:int16,add:-128 ! ";
+    tensorTransformCustom += "tensor_transform mode=typecast option=int8 ! ";
+  }
+  return tensorTransformCustom;
+}
@@ -0,0 +1,435 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "tensor_record.hpp"
+#include "logging.hpp"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+/**
+ * @brief Round size up to record alignment.
+ */
+static uint64_t alignSize(const uint64_t &size)
+{
+  return (size + TENSOR_RECORD_ALIGNMENT - 1) & ~static_cast<uint64_t>(TENSOR_RECORD_ALIGNMENT - 1);
+}
+
+
+/**
+ * @brief Write zeros until file offset is aligned.
+ */
+static void writePadding(FILE* file, const uint64_t &size)
+{
+  static const uint8_t zeros[TENSOR_RECORD_ALIGNMENT] = {};
+  uint64_t padding = alignSize(size) - size;
+  if (padding > 0)
+    fwrite(zeros, 1, padding, file);
+}
+
+
+/**
+ * @brief Parameterized constructor, open recording file and start writer
+ *        thread. Records are appended to an existing recording.
+ *
+ * @param path: recording file path.
+ */
+TensorRecorder::TensorRecorder(const std::string &path) : path(path)
+{
+  file = fopen(path.c_str(), "a+b");
+  if (file == nullptr) {
+    log_error("Could not open recording %s\n", path.c_str());
+    exit(-1);
+  }
+
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  if (size == 0) {
+    TensorRecordFileHeader header = {};
+    memcpy(header.magic, TENSOR_RECORD_MAGIC, sizeof(header.magic));
+    header.version = TENSOR_RECORD_VERSION;
+    header.alignment = TENSOR_RECORD_ALIGNMENT;
+    fwrite(&header, sizeof(header), 1, file);
+  } else {
+    TensorRecordFileHeader header;
+    rewind(file);
+    if ((fread(&header, sizeof(header), 1, file) != 1)
+        || (memcmp(header.magic, TENSOR_RECORD_MAGIC, sizeof(header.magic)) != 0)
+        || (header.version != TENSOR_RECORD_VERSION)
+        || (size % TENSOR_RECORD_ALIGNMENT != 0)) {
+      log_error("%s is not a valid recording, or its last record is truncated\n", path.c_str());
+      exit(-1);
+    }
+  }
+  worker = std::thread(&TensorRecorder::run, this);
+}
+
+
+TensorRecorder::~TensorRecorder()
+{
+  {
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    running = false;
+  }
+  pendingCondition.notify_one();
+  if (worker.joinable())
+    worker.join();
+
+  if (lastCaps != nullptr)
+    gst_caps_unref(lastCaps);
+  fclose(file);
+  log_info("%lu buffers recorded in %s\n", (unsigned long) numRecords.load(), path.c_str());
+}
+
+
+/**
+ * @brief Record buffers of a tensor_sink, next to its other new-data
+ *        callbacks. Pipeline must be parsed.
+ *
+ * @param pipeline: GstPipelineImx pipeline.
+ * @param gstName: name of tensor_sink element.
+ */
+void TensorRecorder::connectToTensorSink(GstPipelineImx &pipeline,
+                                         const std::string &gstName)
+{
+  pipeline.connectToElementSignal(gstName, newDataCallback, "new-data", this);
+}
+
+
+/**
+ * @brief Queue buffer and its caps for writer thread.
+ *
+ * @param element: tensor_sink element.
+ * @param buffer: tensors buffer.
+ * @param user_data: TensorRecorder.
+ */
+void TensorRecorder::newDataCallback(GstElement* element,
+                                     GstBuffer* buffer,
+                                     gpointer user_data)
+{
+  TensorRecorder* recorder = (TensorRecorder *) user_data;
+  GstPad* pad = gst_element_get_static_pad(element, "sink");
+  GstCaps* caps = gst_pad_get_current_caps(pad);
+  gst_object_unref(pad);
+
+  std::unique_lock<std::mutex> lock(recorder->pendingMutex);
+  if (recorder->pending.size() >= TENSOR_RECORD_MAX_PENDING) {
+    lock.unlock();
+    if (caps != nullptr)
+      gst_caps_unref(caps);
+    log_error("Recording too slow, buffer dropped from %s\n", recorder->path.c_str());
+    return;
+  }
+  recorder->pending.push_back({gst_buffer_ref(buffer), caps});
+  lock.unlock();
+  recorder->pendingCondition.notify_one();
+}
+
+
+/**
+ * @brief Append a record to the file.
+ *
+ * @param data: buffer and caps to record.
+ */
+void TensorRecorder::write(const PendingBuffer &data)
+{
+  guint numTensors = gst_buffer_n_memory(data.buffer);
+  if (numTensors > TENSOR_RECORD_MAX_TENSORS) {
+    log_error("Could not record %u tensors, %d at most\n", numTensors, TENSOR_RECORD_MAX_TENSORS);
+    return;
+  }
+
+  gchar* capsString = nullptr;
+  if ((data.caps != nullptr)
+      && ((lastCaps == nullptr) || !gst_caps_is_equal(data.caps, lastCaps))) {
+    capsString = gst_caps_to_string(data.caps);
+    if (lastCaps != nullptr)
+      gst_caps_unref(lastCaps);
+    lastCaps = gst_caps_ref(data.caps);
+  }
+
+  TensorRecordEntry entry = {};
+  entry.pts = GST_BUFFER_PTS(data.buffer);
+  entry.duration = GST_BUFFER_DURATION(data.buffer);
+  entry.capsSize = (capsString != nullptr) ? strlen(capsString) + 1 : 0;
+  entry.numTensors = numTensors;
+  entry.recordSize = alignSize(sizeof(entry) + entry.capsSize);
+  for (guint i = 0; i < numTensors; i++) {
+    entry.tensorSizes[i] = gst_memory_get_sizes(gst_buffer_peek_memory(data.buffer, i), NULL, NULL);
+    entry.recordSize += alignSize(entry.tensorSizes[i]);
+  }
+
+  fwrite(&entry, sizeof(entry), 1, file);
+  if (capsString != nullptr) {
+    fwrite(capsString, 1, entry.capsSize, file);
+    g_free(capsString);
+  }
+  writePadding(file, sizeof(entry) + entry.capsSize);
+
+  for (guint i = 0; i < numTensors; i++) {
+    GstMapInfo info;
+    GstMemory* memory = gst_buffer_peek_memory(data.buffer, i);
+    if (gst_memory_map(memory, &info, GST_MAP_READ)) {
+      fwrite(info.data, 1, info.size, file);
+      gst_memory_unmap(memory, &info);
+    } else {
+      log_error("Could not map tensor %u, recorded as zeros\n", i);
+      std::vector<uint8_t> zeros(entry.tensorSizes[i]);
+      fwrite(zeros.data(), 1, zeros.size(), file);
+    }
+    writePadding(file, entry.tensorSizes[i]);
+  }
+  numRecords += 1;
+}
+
+
+/**
+ * @brief Writer thread, flush file after each batch of buffers so that
+ *        a recording stays usable if application is killed.
+ */
+void TensorRecorder::run()
+{
+  std::deque<PendingBuffer> batch;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(pendingMutex);
+      pendingCondition.wait(lock, [this] { return !pending.empty() || !running; });
+      if (pending.empty() && !running)
+        break;
+      batch.swap(pending);
+    }
+
+    for (const PendingBuffer &data : batch) {
+      write(data);
+      gst_buffer_unref(data.buffer);
+      if (data.caps != nullptr)
+        gst_caps_unref(data.caps);
+    }
+    batch.clear();
+    fflush(file);
+  }
+}
+
+
+/**
+ * @brief Parameterized constructor, map recording and index its records.
+ *        A truncated last record is ignored.
+ *
+ * @param path: recording file path.
+ */
+TensorReplay::TensorReplay(const std::string &path) : path(path)
+{
+  int fd = open(path.c_str(), O_RDONLY);
+  struct stat st;
+  if ((fd < 0) || (fstat(fd, &st) != 0)) {
+    log_error("Could not open recording %s\n", path.c_str());
+    exit(-1);
+  }
+  dataSize = st.st_size;
+  if (dataSize >= sizeof(TensorRecordFileHeader))
+    data = static_cast<uint8_t*>(mmap(NULL, dataSize, PROT_READ, MAP_PRIVATE, fd, 0));
+  close(fd);
+
+  const TensorRecordFileHeader* header = reinterpret_cast<const TensorRecordFileHeader*>(data);
+  if ((data == nullptr) || (data == MAP_FAILED)
+      || (memcmp(header->magic, TENSOR_RECORD_MAGIC, sizeof(header->magic)) != 0)
+      || (header->version != TENSOR_RECORD_VERSION)) {
+    log_error("%s is not a valid recording\n", path.c_str());
+    exit(-1);
+  }
+
+  size_t offset = sizeof(TensorRecordFileHeader);
+  while (offset + sizeof(TensorRecordEntry) <= dataSize) {
+    const TensorRecordEntry* entry = reinterpret_cast<const TensorRecordEntry*>(data + offset);
+    if ((entry->recordSize > dataSize - offset)
+        || (entry->numTensors > TENSOR_RECORD_MAX_TENSORS)) {
+      log_error("%s: truncated record ignored\n", path.c_str());
+      break;
+    }
+
+    Record record;
+    record.entry = entry;
+    if (entry->capsSize > 0) {
+      capsList.push_back(reinterpret_cast<const char*>(entry + 1));
+    } else if (capsList.empty()) {
+      capsList.push_back("");
+    }
+    record.capsIndex = capsList.size() - 1;
+
+    uint64_t tensorOffset = offset + alignSize(sizeof(TensorRecordEntry) + entry->capsSize);
+    for (uint32_t i = 0; i < entry->numTensors; i++) {
+      record.tensors[i] = data + tensorOffset;
+      tensorOffset += alignSize(entry->tensorSizes[i]);
+    }
+    records.push_back(record);
+    offset += entry->recordSize;
+  }
+  log_info("%zu buffers in %s\n", records.size(), path.c_str());
+}
+
+
+TensorReplay::~TensorReplay()
+{
+  if (data != nullptr)
+    munmap(data, dataSize);
+}
+
+
+/**
+ * @brief Get caps of a record.
+ *
+ * @param index: record index.
+ * @return caps string, as given by gst_caps_to_string.
+ */
+const std::string& TensorReplay::getCaps(const size_t &index) const
+{
+  return capsList[records[index].capsIndex];
+}
+
+
+/**
+ * @brief Create a buffer wrapping recorded tensors, without copy.
+ *
+ * @param index: record index.
+ * @return read-only buffer, valid as long as the replay.
+ */
+GstBuffer* TensorReplay::getBuffer(const size_t &index) const
+{
+  const Record &record = records[index];
+  GstBuffer* buffer = gst_buffer_new();
+  for (uint32_t i = 0; i < record.entry->numTensors; i++) {
+    gsize size = record.entry->tensorSizes[i];
+    gst_buffer_append_memory(buffer,
+                             gst_memory_new_wrapped(GST_MEMORY_FLAG_READONLY,
+                                                    (gpointer) record.tensors[i],
+                                                    size, 0, size, NULL, NULL));
+  }
+  GST_BUFFER_PTS(buffer) = record.entry->pts;
+  GST_BUFFER_DURATION(buffer) = record.entry->duration;
+  return buffer;
+}
+
+
+/**
+ * @brief Wait until a record is due, relative to the first one.
+ *
+ * @param index: record index.
+ * @param start: time the first record was replayed.
+ */
+void TensorReplay::waitForRecord(const size_t &index,
+                                 const std::chrono::steady_clock::time_point &start) const
+{
+  GstClockTime first = records[0].entry->pts;
+  GstClockTime pts = records[index].entry->pts;
+  if (GST_CLOCK_TIME_IS_VALID(first) && GST_CLOCK_TIME_IS_VALID(pts) && (pts > first))
+    std::this_thread::sleep_until(start + std::chrono::nanoseconds(pts - first));
+}
+
+
+/**
+ * @brief Feed all records to a tensor_sink new-data callback, e.g. a
+ *        custom decoder, from the calling thread.
+ *
+ * @param callback: new-data callback, called with a NULL element.
+ * @param userData: callback data.
+ * @param realTime: replay at recorded timing, or at maximum speed.
+ */
+void TensorReplay::replay(void (*callback)(GstElement*, GstBuffer*, gpointer),
+                          gpointer userData,
+                          const bool &realTime)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < records.size(); i++) {
+    if (realTime)
+      waitForRecord(i, start);
+    GstBuffer* buffer = getBuffer(i);
+    callback(NULL, buffer, userData);
+    gst_buffer_unref(buffer);
+  }
+}
+
+
+/**
+ * @brief Add an appsrc replaying recorded tensors, in place of the
+ *        tensor_filter output in a pipeline.
+ *
+ * @param pipeline: GstPipelineImx pipeline.
+ * @param gstName: name of appsrc element.
+ * @param realTime: replay at recorded timing, or at maximum speed.
+ */
+void TensorReplay::addReplayToPipeline(GstPipelineImx &pipeline,
+                                       const std::string &gstName,
+                                       const bool &realTime)
+{
+  if (records.empty()) {
+    log_error("Nothing to replay in %s\n", path.c_str());
+    exit(-1);
+  }
+  this->gstName = gstName;
+  this->realTime = realTime;
+  pipeline.addToPipeline("appsrc name=" + gstName
+                         + " format=time emit-signals=true max-buffers=2 block=true"
+                         + " caps=\"" + getCaps(0) + "\" ! ");
+}
+
+
+/**
+ * @brief Connect appsrc added by addReplayToPipeline. Pipeline must be parsed.
+ *
+ * @param pipeline: GstPipelineImx pipeline.
+ */
+void TensorReplay::connectReplay(GstPipelineImx &pipeline)
+{
+  nextRecord = 0;
+  lastCapsIndex = 0;
+  pipeline.connectToElementSignal(gstName, needDataCallback, "need-data", this);
+}
+
+
+/**
+ * @brief Push next record when appsrc queue runs low, end the stream
+ *        after last record. Timestamps start from zero.
+ *
+ * @param appsrc: appsrc element.
+ * @param length: amount of bytes needed, unused.
+ * @param user_data: TensorReplay.
+ */
+void TensorReplay::needDataCallback(GstElement* appsrc,
+                                    guint length,
+                                    gpointer user_data)
+{
+  TensorReplay* replay = (TensorReplay *) user_data;
+  GstFlowReturn ret;
+  if (replay->nextRecord >= replay->records.size()) {
+    g_signal_emit_by_name(appsrc, "end-of-stream", &ret);
+    return;
+  }
+
+  size_t index = replay->nextRecord++;
+  if (index == 0)
+    replay->startTime = std::chrono::steady_clock::now();
+  else if (replay->realTime)
+    replay->waitForRecord(index, replay->startTime);
+
+  const Record &record = replay->records[index];
+  if (record.capsIndex != replay->lastCapsIndex) {
+    GstCaps* caps = gst_caps_from_string(replay->capsList[record.capsIndex].c_str());
+    g_object_set(appsrc, "caps", caps, NULL);
+    gst_caps_unref(caps);
+    replay->lastCapsIndex = record.capsIndex;
+  }
+
+  GstBuffer* buffer = replay->getBuffer(index);
+  GstClockTime first = replay->records[0].entry->pts;
+  if (GST_CLOCK_TIME_IS_VALID(first) && GST_CLOCK_TIME_IS_VALID(record.entry->pts)
+      && (record.entry->pts >= first))
+    GST_BUFFER_PTS(buffer) = record.entry->pts - first;
+  g_signal_emit_by_name(appsrc, "push-buffer", buffer, &ret);
+  gst_buffer_unref(buffer);
+}
@@ -1,5 +1,5 @@
 /**
- * Copyright 2024-2025 NXP
+ * Copyright 2024-2026 NXP
  * SPDX-License-Identifier: BSD-3-Clause 
  */ 
 
@@ -13,11 +13,16 @@
  *             |                                                                              textoverlay -- waylandsink
  *             |                                                                                     |
  *             --- imxvideoconvert -- tensor_converter -- tensor_transform -- tensor_filter -- tensor_decoder
+ *
+ * Image batch pipeline, JPEG images are decoded and resized by a thread pool:
+ * appsrc -- tensor_converter -- tensor_transform -- tensor_filter -- tensor_sink
  */
 
 #include "common.hpp"
 
 #include <iostream>
+#include <fstream>
+#include <chrono>
 #include <getopt.h>
 #include <algorithm>
 
@@ -40,6 +45,10 @@ typedef struct {
   int camWidth;
   int camHeight;
   int framerate;
+  std::filesystem::path imageDir;
+  std::filesystem::path outputDir;
+  bool realTime;
+  bool autotune;
 } ParserOptions;
 
 
@@ -63,12 +72,16 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
     {"text_color",    required_argument, 0, 't'},
     {"graph_path",    required_argument, 0, 'g'},
     {"cam_params",    required_argument, 0, 'r'},
+    {"image_dir",     required_argument, 0, 'i'},
+    {"output_dir",    required_argument, 0, 'o'},
+    {"real_time",     no_argument,       0, 's'},
+    {"autotune",      no_argument,       0, 'a'},
     {0,               0,                 0,   0}
   };
   
   while ((c = getopt_long(argc,
                           argv,
-                          "hb:n:c:p:f:l:d::t:g:r:",
+                          "hb:n:c:p:f:l:d::t:g:r:i:o:sa",
                           longOptions,
                           &optionIndex)) != -1) {
     switch (c)
@@ -82,7 +95,7 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
 
                   << std::setw(25) << std::left << "  -b, --backend"
                   << std::setw(25) << std::left
-                  << "Use the selected backend (CPU,GPU,NPU)" << std::endl
+                  << "Use the selected backend (CPU,GPU,NPU,auto)" << std::endl
 
                   << std::setw(25) << std::left << "  -n, --normalization"
                   << std::setw(25) << std::left
@@ -121,7 +134,24 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
 
                   << std::setw(25) << std::left << "  -r, --cam_params"
                   << std::setw(25) << std::left
-                  << "Use the selected camera resolution and framerate" << std::endl;
+                  << "Use the selected camera resolution and framerate" << std::endl
+
+                  << std::setw(25) << std::left << "  -i, --image_dir"
+                  << std::setw(25) << std::left
+                  << "Classify all JPEG images of this directory as fast as possible" << std::endl
+
+                  << std::setw(25) << std::left << "  -o, --output_dir"
+                  << std::setw(25) << std::left
+                  << "Directory of image batch results, classifications.jsonl"
+                  << " (current directory by default)" << std::endl
+
+                  << std::setw(25) << std::left << "  -s, --real_time"
+                  << std::setw(25) << std::left
+                  << "Run camera and inference threads with real-time scheduling" << std::endl
+
+                  << std::setw(25) << std::left << "  -a, --autotune"
+                  << std::setw(25) << std::left
+                  << "Tune queue depths from their occupancy, and log converged settings" << std::endl;
         return 1;
 
       case 'b':
@@ -185,6 +215,22 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
         options.framerate = std::stoi(temp.substr(temp.find(",")+1));
         break;
 
+      case 'i':
+        options.imageDir.assign(optarg);
+        break;
+
+      case 'o':
+        options.outputDir.assign(optarg);
+        break;
+
+      case 's':
+        options.realTime = true;
+        break;
+
+      case 'a':
+        options.autotune = true;
+        break;
+
       default:
         break;
     }
@@ -193,6 +239,122 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
 }
 
 
+/**
+ * @brief Classifications of an image batch.
+ */
+typedef struct {
+  GstImageBatchImx* batch;
+  std::vector<std::string> labels;
+  std::ofstream file;
+  uint64_t numImages = 0;
+} BatchResults;
+
+
+/**
+ * @brief Write a JSON line per image with best class. Output is uint8
+ *        scores for quantized models, float32 otherwise.
+ */
+void batchResultsCallback(GstElement* element,
+                          GstBuffer* buffer,
+                          gpointer user_data)
+{
+  BatchResults* results = (BatchResults *) user_data;
+  GstMapInfo info;
+  GstMemory* memory = gst_buffer_peek_memory(buffer, 0);
+  if (!gst_memory_map(memory, &info, GST_MAP_READ)) {
+    log_error("Can't access buffer in memory\n");
+    exit(-1);
+  }
+
+  size_t numClasses = results->labels.size();
+  size_t best = 0;
+  float score = 0;
+  if (info.size == numClasses) {
+    const uint8_t* scores = info.data;
+    best = std::max_element(scores, scores + numClasses) - scores;
+    score = scores[best] / 255.0f;
+  } else if (info.size == numClasses * sizeof(float)) {
+    const float* scores = reinterpret_cast<const float*>(info.data);
+    best = std::max_element(scores, scores + numClasses) - scores;
+    score = scores[best];
+  } else {
+    log_error("Output size %zu does not match %zu labels\n", info.size, numClasses);
+    exit(-1);
+  }
+  gst_memory_unmap(memory, &info);
+
+  std::string image = results->batch->getImagePath(GST_BUFFER_PTS(buffer)).string();
+  results->file << "{\"image\": " << toJsonString(image)
+                << ", \"label\": " << toJsonString(results->labels[best])
+                << ", \"score\": " << score << "}\n";
+  results->numImages += 1;
+}
+
+
+/**
+ * @brief Classify all images of a directory as fast as possible, and write
+ *        one JSON line per image in <output directory>/classifications.jsonl.
+ *
+ * @param options: parsed options.
+ */
+int runImageBatch(const ParserOptions &options)
+{
+  BatchResults results;
+  std::ifstream labelsFile(options.dataDir.labelsDir);
+  std::string label;
+  while (std::getline(labelsFile, label))
+    results.labels.push_back(label);
+  if (results.labels.empty()) {
+    log_error("Could not read labels from %s\n", options.dataDir.labelsDir.c_str());
+    return 1;
+  }
+
+  std::error_code error;
+  if (!options.outputDir.empty())
+    std::filesystem::create_directories(options.outputDir, error);
+  if (error) {
+    log_error("Could not create %s\n", options.outputDir.c_str());
+    return 1;
+  }
+
+  GstPipelineImx pipeline;
+  pipeline.setOffline(true);
+
+  // Images are decoded at model resolution, inference needs no conversion
+  TFliteModelInfos classification(options.modelPath, options.backend, options.norm);
+  GstImageBatchImx batch(options.imageDir,
+                         classification.getModelWidth(),
+                         classification.getModelHeight());
+  batch.addImageBatchToPipeline(pipeline);
+  classification.addInferenceToPipeline(pipeline, "", "");
+
+  std::string tensorSinkName = "classification_sink";
+  pipeline.addTensorSink(tensorSinkName);
+  pipeline.parse(options.graphPath);
+
+  results.batch = &batch;
+  results.file.open(options.outputDir / "classifications.jsonl");
+  if (!results.file.is_open()) {
+    log_error("Could not open %s\n", (options.outputDir / "classifications.jsonl").c_str());
+    return 1;
+  }
+  pipeline.connectToElementSignal(tensorSinkName, batchResultsCallback, "new-data", &results);
+  batch.connectImageBatch(pipeline);
+
+  auto start = std::chrono::steady_clock::now();
+  if (!pipeline.runToCompletion()) {
+    log_error("Processing of %s failed\n", options.imageDir.c_str());
+    return 1;
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  log_info("Processed %lu images in %.1f s, %.1f images/s\n",
+           static_cast<unsigned long>(results.numImages),
+           seconds,
+           (seconds > 0) ? results.numImages / seconds : 0.0);
+  return (results.numImages > 0) ? 0 : 1;
+}
+
+
 int main(int argc, char **argv)
 {
   // Initialize command line parser with default values
@@ -204,9 +366,14 @@ int main(int argc, char **argv)
   options.camWidth = 640;
   options.camHeight = 480;
   options.framerate = 30;
+  options.realTime = false;
+  options.autotune = false;
   if (cmdParser(argc, argv, options))
     return 0;
 
+  if (!options.imageDir.empty())
+    return runImageBatch(options);
+
   // Initialize pipeline object
   GstPipelineImx pipeline;
 
@@ -225,6 +392,15 @@ int main(int argc, char **argv)
     };
     GstCameraImx camera(camOpt);
     camera.addCameraToPipeline(pipeline);
+
+    // Capture first, so frames are not late when the system is loaded
+    if (options.realTime) {
+      ThreadScheduling captureScheduling = {
+        .policy   = SchedPolicy::fifo,
+        .priority = 20,
+      };
+      pipeline.setThreadScheduling(camOpt.gstName, captureScheduling);
+    }
   } else {
     // Add video to pipeline
     GstVideoFileImx video(options.videoPath, false);
@@ -241,6 +417,13 @@ int main(int argc, char **argv)
     .maxSizeBuffer = 2,
     .leakType      = GstQueueLeaky::downstream,
   };
+  // Inference before display, round robin with other real-time threads
+  if (options.realTime) {
+    nnQueue.scheduling = {
+      .policy   = SchedPolicy::rr,
+      .priority = 10,
+    };
+  }
   pipeline.addBranch(teeName, nnQueue);
 
   // Add model inference
@@ -281,8 +464,19 @@ int main(int argc, char **argv)
   // Parse pipeline to GStreamer pipeline
   pipeline.parse(options.graphPath);
 
+  // Tune queues from their occupancy, starting from their settings
+  QueueAutotuner autotuner;
+  if (options.autotune) {
+    autotuner.addQueue({.queueName = nnQueue.queueName});
+    autotuner.addQueue({.queueName = imgQueue.queueName});
+    autotuner.attach(pipeline);
+  }
+
   // Run GStreamer pipeline
   pipeline.run();
 
+  if (options.autotune)
+    autotuner.logSettings();
+
   return 0;
 }
\ No newline at end of file
@@ -1,5 +1,5 @@
 /**
- * Copyright 2024-2025 NXP
+ * Copyright 2024-2026 NXP
  * SPDX-License-Identifier: BSD-3-Clause 
  */ 
 
@@ -63,7 +63,9 @@ void newDataCallback(GstElement *element,
   bufferInfo = getTensorInfo(buffer, 0);
   assert(boxesData->bufferSize == bufferInfo.size);
 
-  std::vector<int> boxes;
+  // Reuse buffer owned by this thread, it is only read once published
+  std::vector<int> &boxes = boxesData->faceBoxes.writeBuffer();
+  boxes.clear();
   int faceCount = 0;
   for (int i = 0; ((i < MODEL_UFACE_NUMBER_BOXES)
                    && (faceCount < MODEL_UFACE_NUMBER_MAX)); i+= NUM_BOX_DATA) {
@@ -121,7 +123,7 @@ void newDataCallback(GstElement *element,
     boxes.at(3 + faceIndex) = cy + d2;
   }
 
-  boxesData->faceBoxes = boxes;
+  boxesData->faceBoxes.publish();
 }
 
 
@@ -184,8 +186,10 @@ void getEmotionResult(GstBuffer *buffer,
   data.box[3] = boxes.at(3 + index * 4);
   boxesData->results.push_back(data);
 
-  if (index + 1 == boxes.size()/4)
-    boxesData->detections = boxesData->results;
+  if (index + 1 == boxes.size()/4) {
+    boxesData->detections.writeBuffer() = boxesData->results;
+    boxesData->detections.publish();
+  }
 }
 
 
@@ -226,15 +230,21 @@ GstFlowReturn sinkCallback(GstAppSink* appsink, gpointer user_data)
     return GST_FLOW_OK;
   }
   
-  if (boxesData->faceBoxes.empty()) {
-    boxesData->results.clear();
-    boxesData->detections.clear();
+  boxesData->faceBoxes.update();
+  const std::vector<int> &faceBoxes = boxesData->faceBoxes.readBuffer();
+  if (faceBoxes.empty()) {
+    // Results hold last published detections while no emotion is processed
+    if (!boxesData->results.empty()) {
+      boxesData->results.clear();
+      boxesData->detections.writeBuffer().clear();
+      boxesData->detections.publish();
+    }
     gst_sample_unref(sample);
     return GST_FLOW_OK;
   }
 
   gst_buffer_unref(boxesData->imagesBuffer);
-  boxesData->emotionBoxes = boxesData->faceBoxes;
+  boxesData->emotionBoxes = faceBoxes;
   boxesData->processEmotions = true;
   boxesData->emotionCount = 0;
   GstBuffer *buffer = gst_sample_get_buffer(sample);
@@ -253,35 +263,35 @@ void drawCallback(GstElement* overlay,
                   gpointer user_data)
 {
   DecoderData *boxesData = (DecoderData *) user_data;
-  std::vector<EmotionData> results = boxesData->detections;
-
-  cairo_set_source_rgb(cr, 0.85, 0, 1);
-  cairo_move_to(cr, boxesData->width * xText, boxesData->width * yText);
-  cairo_select_font_face(cr,
-                         "Arial",
-                         CAIRO_FONT_SLANT_NORMAL,
-                         CAIRO_FONT_WEIGHT_NORMAL);
-  cairo_set_font_size(cr, boxesData->width * fontFactor);
-  cairo_show_text(cr, ("Faces detected: " + std::to_string(results.size())).c_str());
-
-  if (boxesData->detections.empty())
-    return;
 
-  cairo_set_line_width(cr, 1.0);
-  cairo_set_source_rgb(cr, 1, 1, 0);
-
-  int w, h;
-  for (int i = 0; i < results.size(); i += 1) {
-    int box[4] = {results.at(i).box[0], results.at(i).box[1], results.at(i).box[2], results.at(i).box[3]};
-    w = box[2] - box[0];
-    h = box[3] - box[1];
-    cairo_rectangle(cr, box[0], box[1], w, h);
-    cairo_move_to(cr, box[0], box[1] + h + 20);
-    std::string text = results.at(i).emotion
-                       + "("
-                       + std::to_string(results.at(i).confidence).substr(0,4)
-                       + ")";
-    cairo_show_text(cr, text.c_str());
+  // Only render results again when new ones are available
+  boxesData->detections.update();
+  cairo_t* layer = boxesData->overlay.beginRender(cr, boxesData->detections.getGeneration());
+  if (layer != nullptr) {
+    const std::vector<EmotionData> &results = boxesData->detections.readBuffer();
+
+    cairo_set_source_rgb(layer, 0.85, 0, 1);
+    cairo_move_to(layer, boxesData->width * xText, boxesData->width * yText);
+    cairo_set_font_size(layer, boxesData->width * fontFactor);
+    cairo_show_text(layer, ("Faces detected: " + std::to_string(results.size())).c_str());
+
+    cairo_set_line_width(layer, 1.0);
+    cairo_set_source_rgb(layer, 1, 1, 0);
+
+    int w, h;
+    for (int i = 0; i < results.size(); i += 1) {
+      int box[4] = {results.at(i).box[0], results.at(i).box[1], results.at(i).box[2], results.at(i).box[3]};
+      w = box[2] - box[0];
+      h = box[3] - box[1];
+      cairo_rectangle(layer, box[0], box[1], w, h);
+      cairo_move_to(layer, box[0], box[1] + h + 20);
+      std::string text = results.at(i).emotion
+                         + "("
+                         + std::to_string(results.at(i).confidence).substr(0,4)
+                         + ")";
+      cairo_show_text(layer, text.c_str());
+    }
+    cairo_stroke(layer);
   }
-  cairo_stroke(cr);
+  boxesData->overlay.paint(cr);
  }
\ No newline at end of file
@@ -1,5 +1,5 @@
 /**
- * Copyright 2024-2025 NXP
+ * Copyright 2024-2026 NXP
  * SPDX-License-Identifier: BSD-3-Clause 
  */ 
 
@@ -14,8 +14,11 @@
 #include <glib-unix.h>
 #include <cairo.h>
 #include <vector>
+#include <atomic>
 
+#include "cached_overlay.hpp"
 #include "logging.hpp"
+#include "triple_buffer.hpp"
 
 #define MODEL_UFACE_NUMBER_BOXES              100
 #define NUM_BOX_DATA                          6
@@ -37,15 +40,16 @@ typedef struct {
   int width;
   int height;
   int faceCount = 0;
-  std::vector<int> faceBoxes;
+  TripleBuffer<std::vector<int>> faceBoxes;
   int bufferSize = NUM_BOX_DATA * MODEL_UFACE_NUMBER_BOXES;
   int emotionCount = 0;
   std::vector<int> emotionBoxes;
   std::string emotionsList[7] = {"angry", "disgust", "fear", "happy", "sad", "surprise", "neutral"};
   GstBuffer *imagesBuffer = gst_buffer_new();
-  bool processEmotions = false;
+  std::atomic<bool> processEmotions{false};
   std::vector<EmotionData> results;
-  std::vector<EmotionData> detections;
+  TripleBuffer<std::vector<EmotionData>> detections;
+  CachedOverlay overlay;
 } DecoderData;
 
 
@@ -62,6 +66,12 @@ void secondaryNewDataCallback(GstElement* element,
 GstFlowReturn sinkCallback(GstAppSink* appsink, gpointer user_data);
 
 
+void getEmotionResult(GstBuffer *buffer,
+                      std::vector<int> boxes,
+                      int index,
+                      DecoderData *boxesData);
+
+
 void drawCallback(GstElement* overlay,
                   cairo_t* cr,
                   guint64 timestamp,
@@ -94,7 +94,7 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
 
                   << std::setw(25) << std::left << "  -b, --backend"
                   << std::setw(25) << std::left
-                  << "Use the selected backend (CPU,GPU,NPU)" << std::endl
+                  << "Use the selected backend (CPU,GPU,NPU,auto)" << std::endl
 
                   << std::setw(25) << std::left << "  -n, --normalization"
                   << std::setw(25) << std::left
@@ -255,11 +255,12 @@ int main(int argc, char **argv)
   gstvideoimx.videocrop(emotionPipeline, "video_crop", -1, -1, options.useGpu3D);
 
   // Add model inference to get the emotion of a face
+  CorePlan cores = planCores();
   int numThreads;
   if ((options.eBackend == "CPU") && (options.fBackend == "CPU"))
-    numThreads = std::thread::hardware_concurrency()/2;
+    numThreads = inferenceThreads(cores, 2);
   else
-    numThreads = std::thread::hardware_concurrency();
+    numThreads = inferenceThreads(cores);
   TFliteModelInfos emotionDetection(options.ePath, options.eBackend, options.eNorm, numThreads);
   emotionDetection.addInferenceToPipeline(emotionPipeline, "emotion_filter", "GRAY8");
 
@@ -347,6 +348,10 @@ int main(int argc, char **argv)
   emotionPipeline.parse(options.graphPath);
   pipeline.parse(options.graphPath);
 
+  // Pin threads to cores of their role, for predictable latency
+  emotionPipeline.pinThreads(cores);
+  pipeline.pinThreads(cores);
+
   // Connect callback functions to tensor sink of each pipeline, cairo overlay,
   // appsink, and appsrc to process inference output
   DecoderData boxesData;
@@ -1,5 +1,5 @@
 /**
- * Copyright 2024-2025 NXP
+ * Copyright 2024-2026 NXP
  * SPDX-License-Identifier: BSD-3-Clause 
  */ 
 
@@ -52,7 +52,9 @@ void newDataCallback(GstElement* element,
   bufferInfo = getTensorInfo(buffer, 0);
   assert(boxesData->bufferSize == bufferInfo.size);
 
-  std::vector<int> boxes;
+  // Reuse buffer owned by this thread, it is only read once published
+  std::vector<int> &boxes = boxesData->selectedBoxes.writeBuffer();
+  boxes.clear();
   int faceCount = 0;
   for (int i = 0; ((i < MODEL_UFACE_NUMBER_BOXES)
                    && (faceCount < MODEL_UFACE_NUMBER_MAX)); i+= NUM_BOX_DATA) {
@@ -61,19 +63,19 @@ void newDataCallback(GstElement* element,
       faceCount += 1;
       // Store x1
       boxes.push_back(
-            static_cast<int>(bufferInfo.bufferFP32[i+2] * boxesData->camWidth)
+            static_cast<int>(letterboxToSourceX(boxesData->letterbox, bufferInfo.bufferFP32[i+2]))
         );
       // Store y1
       boxes.push_back(
-            static_cast<int>(bufferInfo.bufferFP32[i+3] * boxesData->camHeight)
+            static_cast<int>(letterboxToSourceY(boxesData->letterbox, bufferInfo.bufferFP32[i+3]))
         );
       // Store x2
       boxes.push_back(
-            static_cast<int>(bufferInfo.bufferFP32[i+4] * boxesData->camWidth)
+            static_cast<int>(letterboxToSourceX(boxesData->letterbox, bufferInfo.bufferFP32[i+4]))
         );
       // Store y2
       boxes.push_back(
-            static_cast<int>(bufferInfo.bufferFP32[i+5] * boxesData->camHeight)
+            static_cast<int>(letterboxToSourceY(boxesData->letterbox, bufferInfo.bufferFP32[i+5]))
         );
     }
   }
@@ -110,8 +112,7 @@ void newDataCallback(GstElement* element,
     boxes.at(3 + faceIndex) = cy + d2;
   }
 
-  boxesData->faceCount = faceCount;
-  boxesData->selectedBoxes = boxes;
+  boxesData->selectedBoxes.publish();
 }
 
 
@@ -123,26 +124,28 @@ void drawCallback(GstElement* overlay,
 {
   DecoderData* boxesData = (DecoderData *) user_data;
 
-  int numFaces = boxesData->faceCount;
-  std::vector<int> boxes = boxesData->selectedBoxes;
-
-  cairo_set_source_rgb(cr, 0.85, 0, 1);
-  cairo_move_to(cr, boxesData->camWidth * (1 - 160.0/640), boxesData->camWidth * 18/640);
-  cairo_select_font_face(cr,
-                         "Arial",
-                         CAIRO_FONT_SLANT_NORMAL,
-                         CAIRO_FONT_WEIGHT_NORMAL);
-  cairo_set_font_size(cr, boxesData->camWidth * 15/640);
-  cairo_show_text(cr, ("Faces detected: " + std::to_string(numFaces)).c_str());
-
-  cairo_set_source_rgb(cr, 1, 0, 0);
-  cairo_set_line_width(cr, 1.0);
-
-  int w, h;
-  for (int faceIndex = 0; faceIndex < 4 * numFaces; faceIndex += 4) {
-    w = boxes.at(2 + faceIndex) - boxes.at(0 + faceIndex);
-    h = boxes.at(3 + faceIndex) - boxes.at(1 + faceIndex);
-    cairo_rectangle(cr, boxes.at(0 + faceIndex), boxes.at(1 + faceIndex), w, h);
+  // Only render results again when new ones are available
+  boxesData->selectedBoxes.update();
+  cairo_t* layer = boxesData->overlay.beginRender(cr, boxesData->selectedBoxes.getGeneration());
+  if (layer != nullptr) {
+    const std::vector<int> &boxes = boxesData->selectedBoxes.readBuffer();
+    int numFaces = boxes.size() / 4;
+
+    cairo_set_source_rgb(layer, 0.85, 0, 1);
+    cairo_move_to(layer, boxesData->camWidth * (1 - 160.0/640), boxesData->camWidth * 18/640);
+    cairo_set_font_size(layer, boxesData->camWidth * 15/640);
+    cairo_show_text(layer, ("Faces detected: " + std::to_string(numFaces)).c_str());
+
+    cairo_set_source_rgb(layer, 1, 0, 0);
+    cairo_set_line_width(layer, 1.0);
+
+    int w, h;
+    for (int faceIndex = 0; faceIndex < 4 * numFaces; faceIndex += 4) {
+      w = boxes.at(2 + faceIndex) - boxes.at(0 + faceIndex);
+      h = boxes.at(3 + faceIndex) - boxes.at(1 + faceIndex);
+      cairo_rectangle(layer, boxes.at(0 + faceIndex), boxes.at(1 + faceIndex), w, h);
+    }
+    cairo_stroke(layer);
   }
-  cairo_stroke(cr);
+  boxesData->overlay.paint(cr);
 }
@@ -1,5 +1,5 @@
 /**
- * Copyright 2024-2025 NXP
+ * Copyright 2024-2026 NXP
  * SPDX-License-Identifier: BSD-3-Clause 
  */ 
 
@@ -13,7 +13,10 @@
 #include <cairo.h>
 #include <vector>
 
+#include "cached_overlay.hpp"
+#include "letterbox.hpp"
 #include "logging.hpp"
+#include "triple_buffer.hpp"
 
 #define MODEL_UFACE_NUMBER_BOXES              100
 #define NUM_BOX_DATA                          6
@@ -22,11 +25,13 @@
 #define MODEL_UFACE_NUMBER_MAX                15
 
 typedef struct {
-  std::vector<int> selectedBoxes;
+  TripleBuffer<std::vector<int>> selectedBoxes;
   int bufferSize = NUM_BOX_DATA * MODEL_UFACE_NUMBER_BOXES;
-  int faceCount = 0;
   int camWidth;
   int camHeight;
+  // Frame placement in model input, to map boxes back to frame
+  Letterbox letterbox;
+  CachedOverlay overlay;
 } DecoderData;
 
 
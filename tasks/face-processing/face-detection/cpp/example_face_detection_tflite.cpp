@@ -1,5 +1,5 @@
 /**
- * Copyright 2024-2025 NXP
+ * Copyright 2024-2026 NXP
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
@@ -39,6 +39,7 @@ typedef struct {
   int camWidth;
   int camHeight;
   int framerate;
+  bool letterbox;
 } ParserOptions;
 
 
@@ -61,12 +62,13 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
     {"text_color",    required_argument, 0, 't'},
     {"graph_path",    required_argument, 0, 'g'},
     {"cam_params",    required_argument, 0, 'r'},
+    {"letterbox",     no_argument,       0, 'k'},
     {0,               0,                 0,   0}
   };
   
   while ((c = getopt_long(argc,
                           argv,
-                          "hb:n:c:p:f:d::t:g:r:",
+                          "hb:n:c:p:f:d::t:g:r:k",
                           longOptions,
                           &optionIndex)) != -1) {
     switch (c)
@@ -80,7 +82,7 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
 
                   << std::setw(25) << std::left << "  -b, --backend"
                   << std::setw(25) << std::left
-                  << "Use the selected backend (CPU,GPU,NPU)" << std::endl
+                  << "Use the selected backend (CPU,GPU,NPU,auto)" << std::endl
 
                   << std::setw(25) << std::left << "  -n, --normalization"
                   << std::setw(25) << std::left
@@ -115,7 +117,11 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
 
                   << std::setw(25) << std::left << "  -r, --cam_params"
                   << std::setw(25) << std::left
-                  << "Use the selected camera resolution and framerate" << std::endl;
+                  << "Use the selected camera resolution and framerate" << std::endl
+
+                  << std::setw(25) << std::left << "  -k, --letterbox"
+                  << std::setw(25) << std::left
+                  << "Keep frame aspect ratio in model input, padding it" << std::endl;
         return 1;
 
       case 'b':
@@ -175,6 +181,10 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
         options.framerate = std::stoi(temp.substr(temp.find(",")+1));
         break;
 
+      case 'k':
+        options.letterbox = true;
+        break;
+
       default:
         break;
     }
@@ -194,6 +204,7 @@ int main(int argc, char **argv)
   options.camWidth = 640;
   options.camHeight = 480;
   options.framerate = 30;
+  options.letterbox = false;
   if (cmdParser(argc, argv, options))
     return 0;
 
@@ -235,6 +246,7 @@ int main(int argc, char **argv)
 
   // Add model inference
   TFliteModelInfos faceDetection(options.modelPath, options.backend, options.norm);
+  faceDetection.setLetterbox(options.letterbox);
   faceDetection.addInferenceToPipeline(pipeline, "face_filter");
 
   // Get inference output for custom processing
@@ -263,6 +275,7 @@ int main(int argc, char **argv)
   DecoderData boxesData;
   boxesData.camWidth = pipeline.getDisplayWidth();
   boxesData.camHeight = pipeline.getDisplayHeight();
+  boxesData.letterbox = faceDetection.getLetterbox();
   pipeline.connectToElementSignal(tensorSinkName, newDataCallback, "new-data", &boxesData);
   pipeline.connectToElementSignal(overlayName, drawCallback, "draw", &boxesData);
 
@@ -1,5 +1,5 @@
 /**
- * Copyright 2024-2025 NXP
+ * Copyright 2024-2026 NXP
  * SPDX-License-Identifier: BSD-3-Clause 
  */ 
 
@@ -52,7 +52,9 @@ void newDataFaceCallback(GstElement* element,
   bufferInfo = getTensorInfo(buffer, 0);
   assert(boxesData->bufferSize == bufferInfo.size);
 
-  std::vector<int> boxes;
+  // Reuse buffer owned by this thread, it is only read once published
+  std::vector<int> &boxes = boxesData->selectedBoxes.writeBuffer();
+  boxes.clear();
   int faceCount = 0;
   for (int i = 0; ((i < MODEL_UFACE_NUMBER_BOXES)
                    && (faceCount < MODEL_UFACE_NUMBER_MAX)); i+= NUM_BOX_DATA) {
@@ -61,19 +63,23 @@ void newDataFaceCallback(GstElement* element,
       faceCount += 1;
       // Store x1
       boxes.push_back(
-            static_cast<int>(bufferInfo.bufferFP32[i+2] * boxesData->inputDim)
+            static_cast<int>(letterboxToFrameX(boxesData->letterbox, bufferInfo.bufferFP32[i+2])
+                             * boxesData->inputDim)
         );
       // Store y1
       boxes.push_back(
-            static_cast<int>(bufferInfo.bufferFP32[i+3] * boxesData->inputDim)
+            static_cast<int>(letterboxToFrameY(boxesData->letterbox, bufferInfo.bufferFP32[i+3])
+                             * boxesData->inputDim)
         );
       // Store x2
       boxes.push_back(
-            static_cast<int>(bufferInfo.bufferFP32[i+4] * boxesData->inputDim)
+            static_cast<int>(letterboxToFrameX(boxesData->letterbox, bufferInfo.bufferFP32[i+4])
+                             * boxesData->inputDim)
         );
       // Store y2
       boxes.push_back(
-            static_cast<int>(bufferInfo.bufferFP32[i+5] * boxesData->inputDim)
+            static_cast<int>(letterboxToFrameY(boxesData->letterbox, bufferInfo.bufferFP32[i+5])
+                             * boxesData->inputDim)
         );
     }
   }
@@ -110,8 +116,7 @@ void newDataFaceCallback(GstElement* element,
     boxes.at(3 + faceIndex) = cy + d2;
   }
 
-  boxesData->faceCount = faceCount;
-  boxesData->selectedBoxes = boxes;
+  boxesData->selectedBoxes.publish();
 }
 
 
@@ -123,28 +128,30 @@ void drawFaceCallback(GstElement* overlay,
 {
   FaceData* boxesData = (FaceData *) user_data;
 
-  int numFaces = boxesData->faceCount;
-  std::vector<int> boxes = boxesData->selectedBoxes;
-
-  cairo_set_source_rgb(cr, 0.85, 0, 1);
-  cairo_move_to(cr, boxesData->inputDim * (1 - 160.0/640), boxesData->inputDim * 18/640);
-  cairo_select_font_face(cr,
-                         "Arial",
-                         CAIRO_FONT_SLANT_NORMAL,
-                         CAIRO_FONT_WEIGHT_NORMAL);
-  cairo_set_font_size(cr, boxesData->inputDim * 15/640);
-  cairo_show_text(cr, ("Faces detected: " + std::to_string(numFaces)).c_str());
-
-  cairo_set_source_rgb(cr, 1, 0, 0);
-  cairo_set_line_width(cr, 1.0);
-
-  int w, h;
-  for (int faceIndex = 0; faceIndex < 4 * numFaces; faceIndex += 4) {
-    w = boxes.at(2 + faceIndex) - boxes.at(0 + faceIndex);
-    h = boxes.at(3 + faceIndex) - boxes.at(1 + faceIndex);
-    cairo_rectangle(cr, boxes.at(0 + faceIndex), boxes.at(1 + faceIndex), w, h);
+  // Only render results again when new ones are available
+  boxesData->selectedBoxes.update();
+  cairo_t* layer = boxesData->overlay.beginRender(cr, boxesData->selectedBoxes.getGeneration());
+  if (layer != nullptr) {
+    const std::vector<int> &boxes = boxesData->selectedBoxes.readBuffer();
+    int numFaces = boxes.size() / 4;
+
+    cairo_set_source_rgb(layer, 0.85, 0, 1);
+    cairo_move_to(layer, boxesData->inputDim * (1 - 160.0/640), boxesData->inputDim * 18/640);
+    cairo_set_font_size(layer, boxesData->inputDim * 15/640);
+    cairo_show_text(layer, ("Faces detected: " + std::to_string(numFaces)).c_str());
+
+    cairo_set_source_rgb(layer, 1, 0, 0);
+    cairo_set_line_width(layer, 1.0);
+
+    int w, h;
+    for (int faceIndex = 0; faceIndex < 4 * numFaces; faceIndex += 4) {
+      w = boxes.at(2 + faceIndex) - boxes.at(0 + faceIndex);
+      h = boxes.at(3 + faceIndex) - boxes.at(1 + faceIndex);
+      cairo_rectangle(layer, boxes.at(0 + faceIndex), boxes.at(1 + faceIndex), w, h);
+    }
+    cairo_stroke(layer);
   }
-  cairo_stroke(cr);
+  boxesData->overlay.paint(cr);
 }
 
 
@@ -158,19 +165,24 @@ void newDataPoseCallback(GstElement* element,
   checkNumTensor(buffer, 1);
   bufferInfo = getTensorInfo(buffer, 0);
 
+  Keypoints &kpts = kptsData->npKpts.writeBuffer();
   int row = 0;
   int col = 0;
   float score = 0;
   float valid = 0;
   for (int i = 0; i < bufferInfo.size; i++) {
 
-    if ((col == X_INDEX) or (col == Y_INDEX)) {
-      kptsData->npKpts[row][col] = bufferInfo.bufferFP32[i] * kptsData->inputDim;
+    if (col == X_INDEX) {
+      kpts[row][col] = letterboxToFrameX(kptsData->letterbox, bufferInfo.bufferFP32[i])
+                       * kptsData->inputDim;
+    } else if (col == Y_INDEX) {
+      kpts[row][col] = letterboxToFrameY(kptsData->letterbox, bufferInfo.bufferFP32[i])
+                       * kptsData->inputDim;
     } else {
-      kptsData->npKpts[row][col] = bufferInfo.bufferFP32[i];
-      score = kptsData->npKpts[row][SCORE_INDEX];
+      kpts[row][col] = bufferInfo.bufferFP32[i];
+      score = kpts[row][SCORE_INDEX];
       valid = (score >= SCORE_THRESHOLD);
-      kptsData->npKpts[row][col] = valid;
+      kpts[row][col] = valid;
     }
 
     col+=1;
@@ -178,6 +190,7 @@ void newDataPoseCallback(GstElement* element,
       row += 1;
     col = col % 3;
   }
+  kptsData->npKpts.publish();
 }
 
 
@@ -189,55 +202,58 @@ void drawPoseCallback(GstElement* overlay,
 {
   PoseData* kptsData = (PoseData *) user_data;
   float valid;
-  float* npKpt;
+  const float* npKpt;
   float xKpt;
   float yKpt;
   int* connections;
-  float* npConnect;
+  const float* npConnect;
   float xConnect;
   float yConnect;
-  cairo_select_font_face(cr,
-                         "Arial",
-                         CAIRO_FONT_SLANT_NORMAL,
-                         CAIRO_FONT_WEIGHT_NORMAL);
-  cairo_set_line_width(cr, 1.0);
-
-  for(int i = 0; i < KPT_SIZE; i++) {
-    npKpt = kptsData->npKpts[i];
-    valid = npKpt[SCORE_INDEX];
-    if (valid != 1.0)
-      continue;
-
-    xKpt = npKpt[X_INDEX];
-    yKpt = npKpt[Y_INDEX];
-
-    // Draw keypoint spot
-    cairo_set_source_rgb(cr, 1, 0, 0);
-    cairo_arc(cr, xKpt, yKpt, 1, 0, 2*M_PI);
-    cairo_fill(cr);
-    cairo_stroke(cr);
-    
-    // Draw keypoint label
-    cairo_set_source_rgb(cr, 0, 1, 1);
-    cairo_set_font_size(cr, 10.0);
-    cairo_move_to(cr, xKpt + 5, yKpt + 5);
-    cairo_show_text(cr, kptsData->kptLabels[i].c_str());
-
-    // Draw keypoint connections
-    cairo_set_source_rgb(cr, 0, 1, 0);
-    connections = kptsData->kptConnect[i];
-    for(int j = 0; j < 3; j++) {
-      if (connections[j] == -1)
-        break;
-      npConnect = kptsData->npKpts[connections[j]];
-      valid = npConnect[SCORE_INDEX];
+  // Only render results again when new ones are available
+  kptsData->npKpts.update();
+  cairo_t* layer = kptsData->overlay.beginRender(cr, kptsData->npKpts.getGeneration());
+  if (layer != nullptr) {
+    const Keypoints &kpts = kptsData->npKpts.readBuffer();
+    cairo_set_line_width(layer, 1.0);
+
+    for(int i = 0; i < KPT_SIZE; i++) {
+      npKpt = kpts[i];
+      valid = npKpt[SCORE_INDEX];
       if (valid != 1.0)
         continue;
-      xConnect = npConnect[X_INDEX];
-      yConnect = npConnect[Y_INDEX];
-      cairo_move_to(cr, xKpt, yKpt);
-      cairo_line_to(cr, xConnect, yConnect);
+
+      xKpt = npKpt[X_INDEX];
+      yKpt = npKpt[Y_INDEX];
+
+      // Draw keypoint spot
+      cairo_set_source_rgb(layer, 1, 0, 0);
+      cairo_arc(layer, xKpt, yKpt, 1, 0, 2*M_PI);
+      cairo_fill(layer);
+      cairo_stroke(layer);
+    
+      // Draw keypoint label
+      cairo_set_source_rgb(layer, 0, 1, 1);
+      cairo_set_font_size(layer, 10.0);
+      cairo_move_to(layer, xKpt + 5, yKpt + 5);
+      cairo_show_text(layer, kptsData->kptLabels[i].c_str());
+
+      // Draw keypoint connections
+      cairo_set_source_rgb(layer, 0, 1, 0);
+      connections = kptsData->kptConnect[i];
+      for(int j = 0; j < 3; j++) {
+        if (connections[j] == -1)
+          break;
+        npConnect = kpts[connections[j]];
+        valid = npConnect[SCORE_INDEX];
+        if (valid != 1.0)
+          continue;
+        xConnect = npConnect[X_INDEX];
+        yConnect = npConnect[Y_INDEX];
+        cairo_move_to(layer, xKpt, yKpt);
+        cairo_line_to(layer, xConnect, yConnect);
+      }
+      cairo_stroke(layer);
     }
-    cairo_stroke(cr);
   }
+  kptsData->overlay.paint(cr);
 }
\ No newline at end of file
@@ -1,5 +1,5 @@
 /**
- * Copyright 2024-2025 NXP
+ * Copyright 2024-2026 NXP
  * SPDX-License-Identifier: BSD-3-Clause 
  */ 
 
@@ -13,7 +13,10 @@
 #include <cairo.h>
 #include <vector>
 
+#include "cached_overlay.hpp"
+#include "letterbox.hpp"
 #include "logging.hpp"
+#include "triple_buffer.hpp"
 
 /* Face detection constants */
 #define MODEL_UFACE_NUMBER_BOXES              100
@@ -30,16 +33,21 @@
 #define SCORE_THRESHOLD                       0.4f
 
 
+typedef float Keypoints[KPT_SIZE][3];
+
+
 typedef struct {
-  std::vector<int> selectedBoxes;
+  TripleBuffer<std::vector<int>> selectedBoxes;
   int bufferSize = NUM_BOX_DATA * MODEL_UFACE_NUMBER_BOXES;
-  int faceCount = 0;
   int inputDim;
+  // Placement of frame in model input, boxes are mapped back to frame
+  Letterbox letterbox{};
+  CachedOverlay overlay;
 } FaceData;
 
 
 typedef struct {
-  float npKpts[17][3];
+  TripleBuffer<Keypoints> npKpts;
   std::string kptLabels[17] = {
       "nose", "left_eye", "right_eye", "left_ear",
       "right_ear", "left_shoulder", "right_shoulder",
@@ -52,6 +60,9 @@ typedef struct {
       {8, -1, -1}, {5, 12, 13}, {6, 11, 14}, {11, 15, -1},
       {12, 16, -1}, {13, -1, -1}, {14, -1, -1}};
   int inputDim;
+  // Placement of face crop in model input, keypoints are mapped back to it
+  Letterbox letterbox{};
+  CachedOverlay overlay;
 } PoseData;
 
 
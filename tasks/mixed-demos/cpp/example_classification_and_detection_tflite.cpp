@@ -11,11 +11,11 @@
  * Pipeline:           
  * source --- tee -----------------------------------------------------------------------------------
  *             |                                                                                     |
- *             |                                                                              video_compositor -- textoverlay -- tee -- waylandsink
- *             |                                                                                     |                 |          |
- *             --- imxvideoconvert -- tensor_converter -- tensor_transform -- tensor_filter -- tensor_decoder          |          --- vpuenc_h264 -- h264parse -- qtmux / matroskamux -- filesink
- *             |                                                                                                       |
- *             --- imxvideoconvert -- tensor_converter -- tensor_transform -- tensor_filter -- tensor_decoder --------- 
+ *             |                                                                              cairooverlay -- textoverlay -- tee -- waylandsink
+ *             |                                                                                                  |          |
+ *             --- imxvideoconvert -- tensor_converter -- tensor_transform -- tensor_filter -- tensor_sink        |          --- vpuenc_h264 -- h264parse -- qtmux / matroskamux -- filesink
+ *             |                                                                                                  |
+ *             --- imxvideoconvert -- tensor_converter -- tensor_transform -- tensor_filter -- tensor_decoder ----
  */
 
 #include "common.hpp"
@@ -28,9 +28,6 @@
     ((optarg == NULL && optind < argc && argv[optind][0] != '-') \
      ? (bool) (optarg = argv[optind++]) \
      : (optarg != NULL))
-#define MODEL_LATENCY_NS_CPU  500000000
-#define MODEL_LATENCY_NS_GPU  1000000000
-#define MODEL_LATENCY_NS_NPU  25000000
 
 
 typedef struct {
@@ -51,6 +48,8 @@ typedef struct {
   int camWidth;
   int camHeight;
   int framerate;
+  float cTargetFps;
+  float dTargetFps;
 } ParserOptions;
 
 
@@ -61,6 +60,7 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
   std::string backend;
   std::string modelNorm;
   std::string modelPath;
+  std::string targetFps;
   DataDir dataDir;
   std::string perfDisplay;
   std::string camParams;
@@ -80,12 +80,13 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
     {"text_color",    required_argument, 0, 't'},
     {"graph_path",    required_argument, 0, 'g'},
     {"cam_params",    required_argument, 0, 'r'},
+    {"target_fps",    required_argument, 0, 'a'},
     {0,               0,                 0,   0}
   };
 
   while ((c = getopt_long(argc,
                           argv,
-                          "hb:n:c:p:f:l:x:s:d::t:g:r:",
+                          "hb:n:c:p:f:l:x:s:d::t:g:r:a:",
                           longOptions,
                           &optionIndex)) != -1) {
     switch (c)
@@ -99,7 +100,7 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
 
                   << std::setw(25) << std::left << "  -b, --backend"
                   << std::setw(25) << std::left
-                  << "Use the selected backend (CPU,GPU,NPU)" << std::endl
+                  << "Use the selected backend (CPU,GPU,NPU,auto)" << std::endl
 
                   << std::setw(25) << std::left << "  -n, --normalization"
                   << std::setw(25) << std::left
@@ -146,7 +147,12 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
 
                   << std::setw(25) << std::left << "  -r, --cam_params"
                   << std::setw(25) << std::left
-                  << "Use the selected camera resolution and framerate" << std::endl;
+                  << "Use the selected camera resolution and framerate" << std::endl
+
+                  << std::setw(25) << std::left << "  -a, --target_fps"
+                  << std::setw(25) << std::left
+                  << "Target inference rates of classification and detection"
+                  << " (0 for maximum rate)" << std::endl;
         return 1;
 
       case 'b':
@@ -233,6 +239,12 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
         options.framerate = std::stoi(temp.substr(temp.find(",")+1));
         break;
 
+      case 'a':
+        targetFps.assign(optarg);
+        options.cTargetFps = std::stof(targetFps.substr(0, targetFps.find(",")));
+        options.dTargetFps = std::stof(targetFps.substr(targetFps.find(",")+1));
+        break;
+
       default:
         break;
     }
@@ -254,6 +266,8 @@ int main(int argc, char **argv)
   options.camWidth = 640;
   options.camHeight = 480;
   options.framerate = 30;
+  options.cTargetFps = 0;
+  options.dTargetFps = 0;
   if (cmdParser(argc, argv, options))
     return 0;
 
@@ -329,29 +343,17 @@ int main(int argc, char **argv)
   };
 
   BoundingBoxesOptions decOptions = {
-    .modelName    = ModeBoundingBoxes::mobilenetssd,
-    .labelsPath   = options.dDataDir.labelsDir.string(),
-    .option3      = setCustomOptions(opt3),
-    .outDim       = {pipeline.getDisplayWidth(), pipeline.getDisplayHeight()},
-    .inDim        = {detection.getModelWidth(), detection.getModelHeight()},
-    .trackResult  = false,
-    .logResult    = false,
+    .modelName     = ModeBoundingBoxes::mobilenetssd,
+    .labelsPath    = options.dDataDir.labelsDir.string(),
+    .option3       = setCustomOptions(opt3),
+    .outDim        = {pipeline.getDisplayWidth(), pipeline.getDisplayHeight()},
+    .inDim         = {detection.getModelWidth(), detection.getModelHeight()},
+    .trackResult   = false,
+    .logResult     = false,
+    .nativeDecoder = true,
   };
   detDecoder.addBoundingBoxes(pipeline, decOptions);
 
-  // Initialize compositor element
-  std::string compositorName = "mix";
-  GstVideoCompositorImx compositor(compositorName);
-
-  // Add tensor decoder output to the compositor
-  compositorInputParams firstInputParams = {
-    .position     = displayPosition::center,
-    .order        = 2,
-    .keepRatio    = false,
-    .transparency = true,
-  };
-  compositor.addToCompositor(pipeline, firstInputParams);
-
   // Add a branch to tee element to display result
   GstQueueOptions imgQueue = {
     .queueName     = "thread-img",
@@ -360,27 +362,8 @@ int main(int argc, char **argv)
   };
   pipeline.addBranch(teeName, imgQueue);
 
-  // Set latency of model for video compositor
-  long long latency;
-  if (options.dBackend == "NPU") {
-   latency = getLatencyFromEnv("LATENCY_NPU", MODEL_LATENCY_NS_NPU);
-  } else if (options.dBackend == "GPU") {
-    latency = getLatencyFromEnv("LATENCY_GPU", MODEL_LATENCY_NS_GPU);
-  } else {
-    latency = getLatencyFromEnv("LATENCY_CPU", MODEL_LATENCY_NS_CPU);
-  }
-
-  // Add camera input to the compositor
-  compositorInputParams secondInputParams = {
-    .position     = displayPosition::center,
-    .order        = 1,
-    .keepRatio    = false,
-    .transparency = false,
-  };
-  compositor.addToCompositor(pipeline, secondInputParams);
-
-  // Compositing pipeline input video with model processed output
-  compositor.addCompositorToPipeline(pipeline, latency);
+  // Draw decoded boxes over the camera stream
+  detDecoder.addBoundingBoxesOverlay(pipeline);
 
   // Add text overlay
   GstVideoPostProcess postProcess;
@@ -420,8 +403,32 @@ int main(int argc, char **argv)
   // Parse pipeline to GStreamer pipeline
   pipeline.parse(options.graphPath);
 
+  // Connect native decoder to tensor sink and overlay
+  detDecoder.connectBoundingBoxes(pipeline);
+
+  // Share accelerator between models: detection keeps its rate,
+  // classification gets frames when detection inference is not delayed
+  InferenceArbiter arbiter;
+  ArbiterModelOptions detArbiter = {
+    .filterName = "detection_filter",
+    .gateName   = nnDetQueue.queueName,
+    .priority   = 1,
+    .targetFps  = options.dTargetFps,
+  };
+  arbiter.addModel(detArbiter);
+  ArbiterModelOptions classArbiter = {
+    .filterName = "classification_filter",
+    .gateName   = nnClassQueue.queueName,
+    .priority   = 0,
+    .targetFps  = options.cTargetFps,
+  };
+  arbiter.addModel(classArbiter);
+  arbiter.attach(pipeline);
+  arbiter.logStatsPeriodically();
+
   // Run GStreamer pipeline
   pipeline.run();
+  arbiter.logStats();
 
   return 0;
 }
@@ -103,7 +103,7 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
 
                   << std::setw(25) << std::left << "  -b, --backend"
                   << std::setw(25) << std::left
-                  << "Use the selected backend (CPU,GPU,NPU)" << std::endl
+                  << "Use the selected backend (CPU,GPU,NPU,auto)" << std::endl
 
                   << std::setw(25) << std::left << "  -n, --normalization"
                   << std::setw(25) << std::left
@@ -259,11 +259,12 @@ int main(int argc, char **argv)
   pipeline.addBranch(firstCamTee, nnQueue);
 
   // Add model inference
+  CorePlan cores = planCores();
   int numThreads;
   if ((options.backendCam1 == "CPU") && (options.backendCam2 == "CPU"))
-    numThreads = std::thread::hardware_concurrency()/2;
+    numThreads = inferenceThreads(cores, 2);
   else
-    numThreads = std::thread::hardware_concurrency();
+    numThreads = inferenceThreads(cores);
   TFliteModelInfos firstModel(options.modelPathCam1, options.backendCam1, options.normCam1, numThreads);
   firstModel.addInferenceToPipeline(pipeline, "cam1");
 
@@ -298,14 +299,19 @@ int main(int argc, char **argv)
 
   // Initialize compositor element
   std::string compositorName = "mix";
-  GstVideoCompositorImx compositor(compositorName);
+  CompositorLayoutOptions layoutOptions = {
+    .layout    = CompositorLayout::grid,
+    .numInputs = 2,
+  };
+  GstVideoCompositorImx compositor(compositorName, layoutOptions);
 
   // Add text overlay output to the compositor
   compositorInputParams firstInputParams = {
-    .position     = displayPosition::left,
     .order        = 1,
     .keepRatio    = true,
     .transparency = false,
+    .sourceWidth  = options.camWidth,
+    .sourceHeight = options.camHeight,
   };
   compositor.addToCompositor(pipeline, firstInputParams);
 
@@ -368,10 +374,11 @@ int main(int argc, char **argv)
 
   // Add camera input to the compositor
   compositorInputParams secondInputParams = {
-    .position     = displayPosition::right,
     .order        = 2,
     .keepRatio    = true,
     .transparency = false,
+    .sourceWidth  = options.camWidth,
+    .sourceHeight = options.camHeight,
   };
   compositor.addToCompositor(pipeline, secondInputParams);
 
@@ -408,6 +415,9 @@ int main(int argc, char **argv)
   // Parse pipeline to GStreamer pipeline
   pipeline.parse(options.graphPath);
 
+  // Pin threads to cores of their role, for predictable latency
+  pipeline.pinThreads(cores);
+
   // Run GStreamer pipeline
   pipeline.run();
 
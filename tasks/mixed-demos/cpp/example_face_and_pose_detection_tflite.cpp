@@ -49,6 +49,8 @@ typedef struct {
   int camHeight;
   int framerate;
   bool useGpu3D;
+  float fTargetFps;
+  float pTargetFps;
 } ParserOptions;
 
 
@@ -59,6 +61,7 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
   std::string backend;
   std::string modelNorm;
   std::string modelPath;
+  std::string targetFps;
   std::string perfDisplay;
   std::string camParams;
   std::string temp;
@@ -75,12 +78,13 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
     {"graph_path",    required_argument, 0, 'g'},
     {"cam_params",    required_argument, 0, 'r'},
     {"use_gpu3d",     required_argument, 0, 'u'},
+    {"target_fps",    required_argument, 0, 'a'},
     {0,               0,                 0,   0}
   };
   
   while ((c = getopt_long(argc,
                           argv,
-                          "hb:n:c:p:f:d::t:g:r:u:",
+                          "hb:n:c:p:f:d::t:g:r:u:a:",
                           longOptions,
                           &optionIndex)) != -1) {
     switch (c)
@@ -94,7 +98,7 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
 
                   << std::setw(25) << std::left << "  -b, --backend"
                   << std::setw(25) << std::left
-                  << "Use the selected backend (CPU,GPU,NPU)" << std::endl
+                  << "Use the selected backend (CPU,GPU,NPU,auto)" << std::endl
 
                   << std::setw(25) << std::left << "  -n, --normalization"
                   << std::setw(25) << std::left
@@ -133,7 +137,12 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
                   
                   << std::setw(25) << std::left << "  -u, --use_gpu3d"
                   << std::setw(25) << std::left
-                  << "Use the 3D GPU hardware acceleration for video transformation (if available)" << std::endl;
+                  << "Use the 3D GPU hardware acceleration for video transformation (if available)" << std::endl
+
+                  << std::setw(25) << std::left << "  -a, --target_fps"
+                  << std::setw(25) << std::left
+                  << "Target inference rates of face and pose detection"
+                  << " (0 for maximum rate)" << std::endl;
         return 1;
 
       case 'b':
@@ -206,6 +215,12 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
           options.useGpu3D = false;
         break;
 
+      case 'a':
+        targetFps.assign(optarg);
+        options.fTargetFps = std::stof(targetFps.substr(0, targetFps.find(",")));
+        options.pTargetFps = std::stof(targetFps.substr(targetFps.find(",")+1));
+        break;
+
       default:
         break;
     }
@@ -228,6 +243,8 @@ int main(int argc, char **argv)
   options.camHeight = 480;
   options.framerate = 30;
   options.useGpu3D = false;
+  options.fTargetFps = 0;
+  options.pTargetFps = 0;
   if (cmdParser(argc, argv, options))
     return 0;
 
@@ -288,11 +305,12 @@ int main(int argc, char **argv)
   pipeline.addBranch(teeName, nnFaceQueue);
 
   // Add face detection inference
+  CorePlan cores = planCores();
   int numThreads;
   if ((options.fBackend == "CPU") && (options.pBackend == "CPU"))
-    numThreads = std::thread::hardware_concurrency()/2;
+    numThreads = inferenceThreads(cores, 2);
   else
-    numThreads = std::thread::hardware_concurrency();
+    numThreads = inferenceThreads(cores);
   TFliteModelInfos faceDetection(options.fPath, options.fBackend, options.fNorm, numThreads);
   faceDetection.addInferenceToPipeline(pipeline, "face_filter");
 
@@ -338,20 +356,46 @@ int main(int argc, char **argv)
   // Parse pipeline to GStreamer pipeline
   pipeline.parse(options.graphPath);
 
+  // Pin threads to cores of their role, for predictable latency
+  pipeline.pinThreads(cores);
+
   // Connect callback functions to tensor sink and cairo overlay elements,
   // to process inferences output
   FaceData boxesData;
   boxesData.inputDim = cropDim;
+  boxesData.letterbox = faceDetection.getLetterbox();
   pipeline.connectToElementSignal(tsinkFace, newDataFaceCallback, "new-data", &boxesData);
   pipeline.connectToElementSignal(overlayFace, drawFaceCallback, "draw", &boxesData);
 
   PoseData kptsData;
   kptsData.inputDim = cropDim;
+  kptsData.letterbox = pose.getLetterbox();
   pipeline.connectToElementSignal(tsinkPose, newDataPoseCallback, "new-data", &kptsData);
   pipeline.connectToElementSignal(overlayPose, drawPoseCallback, "draw", &kptsData);
 
+  // Share accelerator between models: face detection keeps its rate,
+  // pose detection gets frames when face detection is not delayed
+  InferenceArbiter arbiter;
+  ArbiterModelOptions faceArbiter = {
+    .filterName = "face_filter",
+    .gateName   = nnFaceQueue.queueName,
+    .priority   = 1,
+    .targetFps  = options.fTargetFps,
+  };
+  arbiter.addModel(faceArbiter);
+  ArbiterModelOptions poseArbiter = {
+    .filterName = "pose_filter",
+    .gateName   = nnPoseQueue.queueName,
+    .priority   = 0,
+    .targetFps  = options.pTargetFps,
+  };
+  arbiter.addModel(poseArbiter);
+  arbiter.attach(pipeline);
+  arbiter.logStatsPeriodically();
+
   // Run GStreamer pipeline
   pipeline.run();
+  arbiter.logStats();
 
   return 0;
 }
@@ -0,0 +1,173 @@
+/**
+ * Copyright 2026 NXP
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * Capture camera frames once and share them with other processes through a
+ * frame bus. Examples started with -a option attach to the bus instead of
+ * opening the camera, so that several of them run on one camera.
+ *
+ * Pipeline:
+ * source -- imxvideoconvert -- appsink ==> frame bus ==> appsrc -- ... (consumer processes)
+ */
+
+#include "common.hpp"
+
+#include <iostream>
+#include <getopt.h>
+#include <algorithm>
+
+
+typedef struct {
+  std::filesystem::path camDevice;
+  std::filesystem::path socketPath;
+  std::string format;
+  int numSlots;
+  int camWidth;
+  int camHeight;
+  int framerate;
+} ParserOptions;
+
+
+int cmdParser(int argc, char **argv, ParserOptions& options)
+{
+  int c;
+  int optionIndex;
+  std::string camParams;
+  std::string temp;
+  static struct option longOptions[] = {
+    {"help",          no_argument,       0, 'h'},
+    {"camera_device", required_argument, 0, 'c'},
+    {"cam_params",    required_argument, 0, 'r'},
+    {"frame_bus",     required_argument, 0, 'a'},
+    {"format",        required_argument, 0, 'o'},
+    {"slots",         required_argument, 0, 's'},
+    {0,               0,                 0,   0}
+  };
+
+  while ((c = getopt_long(argc,
+                          argv,
+                          "hc:r:a:o:s:",
+                          longOptions,
+                          &optionIndex)) != -1) {
+    switch (c)
+    {
+      case 'h':
+        std::cout << "Help Options:" << std::endl
+                  << std::setw(25) << std::left << "  -h, --help"
+                  << std::setw(25) << std::left << "Show help options"
+                  << std::endl << std::endl
+                  << "Application Options:" << std::endl
+
+                  << std::setw(25) << std::left << "  -c, --camera_device"
+                  << std::setw(25) << std::left
+                  << "Use the selected camera device (/dev/video{number})"
+                  << std::endl
+
+                  << std::setw(25) << std::left << "  -r, --cam_params"
+                  << std::setw(25) << std::left
+                  << "Use the selected camera resolution and framerate" << std::endl
+
+                  << std::setw(25) << std::left << "  -a, --frame_bus"
+                  << std::setw(25) << std::left
+                  << "Socket path consumers connect to (/tmp/frame_bus.sock by default)" << std::endl
+
+                  << std::setw(25) << std::left << "  -o, --format"
+                  << std::setw(25) << std::left
+                  << "Pixel format of shared frames (YUY2 by default)" << std::endl
+
+                  << std::setw(25) << std::left << "  -s, --slots"
+                  << std::setw(25) << std::left
+                  << "Number of frames in shared memory, frames are dropped"
+                  << " when consumers hold all of them (8 by default)" << std::endl;
+        return 1;
+
+      case 'c':
+        options.camDevice.assign(optarg);
+        break;
+
+      case 'r':
+        camParams.assign(optarg);
+        if (std::count( camParams.begin(), camParams.end(), ',') != 2) {
+          log_error("-r parameter needs the following argument: width,height,framerate\n");
+          return 1;
+        }
+        options.camWidth = std::stoi(camParams.substr(0, camParams.find(",")));
+        temp = camParams.substr(camParams.find(",")+1);
+        options.camHeight = std::stoi(temp.substr(0, temp.find(",")));
+        options.framerate = std::stoi(temp.substr(temp.find(",")+1));
+        break;
+
+      case 'a':
+        options.socketPath.assign(optarg);
+        break;
+
+      case 'o':
+        options.format.assign(optarg);
+        break;
+
+      case 's':
+        options.numSlots = std::stoi(optarg);
+        break;
+
+      default:
+        break;
+    }
+  }
+  return 0;
+}
+
+
+int main(int argc, char **argv)
+{
+  // Initialize command line parser with default values
+  ParserOptions options;
+  options.socketPath = "/tmp/frame_bus.sock";
+  options.format = "YUY2";
+  options.numSlots = 8;
+  options.camWidth = 640;
+  options.camHeight = 480;
+  options.framerate = 30;
+  if (cmdParser(argc, argv, options))
+    return 0;
+
+  // Initialize pipeline object
+  GstPipelineImx pipeline;
+
+  // Add camera to pipeline
+  CameraOptions camOpt = {
+    .cameraDevice   = options.camDevice,
+    .gstName        = "cam_src",
+    .width          = options.camWidth,
+    .height         = options.camHeight,
+    .horizontalFlip = false,
+    .format         = "",
+    .framerate      = options.framerate,
+  };
+  GstCameraImx camera(camOpt);
+  camera.addCameraToPipeline(pipeline);
+
+  // Share frames with consumer processes
+  FrameBusOptions busOptions = {
+    .socketPath = options.socketPath,
+    .width      = camera.getWidth(),
+    .height     = camera.getHeight(),
+    .format     = options.format,
+    .framerate  = options.framerate,
+    .numSlots   = options.numSlots,
+  };
+  FrameBusPublisher frameBus(busOptions);
+  frameBus.addFrameBusToPipeline(pipeline);
+
+  // Parse pipeline to GStreamer pipeline
+  pipeline.parse(getenv("HOME"));
+
+  // Accept consumers and publish frames
+  frameBus.connectFrameBus(pipeline);
+
+  // Run GStreamer pipeline
+  pipeline.run();
+
+  return 0;
+}
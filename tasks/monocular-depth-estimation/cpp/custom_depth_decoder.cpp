@@ -62,12 +62,28 @@ void newDataCallback(GstElement* element,
     exit(-1);
   }
 
+#ifdef _OPENMP
+  // Streaming thread is joined by worker threads on decoder cores, the
+  // same workers are kept by OpenMP from one frame to the next
+  int numThreads = omp_get_max_threads();
+  if (!data->decoderCores.empty())
+    numThreads = data->decoderCores.size() + 1;
+  if (!data->pinned && !data->decoderCores.empty()) {
+    #pragma omp parallel num_threads(numThreads)
+    {
+      if (omp_get_thread_num() != 0)
+        pinCurrentThread(data->decoderCores);
+    }
+    data->pinned = true;
+  }
+#endif
+
   // Parallel min/max reduction using OpenMP
   float minVal = outputData[0];
   float maxVal = outputData[0];
 
 #ifdef _OPENMP
-  #pragma omp parallel for reduction(min:minVal) reduction(max:maxVal) schedule(static)
+  #pragma omp parallel for reduction(min:minVal) reduction(max:maxVal) schedule(static) num_threads(numThreads)
 #endif
   for (int i = 1; i < MODEL_OUTPUT_DIM; i++) {
     const float val = outputData[i];
@@ -79,7 +95,7 @@ void newDataCallback(GstElement* element,
   if (range > MODEL_THRESHOLD) {
     const float scale = 255.0f / range;
 #ifdef _OPENMP
-    #pragma omp parallel for schedule(static)
+    #pragma omp parallel for schedule(static) num_threads(numThreads)
 #endif
     for (int i = 0; i < MODEL_OUTPUT_DIM; i++) {
       guchar gray = (guchar)std::round(scale * (outputData[i] - minVal));
@@ -15,6 +15,7 @@
 #include <cairo.h>
 #include <vector>
 
+#include "core_planner.hpp"
 #include "logging.hpp"
 
 #define MODEL_THRESHOLD   1e-6
@@ -25,6 +26,8 @@
 typedef struct {
   guchar output[DISPLAY_BUFFER_SIZE];
   GstElement *appSrc;
+  std::vector<int> decoderCores;
+  bool pinned = false;
 } DecoderData;
 
 
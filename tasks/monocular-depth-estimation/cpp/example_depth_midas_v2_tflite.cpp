@@ -80,7 +80,7 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
 
                   << std::setw(25) << std::left << "  -b, --backend"
                   << std::setw(25) << std::left
-                  << "Use the selected backend (CPU,GPU,NPU)" << std::endl
+                  << "Use the selected backend (CPU,GPU,NPU,auto)" << std::endl
 
                   << std::setw(25) << std::left << "  -n, --normalization"
                   << std::setw(25) << std::left
@@ -231,9 +231,11 @@ int main(int argc, char **argv)
   pipeline.addQueue(nnQueue);
 
   // Add model inference
+  CorePlan cores = planCores();
   TFliteModelInfos depthEstimation(options.modelPath,
                                    options.backend,
-                                   options.norm);
+                                   options.norm,
+                                   inferenceThreads(cores));
   depthEstimation.addInferenceToPipeline(pipeline, "depth_filter");
 
   // Add tensor sink to get inference output and process it
@@ -265,9 +267,14 @@ int main(int argc, char **argv)
   displayPipeline.parse(options.graphPath);
   pipeline.parse(options.graphPath);
 
+  // Pin threads to cores of their role, for predictable latency
+  displayPipeline.pinThreads(cores);
+  pipeline.pinThreads(cores);
+
   // Connect callback functions
   DecoderData boxesData;
   boxesData.appSrc = displayPipeline.getElement("appsrc_video");
+  boxesData.decoderCores = cores.decoder;
   pipeline.connectToElementSignal(tensorSinkName, newDataCallback, "new-data", &boxesData);
 
   // Run GStreamer pipeline
@@ -10,14 +10,26 @@
  * Pipeline:
  * source --- tee -----------------------------------------------------------------------------------
  *             |                                                                                     |
- *             |                                                                              video_compositor -- waylandsink
+ *             |                                                                               cairooverlay -- waylandsink
  *             |                                                                                     |
- *             --- imxvideoconvert -- tensor_converter -- tensor_transform -- tensor_filter -- tensor_decoder
+ *             --- imxvideoconvert -- tensor_converter -- tensor_transform -- tensor_filter -- tensor_sink
+ *
+ * Offline pipeline, one per video file, several ones run concurrently:
+ * filesrc -- decoder -- queue -- imxvideoconvert -- tensor_converter -- tensor_transform -- tensor_filter -- tensor_sink
+ *
+ * With -a option, source is an appsrc pushing frames of a frame bus publisher.
+ *
+ * Image batch pipeline, JPEG images are decoded and resized by a thread pool:
+ * appsrc -- tensor_converter -- tensor_transform -- tensor_filter -- tensor_sink
  */
 
 #include "common.hpp"
 
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <atomic>
 #include <getopt.h>
 #include <algorithm>
 
@@ -25,16 +37,17 @@
     ((optarg == NULL && optind < argc && argv[optind][0] != '-') \
      ? (bool) (optarg = argv[optind++]) \
      : (optarg != NULL))
-#define MODEL_LATENCY_NS_CPU          80000000
-#define MODEL_LATENCY_NS_GPU_VSI      500000000
-#define MODEL_LATENCY_NS_NPU_VSI      20000000
-#define MODEL_LATENCY_NS_NPU_ETHOS    15000000
-#define MODEL_LATENCY_NS_NPU_NEUTRON  10000000
 
 
 typedef struct {
   std::filesystem::path camDevice;
   std::filesystem::path videoPath;
+  std::filesystem::path outputDir;
+  std::filesystem::path imageDir;
+  std::filesystem::path resultsSocket;
+  std::string resultsShm;
+  std::filesystem::path frameBus;
+  int numJobs;
   std::filesystem::path modelPath;
   std::string backend;
   std::string norm;
@@ -45,6 +58,7 @@ typedef struct {
   int camWidth;
   int camHeight;
   int framerate;
+  bool letterbox;
 } ParserOptions;
 
 
@@ -69,12 +83,19 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
     {"text_color",    required_argument, 0, 't'},
     {"graph_path",    required_argument, 0, 'g'},
     {"cam_params",    required_argument, 0, 'r'},
+    {"output_dir",    required_argument, 0, 'o'},
+    {"jobs",          required_argument, 0, 'j'},
+    {"image_dir",     required_argument, 0, 'i'},
+    {"results_socket", required_argument, 0, 's'},
+    {"results_shm",   required_argument, 0, 'm'},
+    {"frame_bus",     required_argument, 0, 'a'},
+    {"letterbox",     no_argument,       0, 'k'},
     {0,               0,                 0,   0}
   };
 
   while ((c = getopt_long(argc,
                           argv,
-                          "hb:n:c:p:f:l:x:d::t:g:r:",
+                          "hb:n:c:p:f:l:x:d::t:g:r:o:j:i:s:m:a:k",
                           longOptions,
                           &optionIndex)) != -1) {
     switch (c)
@@ -88,7 +109,7 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
 
                   << std::setw(25) << std::left << "  -b, --backend"
                   << std::setw(25) << std::left
-                  << "Use the selected backend (CPU,GPU,NPU)" << std::endl
+                  << "Use the selected backend (CPU,GPU,NPU,auto)" << std::endl
 
                   << std::setw(25) << std::left << "  -n, --normalization"
                   << std::setw(25) << std::left
@@ -131,7 +152,39 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
 
                   << std::setw(25) << std::left << "  -r, --cam_params"
                   << std::setw(25) << std::left
-                  << "Use the selected camera resolution and framerate" << std::endl;
+                  << "Use the selected camera resolution and framerate" << std::endl
+
+                  << std::setw(25) << std::left << "  -o, --output_dir"
+                  << std::setw(25) << std::left
+                  << "Process video files offline as fast as possible, and write"
+                  << " detections of each one in this directory (-f takes a comma separated list)" << std::endl
+
+                  << std::setw(25) << std::left << "  -j, --jobs"
+                  << std::setw(25) << std::left
+                  << "Number of concurrent offline pipelines (sized from cores and backend by default)" << std::endl
+
+                  << std::setw(25) << std::left << "  -i, --image_dir"
+                  << std::setw(25) << std::left
+                  << "Detect objects on all JPEG images of this directory as fast as possible,"
+                  << " and write results in <output_dir>/detections.jsonl" << std::endl
+
+                  << std::setw(25) << std::left << "  -s, --results_socket"
+                  << std::setw(25) << std::left
+                  << "Publish detections of each frame as JSON lines on this Unix socket path" << std::endl
+
+                  << std::setw(25) << std::left << "  -m, --results_shm"
+                  << std::setw(25) << std::left
+                  << "Publish detections of each frame as binary records in this shared memory ring"
+                  << " (e.g. /detections)" << std::endl
+
+                  << std::setw(25) << std::left << "  -a, --frame_bus"
+                  << std::setw(25) << std::left
+                  << "Use frames of a frame bus publisher (socket path) instead of camera source" << std::endl
+
+                  << std::setw(25) << std::left << "  -k, --letterbox"
+                  << std::setw(25) << std::left
+                  << "Keep frame aspect ratio in model input, padding it with black instead of stretching it"
+                  << std::endl;
         return 1;
   
       case 'b':
@@ -199,6 +252,34 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
         options.framerate = std::stoi(temp.substr(temp.find(",")+1));
         break;
 
+      case 'o':
+        options.outputDir.assign(optarg);
+        break;
+
+      case 'j':
+        options.numJobs = std::stoi(optarg);
+        break;
+
+      case 'i':
+        options.imageDir.assign(optarg);
+        break;
+
+      case 's':
+        options.resultsSocket.assign(optarg);
+        break;
+
+      case 'm':
+        options.resultsShm.assign(optarg);
+        break;
+
+      case 'a':
+        options.frameBus.assign(optarg);
+        break;
+
+      case 'k':
+        options.letterbox = true;
+        break;
+
       default:
         break;
     }
@@ -207,6 +288,242 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
 }
 
 
+/**
+ * @brief Detections of an offline pipeline.
+ */
+typedef struct {
+  NNDecoder* decoder;
+  std::ofstream file;
+  uint64_t numFrames = 0;
+} OfflineResults;
+
+
+/**
+ * @brief Write boxes of each frame, connected after native decoder callback
+ *        so that latest boxes are the ones of this buffer.
+ */
+void offlineResultsCallback(GstElement* element,
+                            GstBuffer* buffer,
+                            gpointer user_data)
+{
+  OfflineResults* results = (OfflineResults *) user_data;
+  double ptsMs = GST_CLOCK_TIME_IS_VALID(GST_BUFFER_PTS(buffer))
+                 ? GST_BUFFER_PTS(buffer) / 1e6 : -1;
+  for (const DetectedBox &box : results->decoder->getBoundingBoxes()) {
+    results->file << results->numFrames << "," << ptsMs << ","
+                  << results->decoder->getLabel(box.classId) << "," << box.score << ","
+                  << box.x1 << "," << box.y1 << "," << box.x2 << "," << box.y2 << "\n";
+  }
+  results->numFrames += 1;
+}
+
+
+/**
+ * @brief Run detection on all video files without display, clock sync or
+ *        frame dropping, and write results in <output directory>/<video name>.csv.
+ *
+ * @param options: parsed options.
+ */
+int runOffline(const ParserOptions &options)
+{
+  std::vector<std::filesystem::path> videos;
+  std::stringstream videoList(options.videoPath.string());
+  std::string video;
+  while (std::getline(videoList, video, ','))
+    videos.push_back(video);
+
+  std::error_code error;
+  std::filesystem::create_directories(options.outputDir, error);
+  if (error) {
+    log_error("Could not create %s\n", options.outputDir.c_str());
+    return 1;
+  }
+
+  OfflineRunner runner(videos, options.backend, options.numJobs);
+  std::atomic<int> numFailures{0};
+  uint64_t numFrames = runner.run([&](const std::filesystem::path &input,
+                                      std::unique_lock<std::mutex> &buildLock) -> uint64_t {
+    OfflineResults results;
+    std::filesystem::path resultsPath = options.outputDir / input.stem();
+    results.file.open(resultsPath.string() + ".csv");
+    if (!results.file.is_open()) {
+      log_error("Could not open %s.csv\n", resultsPath.c_str());
+      numFailures += 1;
+      return 0;
+    }
+    results.file << "frame,pts_ms,label,score,x1,y1,x2,y2\n";
+
+    GstPipelineImx pipeline;
+    pipeline.setOffline(true);
+
+    GstVideoFileImx video(input, false);
+    video.addVideoToPipeline(pipeline);
+
+    // Decode next frames during inference
+    GstQueueOptions nnQueue = {
+      .queueName     = "",
+      .maxSizeBuffer = 4,
+      .leakType      = GstQueueLeaky::no,
+    };
+    pipeline.addQueue(nnQueue);
+
+    // Inference threads are shared between concurrent pipelines
+    TFliteModelInfos detection(options.modelPath,
+                               options.backend,
+                               options.norm,
+                               runner.getThreadsPerJob());
+    detection.setLetterbox(options.letterbox);
+    detection.addInferenceToPipeline(pipeline);
+
+    NNDecoder decoder;
+    SSDMobileNetCustomOptions customOptions = {
+      .boxesPath = options.dataDir.boxesDir.string(),
+    };
+    BoundingBoxesOptions decOptions = {
+      .modelName     = ModeBoundingBoxes::mobilenetssd,
+      .labelsPath    = options.dataDir.labelsDir.string(),
+      .option3       = setCustomOptions(customOptions),
+      .outDim        = {pipeline.getDisplayWidth(), pipeline.getDisplayHeight()},
+      .inDim         = {detection.getModelWidth(), detection.getModelHeight()},
+      .trackResult   = false,
+      .logResult     = false,
+      .nativeDecoder = true,
+      .letterbox     = detection.getLetterbox(),
+    };
+    decoder.addBoundingBoxes(pipeline, decOptions);
+
+    pipeline.parse(options.graphPath);
+    decoder.connectBoundingBoxes(pipeline);
+
+    results.decoder = &decoder;
+    pipeline.connectToElementSignal(decoder.getBoundingBoxesSinkName(),
+                                    offlineResultsCallback,
+                                    "new-data",
+                                    &results);
+    buildLock.unlock();
+
+    if (!pipeline.runToCompletion()) {
+      log_error("Processing of %s failed, its frames are not counted\n", input.c_str());
+      numFailures += 1;
+      return 0;
+    }
+    return results.numFrames;
+  });
+  return ((numFrames > 0) && (numFailures == 0)) ? 0 : 1;
+}
+
+
+/**
+ * @brief Detections of an image batch.
+ */
+typedef struct {
+  NNDecoder* decoder;
+  GstImageBatchImx* batch;
+  int width;
+  int height;
+  std::ofstream file;
+  uint64_t numImages = 0;
+} BatchResults;
+
+
+/**
+ * @brief Write a JSON line per image, with normalized boxes, connected
+ *        after native decoder callback.
+ */
+void batchResultsCallback(GstElement* element,
+                          GstBuffer* buffer,
+                          gpointer user_data)
+{
+  BatchResults* results = (BatchResults *) user_data;
+  std::string image = results->batch->getImagePath(GST_BUFFER_PTS(buffer)).string();
+  results->file << "{\"image\": " << toJsonString(image) << ", \"detections\": [";
+  bool first = true;
+  for (const DetectedBox &box : results->decoder->getBoundingBoxes()) {
+    results->file << (first ? "" : ", ")
+                  << "{\"label\": " << toJsonString(results->decoder->getLabel(box.classId))
+                  << ", \"score\": " << box.score
+                  << ", \"box\": [" << box.x1 / results->width << ", " << box.y1 / results->height
+                  << ", " << box.x2 / results->width << ", " << box.y2 / results->height << "]}";
+    first = false;
+  }
+  results->file << "]}\n";
+  results->numImages += 1;
+}
+
+
+/**
+ * @brief Detect objects on all images of a directory as fast as possible,
+ *        and write one JSON line per image in <output directory>/detections.jsonl.
+ *
+ * @param options: parsed options.
+ */
+int runImageBatch(const ParserOptions &options)
+{
+  std::error_code error;
+  std::filesystem::create_directories(options.outputDir, error);
+  if (error) {
+    log_error("Could not create %s\n", options.outputDir.c_str());
+    return 1;
+  }
+
+  GstPipelineImx pipeline;
+  pipeline.setOffline(true);
+
+  // Images are decoded at model resolution, inference needs no conversion
+  TFliteModelInfos detection(options.modelPath, options.backend, options.norm);
+  GstImageBatchImx batch(options.imageDir, detection.getModelWidth(), detection.getModelHeight());
+  batch.addImageBatchToPipeline(pipeline);
+  detection.addInferenceToPipeline(pipeline, "", "");
+
+  NNDecoder decoder;
+  SSDMobileNetCustomOptions customOptions = {
+    .boxesPath = options.dataDir.boxesDir.string(),
+  };
+  BoundingBoxesOptions decOptions = {
+    .modelName     = ModeBoundingBoxes::mobilenetssd,
+    .labelsPath    = options.dataDir.labelsDir.string(),
+    .option3       = setCustomOptions(customOptions),
+    .outDim        = {pipeline.getDisplayWidth(), pipeline.getDisplayHeight()},
+    .inDim         = {detection.getModelWidth(), detection.getModelHeight()},
+    .trackResult   = false,
+    .logResult     = false,
+    .nativeDecoder = true,
+  };
+  decoder.addBoundingBoxes(pipeline, decOptions);
+
+  pipeline.parse(options.graphPath);
+  decoder.connectBoundingBoxes(pipeline);
+
+  BatchResults results;
+  results.decoder = &decoder;
+  results.batch = &batch;
+  results.width = pipeline.getDisplayWidth();
+  results.height = pipeline.getDisplayHeight();
+  results.file.open(options.outputDir / "detections.jsonl");
+  if (!results.file.is_open()) {
+    log_error("Could not open %s\n", (options.outputDir / "detections.jsonl").c_str());
+    return 1;
+  }
+  pipeline.connectToElementSignal(decoder.getBoundingBoxesSinkName(),
+                                  batchResultsCallback,
+                                  "new-data",
+                                  &results);
+  batch.connectImageBatch(pipeline);
+
+  auto start = std::chrono::steady_clock::now();
+  if (!pipeline.runToCompletion()) {
+    log_error("Processing of %s failed\n", options.imageDir.c_str());
+    return 1;
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  log_info("Processed %lu images in %.1f s, %.1f images/s\n",
+           static_cast<unsigned long>(results.numImages),
+           seconds,
+           (seconds > 0) ? results.numImages / seconds : 0.0);
+  return (results.numImages > 0) ? 0 : 1;
+}
+
+
 int main(int argc, char **argv)
 {
   // Initialize command line parser with default values
@@ -218,15 +535,32 @@ int main(int argc, char **argv)
   options.camWidth = 640;
   options.camHeight = 480;
   options.framerate = 30;
+  options.numJobs = 0;
+  options.letterbox = false;
   if (cmdParser(argc, argv, options))
     return 0;
 
+  if (!options.outputDir.empty()) {
+    if (!options.imageDir.empty())
+      return runImageBatch(options);
+    if (options.videoPath.empty()) {
+      log_error("Offline mode needs video files or an image directory\n");
+      return 1;
+    }
+    return runOffline(options);
+  }
+
   // Initialize pipeline object
   GstPipelineImx pipeline;
 
   bool UseCameraSource = options.videoPath.empty();
-  
-  if (UseCameraSource) {
+
+  // Frame bus is shared by several processes, it must outlive the pipeline
+  std::unique_ptr<GstFrameBusImx> frameBus;
+  if (!options.frameBus.empty()) {
+    frameBus = std::make_unique<GstFrameBusImx>(options.frameBus);
+    frameBus->addFrameBusToPipeline(pipeline);
+  } else if (UseCameraSource) {
     // Add camera to pipeline
     CameraOptions camOpt = {
       .cameraDevice   = options.camDevice,
@@ -259,6 +593,7 @@ int main(int argc, char **argv)
 
   // Add model inference
   TFliteModelInfos detection(options.modelPath, options.backend, options.norm);
+  detection.setLetterbox(options.letterbox);
   detection.addInferenceToPipeline(pipeline, "detection_filter");
 
   // Add NNStreamer inference output decoding
@@ -270,29 +605,18 @@ int main(int argc, char **argv)
   };
 
   BoundingBoxesOptions decOptions = {
-    .modelName    = ModeBoundingBoxes::mobilenetssd,
-    .labelsPath   = options.dataDir.labelsDir.string(),
-    .option3      = setCustomOptions(customOptions),
-    .outDim       = {pipeline.getDisplayWidth(), pipeline.getDisplayHeight()},
-    .inDim        = {detection.getModelWidth(), detection.getModelHeight()},
-    .trackResult  = false,
-    .logResult    = false,
+    .modelName     = ModeBoundingBoxes::mobilenetssd,
+    .labelsPath    = options.dataDir.labelsDir.string(),
+    .option3       = setCustomOptions(customOptions),
+    .outDim        = {pipeline.getDisplayWidth(), pipeline.getDisplayHeight()},
+    .inDim         = {detection.getModelWidth(), detection.getModelHeight()},
+    .trackResult   = false,
+    .logResult     = false,
+    .nativeDecoder = true,
+    .letterbox     = detection.getLetterbox(),
   };
   decoder.addBoundingBoxes(pipeline, decOptions);
 
-  // Initialize compositor element
-  std::string compositorName = "mix";
-  GstVideoCompositorImx compositor(compositorName);
-
-  // Add tensor decoder output to the compositor
-  compositorInputParams firstInputParams = {
-    .position     = displayPosition::center,
-    .order        = 2,
-    .keepRatio    = false,
-    .transparency = true,
-  };
-  compositor.addToCompositor(pipeline, firstInputParams);
-
   // Add a branch to tee element to display result
   GstQueueOptions imgQueue = {
     .queueName     = "thread-img",
@@ -301,33 +625,8 @@ int main(int argc, char **argv)
   };
   pipeline.addBranch(teeName, imgQueue);
 
-  // Set latency of model for video compositor
-  long long latency;
-  imx::Imx imx{};
-  if (options.backend == "NPU") {
-    if (imx.isIMX8())
-      latency = getLatencyFromEnv("LATENCY_NPU", MODEL_LATENCY_NS_NPU_VSI);
-    else if (imx.hasEthosNPU())
-      latency = getLatencyFromEnv("LATENCY_NPU", MODEL_LATENCY_NS_NPU_ETHOS);
-    else
-      latency = getLatencyFromEnv("LATENCY_NPU", MODEL_LATENCY_NS_NPU_NEUTRON);
-  } else if (imx.isIMX8() && (options.backend == "GPU")) {
-    latency = getLatencyFromEnv("LATENCY_GPU", MODEL_LATENCY_NS_GPU_VSI);
-  } else {
-    latency = getLatencyFromEnv("LATENCY_CPU", MODEL_LATENCY_NS_CPU);
-  }
-
-  // Add camera input to the compositor
-  compositorInputParams secondInputParams = {
-    .position     = displayPosition::center,
-    .order        = 1,
-    .keepRatio    = false,
-    .transparency = false,
-  };
-  compositor.addToCompositor(pipeline, secondInputParams);
-
-  // Compositing pipeline input video with model processed output
-  compositor.addCompositorToPipeline(pipeline, latency);
+  // Draw decoded boxes over the camera stream
+  decoder.addBoundingBoxesOverlay(pipeline);
 
   // Display processed video
   GstVideoPostProcess postProcess;
@@ -336,6 +635,24 @@ int main(int argc, char **argv)
   // Parse pipeline to GStreamer pipeline
   pipeline.parse(options.graphPath);
 
+  // Connect native decoder to tensor sink and overlay
+  decoder.connectBoundingBoxes(pipeline);
+
+  if (frameBus)
+    frameBus->connectFrameBus(pipeline);
+
+  // Publish detections to other processes
+  std::unique_ptr<ResultsPublisher> publisher;
+  if (!options.resultsSocket.empty() || !options.resultsShm.empty()) {
+    ResultsPublisherOptions publisherOptions = {
+      .socketPath = options.resultsSocket,
+      .socketFormat = ResultsFormat::json,
+      .shmName = options.resultsShm,
+    };
+    publisher = std::make_unique<ResultsPublisher>(publisherOptions);
+    decoder.setResultsPublisher(publisher.get(), "detection");
+  }
+
   // Run GStreamer pipeline
   pipeline.run();
 
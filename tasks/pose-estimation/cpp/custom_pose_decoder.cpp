@@ -1,11 +1,17 @@
 /**
- * Copyright 2024-2025 NXP
+ * Copyright 2024-2026 NXP
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include "custom_pose_decoder.hpp"
 
 #include <math.h>
+#include <algorithm>
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define POSE_DECODER_NEON
+#endif
 
 BufferInfo getTensorInfo(GstBuffer* buffer, int tensorIndex)
 {
@@ -40,6 +46,203 @@ void checkNumTensor(GstBuffer* buffer, int numTensor)
 }
 
 
+/**
+ * @brief Affine mapping of model output coordinates to frame pixels.
+ */
+typedef struct {
+  float xScale;
+  float xOffset;
+  float yScale;
+  float yOffset;
+} RegionMapping;
+
+
+/**
+ * @brief Get mapping of normalized model output coordinates to pixels of
+ *        the frame, through letterbox padding and the region given to the
+ *        model.
+ *
+ * @param kptsData: decoder data.
+ * @param region: region of the frame given to the model.
+ */
+static RegionMapping regionMapping(const DecoderData* kptsData, const CropRegion &region)
+{
+  // letterboxToFrame is affine, it is applied to 0 and 1 to get it
+  float x0 = letterboxToFrameX(kptsData->letterbox, 0);
+  float y0 = letterboxToFrameY(kptsData->letterbox, 0);
+  float x1 = letterboxToFrameX(kptsData->letterbox, 1);
+  float y1 = letterboxToFrameY(kptsData->letterbox, 1);
+  RegionMapping mapping;
+  mapping.xScale = (x1 - x0) * region.width;
+  mapping.xOffset = region.x + x0 * region.width;
+  mapping.yScale = (y1 - y0) * region.height;
+  mapping.yOffset = region.y + y0 * region.height;
+  return mapping;
+}
+
+
+/**
+ * @brief Decode keypoints of a person, mapping coordinates to pixels of the
+ *        frame and thresholding scores.
+ *
+ * @param kptsData: decoder data.
+ * @param data: model output of the person, interleaved keypoints data.
+ * @param region: region of the frame given to the model.
+ * @param kpts: keypoints to fill.
+ * @param person: index of the person in keypoints.
+ */
+static void decodeKeypoints(const DecoderData* kptsData,
+                            const float* data,
+                            const CropRegion &region,
+                            Keypoints &kpts,
+                            const int &person)
+{
+  int offset = person * POSE_NUM_KEYPOINTS;
+  float* x = kpts.x + offset;
+  float* y = kpts.y + offset;
+  uint32_t* valid = kpts.valid + offset;
+  RegionMapping mapping = regionMapping(kptsData, region);
+
+  int i = 0;
+#ifdef POSE_DECODER_NEON
+  // Deinterleave 4 keypoints at once
+  float32x4_t xOffset = vdupq_n_f32(mapping.xOffset);
+  float32x4_t yOffset = vdupq_n_f32(mapping.yOffset);
+  float32x4_t xScale = vdupq_n_f32(mapping.xScale);
+  float32x4_t yScale = vdupq_n_f32(mapping.yScale);
+  float32x4_t thresholdVec = vdupq_n_f32(kptsData->scoreThreshold);
+  for (; i + 4 <= POSE_NUM_KEYPOINTS; i += 4) {
+    float32x4x3_t kpt = vld3q_f32(data + POSE_KEYPOINT_DATA * i);
+    vst1q_f32(x + i, vmlaq_f32(xOffset, kpt.val[kptsData->xIndex], xScale));
+    vst1q_f32(y + i, vmlaq_f32(yOffset, kpt.val[kptsData->yIndex], yScale));
+    vst1q_u32(valid + i, vcgeq_f32(kpt.val[kptsData->scoreIndex], thresholdVec));
+  }
+#endif
+  for (; i < POSE_NUM_KEYPOINTS; i++) {
+    const float* kpt = data + POSE_KEYPOINT_DATA * i;
+    x[i] = mapping.xOffset + kpt[kptsData->xIndex] * mapping.xScale;
+    y[i] = mapping.yOffset + kpt[kptsData->yIndex] * mapping.yScale;
+    valid[i] = (kpt[kptsData->scoreIndex] >= kptsData->scoreThreshold) ? UINT32_MAX : 0;
+  }
+}
+
+
+/**
+ * @brief Get region of the frame given to the model for an inference.
+ *
+ * @param kptsData: decoder data.
+ * @param pts: timestamp of the inference output.
+ */
+static CropRegion getCropRegion(DecoderData* kptsData, const GstClockTime &pts)
+{
+  CropRegion full = {0, 0, kptsData->inputDim, kptsData->inputDim};
+  if (kptsData->smartCrop == false)
+    return full;
+
+  std::lock_guard<std::mutex> lock(kptsData->cropMutex);
+  if (kptsData->appliedIndex == 0)
+    return full;
+  int count = std::min(kptsData->appliedIndex, SMART_CROP_HISTORY);
+  for (int i = 1; i <= count; i++) {
+    int index = (kptsData->appliedIndex - i) % SMART_CROP_HISTORY;
+    if (kptsData->appliedPts[index] == pts)
+      return kptsData->appliedCrops[index];
+  }
+  // Timestamp not found, use latest region
+  return kptsData->appliedCrops[(kptsData->appliedIndex - 1) % SMART_CROP_HISTORY];
+}
+
+
+/**
+ * @brief Compute model input region for next frame from the keypoints of
+ *        current one, as done by MoveNet smart cropping. Whole frame is used
+ *        when the torso is not visible.
+ *
+ * @param kptsData: decoder data.
+ * @param data: model output of the person, interleaved keypoints data.
+ * @param region: region of the frame given to the model.
+ */
+static CropRegion computeCropRegion(const DecoderData* kptsData,
+                                    const float* data,
+                                    const CropRegion &region)
+{
+  const int dim = kptsData->inputDim;
+  CropRegion full = {0, 0, dim, dim};
+  float x[POSE_NUM_KEYPOINTS];
+  float y[POSE_NUM_KEYPOINTS];
+  bool visible[POSE_NUM_KEYPOINTS];
+  RegionMapping mapping = regionMapping(kptsData, region);
+  for (int i = 0; i < POSE_NUM_KEYPOINTS; i++) {
+    const float* kpt = data + POSE_KEYPOINT_DATA * i;
+    x[i] = mapping.xOffset + kpt[kptsData->xIndex] * mapping.xScale;
+    y[i] = mapping.yOffset + kpt[kptsData->yIndex] * mapping.yScale;
+    visible[i] = (kpt[kptsData->scoreIndex] > SMART_CROP_MIN_SCORE);
+  }
+
+  // Shoulders and hips
+  const int torso[4] = {5, 6, 11, 12};
+  bool torsoVisible = (visible[11] || visible[12]) && (visible[5] || visible[6]);
+  if (torsoVisible == false)
+    return full;
+
+  float centerX = (x[11] + x[12]) / 2;
+  float centerY = (y[11] + y[12]) / 2;
+  float torsoRange = 0;
+  for (int i : torso) {
+    torsoRange = std::max(torsoRange, std::abs(centerX - x[i]));
+    torsoRange = std::max(torsoRange, std::abs(centerY - y[i]));
+  }
+  float bodyRange = 0;
+  for (int i = 0; i < POSE_NUM_KEYPOINTS; i++) {
+    if (visible[i] == false)
+      continue;
+    bodyRange = std::max(bodyRange, std::abs(centerX - x[i]));
+    bodyRange = std::max(bodyRange, std::abs(centerY - y[i]));
+  }
+
+  float halfLength = std::max(torsoRange * SMART_CROP_TORSO_EXPANSION,
+                              bodyRange * SMART_CROP_BODY_EXPANSION);
+  float borderDistance = std::max({centerX, dim - centerX, centerY, dim - centerY});
+  halfLength = std::min(halfLength, borderDistance);
+  if (halfLength * 2 >= dim)
+    return full;
+
+  // Square region shifted inside the frame, with even values for YUV formats
+  int length = std::max(static_cast<int>(halfLength * 2), SMART_CROP_MIN_SIZE) & ~1;
+  CropRegion crop;
+  crop.x = std::clamp(static_cast<int>(centerX - halfLength), 0, dim - length) & ~1;
+  crop.y = std::clamp(static_cast<int>(centerY - halfLength), 0, dim - length) & ~1;
+  crop.width = length;
+  crop.height = length;
+  return crop;
+}
+
+
+/**
+ * @brief Add valid keypoints of a person to published results.
+ *
+ * @param kptsData: decoder data.
+ * @param data: model output of the person, interleaved keypoints data.
+ * @param kpts: decoded keypoints.
+ * @param person: index of the person in keypoints.
+ */
+static void addResultKeypoints(DecoderData* kptsData,
+                               const float* data,
+                               const Keypoints &kpts,
+                               const int &person)
+{
+  int offset = person * POSE_NUM_KEYPOINTS;
+  for (int i = 0; i < POSE_NUM_KEYPOINTS; i++) {
+    if (kpts.valid[offset + i] == 0)
+      continue;
+    kptsData->results.keypoints.push_back({kpts.x[offset + i],
+                                           kpts.y[offset + i],
+                                           data[i * POSE_KEYPOINT_DATA + kptsData->scoreIndex],
+                                           person});
+  }
+}
+
+
 void newDataCallback(GstElement* element,
                      GstBuffer* buffer,
                      gpointer user_data)
@@ -50,25 +253,66 @@ void newDataCallback(GstElement* element,
   checkNumTensor(buffer, 1);
   bufferInfo = getTensorInfo(buffer, 0);
 
-  int row = 0;
-  int col = 0;
-  float score = 0;
-  float valid = 0;
-  for (int i = 0; i < bufferInfo.size; i++) {
+  Keypoints &kpts = kptsData->npKpts.writeBuffer();
+  const float* data = bufferInfo.bufferFP32;
+  CropRegion region = getCropRegion(kptsData, GST_BUFFER_PTS(buffer));
+  CropRegion nextRegion = {0, 0, kptsData->inputDim, kptsData->inputDim};
+  kptsData->results.boxes.clear();
+  kptsData->results.keypoints.clear();
 
-    if ((col == kptsData->xIndex) or (col == kptsData->yIndex)) {
-      kptsData->npKpts[row][col] = bufferInfo.bufferFP32[i] * kptsData->inputDim;
-    } else {
-      kptsData->npKpts[row][col] = bufferInfo.bufferFP32[i];
-      score = kptsData->npKpts[row][kptsData->scoreIndex];
-      valid = (score >= kptsData->scoreThreshold);
-      kptsData->npKpts[row][col] = valid;
+  // Model is identified by its output size
+  if (bufferInfo.size == POSE_NUM_KEYPOINTS * POSE_KEYPOINT_DATA) {
+    // MoveNet SinglePose: [1, 1, 17, 3]
+    decodeKeypoints(kptsData, data, region, kpts, 0);
+    if (kptsData->resultsPublisher != nullptr)
+      addResultKeypoints(kptsData, data, kpts, 0);
+    kpts.numPersons = 1;
+    kpts.hasBoxes = false;
+    if (kptsData->smartCrop)
+      nextRegion = computeCropRegion(kptsData, data, region);
+  } else if (bufferInfo.size == MULTIPOSE_MAX_PERSONS * MULTIPOSE_PERSON_DATA) {
+    // MoveNet MultiPose: [1, 6, 56]
+    int numPersons = 0;
+    RegionMapping mapping = regionMapping(kptsData, region);
+    for (int i = 0; i < MULTIPOSE_MAX_PERSONS; i++) {
+      const float* person = data + i * MULTIPOSE_PERSON_DATA;
+      if (person[MULTIPOSE_SCORE_INDEX] < kptsData->scoreThreshold)
+        continue;
+
+      decodeKeypoints(kptsData, person, region, kpts, numPersons);
+      const float* box = person + MULTIPOSE_BOX_INDEX;
+      kpts.boxes[numPersons][0] = mapping.xOffset + box[1] * mapping.xScale;
+      kpts.boxes[numPersons][1] = mapping.yOffset + box[0] * mapping.yScale;
+      kpts.boxes[numPersons][2] = mapping.xOffset + box[3] * mapping.xScale;
+      kpts.boxes[numPersons][3] = mapping.yOffset + box[2] * mapping.yScale;
+      if (kptsData->resultsPublisher != nullptr) {
+        addResultKeypoints(kptsData, person, kpts, numPersons);
+        kptsData->results.boxes.push_back(makeResultBox(kpts.boxes[numPersons][0],
+                                                        kpts.boxes[numPersons][1],
+                                                        kpts.boxes[numPersons][2],
+                                                        kpts.boxes[numPersons][3],
+                                                        person[MULTIPOSE_SCORE_INDEX],
+                                                        0,
+                                                        "person"));
+      }
+      numPersons += 1;
     }
+    kpts.numPersons = numPersons;
+    kpts.hasBoxes = true;
+  } else {
+    log_error("Unexpected pose model output size: %d\n", bufferInfo.size);
+    exit(-1);
+  }
+  kptsData->npKpts.publish();
+
+  if (kptsData->resultsPublisher != nullptr) {
+    kptsData->results.pts = GST_BUFFER_PTS(buffer);
+    kptsData->resultsPublisher->publish(kptsData->results);
+  }
 
-    col+=1;
-    if (col == 3)
-      row += 1;
-    col = col % 3;
+  if (kptsData->smartCrop) {
+    std::lock_guard<std::mutex> lock(kptsData->cropMutex);
+    kptsData->nextCrop = nextRegion;
   }
 }
 
@@ -80,56 +324,156 @@ void drawCallback(GstElement* overlay,
                   gpointer user_data)
 {
   DecoderData* kptsData = (DecoderData *) user_data;
-  float valid;
-  float* npKpt;
-  float xKpt;
-  float yKpt;
-  int* connections;
-  float* npConnect;
-  float xConnect;
-  float yConnect;
-  cairo_select_font_face(cr,
-                         "Arial",
-                         CAIRO_FONT_SLANT_NORMAL,
-                         CAIRO_FONT_WEIGHT_NORMAL);
-  cairo_set_line_width(cr, 1.0);
-
-  for(int i = 0; i < kptsData->kptSize; i++) {
-    npKpt = kptsData->npKpts[i];
-    valid = npKpt[kptsData->scoreIndex];
-    if ((valid != 1.0))
-      continue;
+  // Only render results again when new ones are available
+  kptsData->npKpts.update();
+  cairo_t* layer = kptsData->overlay.beginRender(cr, kptsData->npKpts.getGeneration());
+  if (layer != nullptr) {
+    const Keypoints &kpts = kptsData->npKpts.readBuffer();
+    int numKpts = kpts.numPersons * POSE_NUM_KEYPOINTS;
+    cairo_set_line_width(layer, 1.0);
+
+    // Draw keypoint spots of all persons in a single path
+    cairo_set_source_rgb(layer, 1, 0, 0);
+    for (int i = 0; i < numKpts; i++) {
+      if (kpts.valid[i] == 0)
+        continue;
+      cairo_new_sub_path(layer);
+      cairo_arc(layer, kpts.x[i], kpts.y[i], 1, 0, 2*M_PI);
+    }
+    cairo_fill(layer);
 
-    xKpt = npKpt[kptsData->xIndex];
-    yKpt = npKpt[kptsData->yIndex];
-
-    // Draw keypoint spot
-    cairo_set_source_rgb(cr, 1, 0, 0);
-    cairo_arc(cr, xKpt, yKpt, 1, 0, 2*M_PI);
-    cairo_fill(cr);
-    cairo_stroke(cr);
-    
-    // Draw keypoint label
-    cairo_set_source_rgb(cr, 0, 1, 1);
-    cairo_set_font_size(cr, 10.0);
-    cairo_move_to(cr, xKpt + 5, yKpt + 5);
-    cairo_show_text(cr, kptsData->kptLabels[i].c_str());
-
-    // Draw keypoint connections
-    cairo_set_source_rgb(cr, 0, 1, 0);
-    connections = kptsData->kptConnect[i];
-    for(int j = 0; j < 3; j++) {
-      if (connections[j] == -1)
-        break;
-      npConnect = kptsData->npKpts[connections[j]];
-      valid = npConnect[kptsData->scoreIndex];
-      if (valid != 1.0)
+    // Draw keypoint connections, each one only once
+    cairo_set_source_rgb(layer, 0, 1, 0);
+    for (int i = 0; i < numKpts; i++) {
+      if (kpts.valid[i] == 0)
         continue;
-      xConnect = npConnect[kptsData->xIndex];
-      yConnect = npConnect[kptsData->yIndex];
-      cairo_move_to(cr, xKpt, yKpt);
-      cairo_line_to(cr, xConnect, yConnect);
+      int kpt = i % POSE_NUM_KEYPOINTS;
+      int offset = i - kpt;
+      int* connections = kptsData->kptConnect[kpt];
+      for (int j = 0; j < 3; j++) {
+        if (connections[j] == -1)
+          break;
+        int connect = offset + connections[j];
+        if ((connections[j] < kpt) || (kpts.valid[connect] == 0))
+          continue;
+        cairo_move_to(layer, kpts.x[i], kpts.y[i]);
+        cairo_line_to(layer, kpts.x[connect], kpts.y[connect]);
+      }
     }
-    cairo_stroke(cr);
+    cairo_stroke(layer);
+
+    if (kpts.hasBoxes) {
+      // Draw person boxes
+      cairo_set_source_rgb(layer, 1, 1, 0);
+      for (int i = 0; i < kpts.numPersons; i++) {
+        const float* box = kpts.boxes[i];
+        cairo_rectangle(layer, box[0], box[1], box[2] - box[0], box[3] - box[1]);
+      }
+      cairo_stroke(layer);
+    } else {
+      // Draw keypoint labels, skipped in crowded scenes
+      cairo_set_source_rgb(layer, 0, 1, 1);
+      cairo_set_font_size(layer, 10.0);
+      for (int i = 0; i < numKpts; i++) {
+        if (kpts.valid[i] == 0)
+          continue;
+        cairo_move_to(layer, kpts.x[i] + 5, kpts.y[i] + 5);
+        cairo_show_text(layer, kptsData->kptLabels[i].c_str());
+      }
+    }
+  }
+  kptsData->overlay.paint(cr);
+}
+
+
+/**
+ * @brief Enable smart cropping of model input.
+ *
+ * @param crop: videocrop element feeding the model.
+ * @param kptsData: decoder data.
+ */
+void initSmartCrop(GstElement* crop, DecoderData* kptsData)
+{
+  if (crop == nullptr) {
+    log_error("Can't find crop element for smart cropping\n");
+    exit(-1);
+  }
+  kptsData->cropElement = crop;
+  kptsData->nextCrop = {0, 0, kptsData->inputDim, kptsData->inputDim};
+  kptsData->currentCrop = kptsData->nextCrop;
+  kptsData->smartCrop = true;
+
+  GstPad* pad = gst_element_get_static_pad(crop, "sink");
+  gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, cropProbeCallback, kptsData, NULL);
+  gst_object_unref(pad);
+}
+
+
+/**
+ * @brief Snap target crop region to the grid, or keep current region when
+ *        target is within hysteresis of it.
+ *
+ * @param target: crop region computed from last keypoints.
+ * @param current: crop region applied to the crop element.
+ * @param dim: model input dimension.
+ */
+static CropRegion snapCropRegion(const CropRegion &target,
+                                 const CropRegion &current,
+                                 const int &dim)
+{
+  if ((std::abs(target.x - current.x) <= SMART_CROP_HYSTERESIS)
+      && (std::abs(target.y - current.y) <= SMART_CROP_HYSTERESIS)
+      && (std::abs(target.width - current.width) <= SMART_CROP_HYSTERESIS)
+      && (std::abs(target.height - current.height) <= SMART_CROP_HYSTERESIS))
+    return current;
+
+  auto snap = [](const int &value) {
+    return (value + SMART_CROP_GRID / 2) / SMART_CROP_GRID * SMART_CROP_GRID;
+  };
+  int length = std::clamp(snap(target.width), SMART_CROP_GRID, dim);
+  if (length >= dim - SMART_CROP_GRID / 2)
+    return {0, 0, dim, dim};
+
+  CropRegion crop;
+  crop.x = std::clamp(snap(target.x), 0, dim - length) & ~1;
+  crop.y = std::clamp(snap(target.y), 0, dim - length) & ~1;
+  crop.width = length;
+  crop.height = length;
+  return crop;
+}
+
+
+/**
+ * @brief Apply latest crop region before a frame enters the crop element,
+ *        and record it to map inference output of this frame.
+ */
+GstPadProbeReturn cropProbeCallback(GstPad* pad,
+                                    GstPadProbeInfo* info,
+                                    gpointer user_data)
+{
+  DecoderData* kptsData = (DecoderData *) user_data;
+  GstBuffer* buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+  CropRegion region;
+  {
+    std::lock_guard<std::mutex> lock(kptsData->cropMutex);
+    region = snapCropRegion(kptsData->nextCrop, kptsData->currentCrop, kptsData->inputDim);
+    int index = kptsData->appliedIndex % SMART_CROP_HISTORY;
+    kptsData->appliedCrops[index] = region;
+    kptsData->appliedPts[index] = GST_BUFFER_PTS(buffer);
+    kptsData->appliedIndex += 1;
+  }
+
+  const CropRegion &current = kptsData->currentCrop;
+  if ((region.x != current.x) || (region.y != current.y)
+      || (region.width != current.width) || (region.height != current.height)) {
+    int dim = kptsData->inputDim;
+    g_object_set(G_OBJECT(kptsData->cropElement),
+                 "left", region.x,
+                 "top", region.y,
+                 "right", dim - region.x - region.width,
+                 "bottom", dim - region.y - region.height,
+                 NULL);
+    kptsData->currentCrop = region;
   }
+  return GST_PAD_PROBE_OK;
 }
@@ -1,5 +1,5 @@
 /**
- * Copyright 2024-2025 NXP
+ * Copyright 2024-2026 NXP
  * SPDX-License-Identifier: BSD-3-Clause 
  */ 
 
@@ -11,16 +11,70 @@
 #include <glib.h>
 #include <glib-unix.h>
 #include <cairo.h>
+#include <cstdint>
+#include <mutex>
 
+#include "cached_overlay.hpp"
+#include "letterbox.hpp"
 #include "logging.hpp"
+#include "results_publisher.hpp"
+#include "triple_buffer.hpp"
 
+
+#define POSE_NUM_KEYPOINTS                17
+#define POSE_KEYPOINT_DATA                3
+// MoveNet MultiPose output: 17 keypoints, box and score for each person
+#define MULTIPOSE_MAX_PERSONS             6
+#define MULTIPOSE_PERSON_DATA             56
+#define MULTIPOSE_BOX_INDEX               51
+#define MULTIPOSE_SCORE_INDEX             55
+
+
+// MoveNet smart cropping parameters
+#define SMART_CROP_MIN_SCORE              0.2f
+#define SMART_CROP_TORSO_EXPANSION        1.9f
+#define SMART_CROP_BODY_EXPANSION         1.2f
+#define SMART_CROP_MIN_SIZE               32
+#define SMART_CROP_HISTORY                8
+// Crop regions are snapped to a grid, and only move when the target region
+// is more than a grid step away, so that videocrop is rarely renegotiated
+#define SMART_CROP_GRID                   16
+#define SMART_CROP_HYSTERESIS             SMART_CROP_GRID
+
+
+/**
+ * @brief Region of the input frame given to the model, in pixels.
+ */
 typedef struct {
-  int kptSize = 17;
+  int x;
+  int y;
+  int width;
+  int height;
+} CropRegion;
+
+
+/**
+ * @brief Decoded keypoints of all persons, stored as structure of arrays
+ *        indexed by person * POSE_NUM_KEYPOINTS + keypoint.
+ */
+typedef struct {
+  int numPersons = 0;
+  bool hasBoxes = false;
+  float x[MULTIPOSE_MAX_PERSONS * POSE_NUM_KEYPOINTS];
+  float y[MULTIPOSE_MAX_PERSONS * POSE_NUM_KEYPOINTS];
+  uint32_t valid[MULTIPOSE_MAX_PERSONS * POSE_NUM_KEYPOINTS];
+  // xmin, ymin, xmax, ymax of each person in pixels
+  float boxes[MULTIPOSE_MAX_PERSONS][4];
+} Keypoints;
+
+
+typedef struct {
+  int kptSize = POSE_NUM_KEYPOINTS;
   int yIndex = 0;
   int xIndex = 1;
   int scoreIndex = 2;
   float scoreThreshold = 0.4;
-  float npKpts[17][3];
+  TripleBuffer<Keypoints> npKpts;
   std::string kptLabels[17] = {
       "nose", "left_eye", "right_eye", "left_ear",
       "right_ear", "left_shoulder", "right_shoulder",
@@ -33,6 +87,22 @@ typedef struct {
       {8, -1, -1}, {5, 12, 13}, {6, 11, 14}, {11, 15, -1},
       {12, 16, -1}, {13, -1, -1}, {14, -1, -1}};
   int inputDim;
+  // Placement of frame in model input, keypoints are mapped back to frame
+  Letterbox letterbox{};
+  CachedOverlay overlay;
+  // Smart cropping of model input, only for single pose model
+  bool smartCrop = false;
+  GstElement* cropElement = nullptr;
+  std::mutex cropMutex;
+  CropRegion nextCrop = {0, 0, 0, 0};
+  CropRegion currentCrop = {0, 0, 0, 0};
+  // Crop regions applied to last frames, indexed by frame timestamp
+  CropRegion appliedCrops[SMART_CROP_HISTORY];
+  GstClockTime appliedPts[SMART_CROP_HISTORY];
+  int appliedIndex = 0;
+  // Keypoints of each frame published to other processes, if set
+  ResultsPublisher* resultsPublisher = nullptr;
+  FrameResults results;
 } DecoderData;
 
 
@@ -48,6 +118,14 @@ void drawCallback(GstElement* overlay,
                   gpointer user_data);
 
 
+void initSmartCrop(GstElement* crop, DecoderData* kptsData);
+
+
+GstPadProbeReturn cropProbeCallback(GstPad* pad,
+                                    GstPadProbeInfo* info,
+                                    gpointer user_data);
+
+
 typedef struct {
   int size;
   float* bufferFP32;
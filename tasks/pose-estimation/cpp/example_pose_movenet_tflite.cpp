@@ -6,13 +6,16 @@
 /**
  * NNstreamer application for pose detection using tensorflow-lite.
  * The model used is movenet_single_pose_lightning.tflite which can be retrieved from https://github.com/nxp-imx/nxp-nnstreamer-examples/blob/main/downloads/download.ipynb
+ * MoveNet MultiPose models with a fixed input size are also supported, and detected from their output tensor size.
  *  
+ * With smart cropping, model input is cropped around the person found in previous frame.
+ *
  * Pipeline:
- * filesrc -- videocrop -- tee -----------------------------------------------------------------------------------
- *                          |                                                                                     |
- *                          |                                                                               cairooverlay -- waylandsink
- *                          |                                                                                     |
- *                           --- imxvideoconvert -- tensor_converter -- tensor_transform -- tensor_filter -- tensor_sink
+ * filesrc -- videocrop -- tee ------------------------------------------------------------------------------------------------
+ *                          |                                                                                                  |
+ *                          |                                                                                            cairooverlay -- waylandsink
+ *                          |                                                                                                  |
+ *                           --- [videocrop] -- imxvideoconvert -- tensor_converter -- tensor_transform -- tensor_filter -- tensor_sink
  */
 
 #include "common.hpp"
@@ -43,6 +46,10 @@ typedef struct {
   int camHeight;
   int framerate;
   bool useGpu3D;
+  bool smartCrop;
+  std::filesystem::path resultsSocket;
+  std::string resultsShm;
+  std::filesystem::path frameBus;
 } ParserOptions;
 
 
@@ -66,12 +73,16 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
     {"graph_path",    required_argument, 0, 'g'},
     {"cam_params",    required_argument, 0, 'r'},
     {"use_gpu3d",     required_argument, 0, 'u'},
+    {"smart_crop",    required_argument, 0, 's'},
+    {"results_socket", required_argument, 0, 'k'},
+    {"results_shm",   required_argument, 0, 'm'},
+    {"frame_bus",     required_argument, 0, 'a'},
     {0,               0,                 0,   0}
   };
 
   while ((c = getopt_long(argc,
                           argv,
-                          "hb:n:c:p:f:d::t:g:r:u:",
+                          "hb:n:c:p:f:d::t:g:r:u:s:k:m:a:",
                           longOptions,
                           &optionIndex)) != -1) {
     switch (c)
@@ -85,7 +96,7 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
 
                   << std::setw(25) << std::left << "  -b, --backend"
                   << std::setw(25) << std::left
-                  << "Use the selected backend (CPU,GPU,NPU)" << std::endl
+                  << "Use the selected backend (CPU,GPU,NPU,auto)" << std::endl
 
                   << std::setw(25) << std::left << "  -n, --normalization"
                   << std::setw(25) << std::left
@@ -124,7 +135,24 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
                   
                   << std::setw(25) << std::left << "  -u, --use_gpu3d"
                   << std::setw(25) << std::left
-                  << "Use the 3D GPU hardware acceleration for video transformation (if available)" << std::endl;
+                  << "Use the 3D GPU hardware acceleration for video transformation (if available)" << std::endl
+
+                  << std::setw(25) << std::left << "  -s, --smart_crop"
+                  << std::setw(25) << std::left
+                  << "Crop model input around person detected in previous frame (single pose model only)" << std::endl
+
+                  << std::setw(25) << std::left << "  -k, --results_socket"
+                  << std::setw(25) << std::left
+                  << "Publish keypoints of each frame as JSON lines on this Unix socket path" << std::endl
+
+                  << std::setw(25) << std::left << "  -m, --results_shm"
+                  << std::setw(25) << std::left
+                  << "Publish keypoints of each frame as binary records in this shared memory ring"
+                  << " (e.g. /pose)" << std::endl
+
+                  << std::setw(25) << std::left << "  -a, --frame_bus"
+                  << std::setw(25) << std::left
+                  << "Use frames of a frame bus publisher (socket path) instead of camera source" << std::endl;
         return 1;
  
       case 'b':
@@ -191,6 +219,25 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
           options.useGpu3D = false;
         break;
 
+      case 's':
+        if (optarg != nullptr)
+          options.smartCrop = (std::string(optarg) == "true");
+        else
+          options.smartCrop = true;
+        break;
+
+      case 'k':
+        options.resultsSocket.assign(optarg);
+        break;
+
+      case 'm':
+        options.resultsShm.assign(optarg);
+        break;
+
+      case 'a':
+        options.frameBus.assign(optarg);
+        break;
+
       default:
         break;
     }
@@ -211,6 +258,7 @@ int main(int argc, char **argv)
   options.camHeight = 480;
   options.framerate = 30;
   options.useGpu3D = false;
+  options.smartCrop = true;
   if (cmdParser(argc, argv, options))
     return 0;
 
@@ -226,7 +274,13 @@ int main(int argc, char **argv)
   GstPipelineImx pipeline;
 
   int cropDim;
-  if (options.videoPath.empty()) {
+  // Frame bus is shared by several processes, it must outlive the pipeline
+  std::unique_ptr<GstFrameBusImx> frameBus;
+  if (!options.frameBus.empty()) {
+    frameBus = std::make_unique<GstFrameBusImx>(options.frameBus);
+    frameBus->addFrameBusToPipeline(pipeline);
+    cropDim = std::min(frameBus->getWidth(), frameBus->getHeight());
+  } else if (options.videoPath.empty()) {
     // Add camera to pipeline
     CameraOptions camOpt = {
       .cameraDevice   = options.camDevice,
@@ -267,6 +321,11 @@ int main(int argc, char **argv)
   };
   pipeline.addBranch(teeName, nnQueue);
 
+  // Crop region of model input is updated at runtime from previous keypoints
+  std::string roiCropName = "roi_crop";
+  if (options.smartCrop)
+    pipeline.addToPipeline("videocrop name=" + roiCropName + " ! ");
+
   // Add model inference
   TFliteModelInfos pose(options.modelPath, options.backend, options.norm);
   pose.addInferenceToPipeline(pipeline, "pose_filter");
@@ -296,8 +355,29 @@ int main(int argc, char **argv)
   // to process inference output
   DecoderData kptsData;
   kptsData.inputDim = cropDim;
+  kptsData.letterbox = pose.getLetterbox();
   pipeline.connectToElementSignal(tensorSinkName, newDataCallback, "new-data", &kptsData);
   pipeline.connectToElementSignal(overlayName, drawCallback, "draw", &kptsData);
+  if (options.smartCrop) {
+    GstElement* roiCrop = pipeline.getElement(roiCropName);
+    initSmartCrop(roiCrop, &kptsData);
+    gst_object_unref(roiCrop);
+  }
+  if (frameBus)
+    frameBus->connectFrameBus(pipeline);
+
+  // Publish keypoints to other processes
+  std::unique_ptr<ResultsPublisher> publisher;
+  if (!options.resultsSocket.empty() || !options.resultsShm.empty()) {
+    ResultsPublisherOptions publisherOptions = {
+      .socketPath = options.resultsSocket,
+      .socketFormat = ResultsFormat::json,
+      .shmName = options.resultsShm,
+    };
+    publisher = std::make_unique<ResultsPublisher>(publisherOptions);
+    kptsData.results.source = "pose";
+    kptsData.resultsPublisher = publisher.get();
+  }
 
   // Run GStreamer pipeline
   pipeline.run();
@@ -8,11 +8,9 @@
  * The model used is deeplabv3_mnv2_dm05_pascal.tflite which can be retrieved from https://github.com/nxp-imx/nxp-nnstreamer-examples/blob/main/downloads/download.ipynb
  *  
  * Pipeline:
- * multifilesrc -- jpegdec -- imxvideoconvert -- tee -----------------------------------------------------------------
- *                                                |                                                                  |
- *                                                |                                                            imxcompositor -- waylandsink
- *                                                |                                                                  |
- *                                                --- tensor_converter -- tensor_transform -- tensor_filter -- tensor_decoder
+ * multifilesrc -- jpegdec -- imxvideoconvert -- tee -- cairooverlay -- waylandsink
+ *                                                |
+ *                                                --- tensor_converter -- tensor_transform -- tensor_filter -- tensor_sink
  */
 
 #include "common.hpp"
@@ -71,7 +69,7 @@ int cmdParser(int argc, char **argv, ParserOptions& options)
 
                   << std::setw(25) << std::left << "  -b, --backend"
                   << std::setw(25) << std::left
-                  << "Use the selected backend (CPU,GPU,NPU)" << std::endl
+                  << "Use the selected backend (CPU,GPU,NPU,auto)" << std::endl
 
                   << std::setw(25) << std::left << "  -n, --normalization"
                   << std::setw(25) << std::left
@@ -201,29 +199,15 @@ int main(int argc, char **argv)
   // Add model inference
   segmentation.addInferenceToPipeline(pipeline, "seg_filter");
 
-  // Add NNStreamer inference output decoding
+  // Add native decoder, argmax and blending are done on display branch
   NNDecoder decoder;
   ImageSegmentOptions decOptions = {
-    .modelName = ModeImageSegment::tfliteDeeplab,
+    .modelName     = ModeImageSegment::tfliteDeeplab,
+    .nativeDecoder = true,
+    .maskDim       = {segmentation.getModelWidth(), segmentation.getModelHeight()},
   };
   decoder.addImageSegment(pipeline, decOptions);
 
-  // Initialize compositor element
-  std::string compositorName = "mix";
-  GstVideoCompositorImx compositor(compositorName);
-
-  // Set no latency for video compositor so far
-  int latency = 0;
-
-  // Add tensor decoder output to the compositor
-  compositorInputParams firstInputParams = {
-    .position     = displayPosition::center,
-    .order        = 1,
-    .keepRatio    = false,
-    .transparency = false,
-  };
-  compositor.addToCompositor(pipeline, firstInputParams);
-
   // Add a branch to tee element to display result
   GstQueueOptions imgQueue = {
     .queueName     = "thread-img",
@@ -232,21 +216,8 @@ int main(int argc, char **argv)
   };
   pipeline.addBranch(teeName, imgQueue);
 
-  // Add camera input to the compositor
-  compositorInputParams secondInputParams = {
-    .position     = displayPosition::center,
-    .order        = 2,
-    .keepRatio    = false,
-    .transparency = true,
-  };
-  compositor.addToCompositor(pipeline, secondInputParams);
-
-
-  // Use the same alpha value for all devices unless the user overrides it.
-  setenv("ALPHA_VALUE", "0.5", 0);
-
-  // Compositing pipeline input video with model processed output
-  compositor.addCompositorToPipeline(pipeline, latency);
+  // Blend segmentation mask into displayed frame
+  decoder.addImageSegmentOverlay(pipeline);
 
   // Display processed video
   GstVideoPostProcess postProcess;
@@ -256,6 +227,9 @@ int main(int argc, char **argv)
   // Parse pipeline to GStreamer pipeline
   pipeline.parse(options.graphPath);
 
+  // Connect native decoder callbacks
+  decoder.connectImageSegment(pipeline);
+
   // Run GStreamer pipeline
   pipeline.run();
 
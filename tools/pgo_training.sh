@@ -0,0 +1,65 @@
+#!/bin/bash
+#
+# Copyright 2026 NXP
+# SPDX-License-Identifier: BSD-3-Clause
+
+REALPATH="$(readlink -e "$0")"
+BASEDIR="$(dirname "${REALPATH}")/.."
+BASEDIR="$(realpath ${BASEDIR})"
+
+function usage {
+  echo "Training run for profile-guided optimization of C++ examples."
+  echo "Examples built with -DPGO_MODE=generate are run headless on CPU"
+  echo "backend, and write their profiles in directory given by PGO_PROFILE_DIR."
+  echo "syntax:"
+  echo "pgo_training.sh [build directory] [duration per example in seconds]"
+  echo "example:"
+  echo "pgo_training.sh ./build 30"
+}
+
+if [ "$1" == "-h" ] || [ "$1" == "--help" ]; then
+  usage
+  exit 0
+fi
+
+BUILD_DIR="$(realpath "${1:-${BASEDIR}/build}")"
+DURATION="${2:-30}"
+
+# Define models and media paths
+BASEDIR="${BASEDIR}" . "${BASEDIR}/tools/setup_environment.sh"
+
+# Run headless, as fast as possible
+export VIDEO_SINK="fakesink sync=false"
+export LOG_LEVEL="error"
+
+function run_example {
+  local example="${BUILD_DIR}/$1"
+  shift
+  if [ ! -x "${example}" ]; then
+    echo "Skipping $(basename ${example}): not built"
+    return
+  fi
+  echo "Training with $(basename ${example})"
+  # SIGINT stops pipeline cleanly, so profiles are written at exit
+  timeout -s INT -k 10 "${DURATION}" "${example}" "$@" > /dev/null
+}
+
+run_example classification/example_classification_mobilenet_v1_tflite \
+  -p ${MOBILENETV1_QUANT} -l ${MOBILENETV1_LABELS} -f ${POWER_JUMP_VIDEO} -b CPU
+run_example object-detection/example_detection_mobilenet_ssd_v2_tflite \
+  -p ${MOBILENETV2_QUANT} -l ${COCO_LABELS} -x ${MOBILENETV2_BOXES} -f ${POWER_JUMP_VIDEO} -b CPU
+run_example semantic-segmentation/example_segmentation_deeplab_v3_tflite \
+  -p ${DEEPLABV3_QUANT} -f ${PASCAL_IMAGES} -b CPU
+run_example pose-estimation/example_pose_movenet_tflite \
+  -p ${MOVENET_QUANT} -f ${POWER_JUMP_VIDEO} -b CPU
+run_example face-processing/example_face_detection_tflite \
+  -p ${ULTRAFACE_QUANT} -f ${POWER_JUMP_VIDEO} -b CPU
+run_example face-processing/example_emotion_classification_tflite \
+  -p ${ULTRAFACE_QUANT},${EMOTION_QUANT} -f ${POWER_JUMP_VIDEO} -b CPU,CPU
+run_example monocular-depth-estimation/example_depth_midas_v2_tflite \
+  -p ${MIDASV2} -f ${POWER_JUMP_VIDEO} -b CPU
+run_example mixed-demos/example_classification_and_detection_tflite \
+  -p ${MOBILENETV1_QUANT},${MOBILENETV2_QUANT} -l ${MOBILENETV1_LABELS},${COCO_LABELS} \
+  -x ${MOBILENETV2_BOXES} -f ${POWER_JUMP_VIDEO} -b CPU,CPU
+run_example mixed-demos/example_face_and_pose_detection_tflite \
+  -p ${ULTRAFACE_QUANT},${MOVENET_QUANT} -f ${POWER_JUMP_VIDEO} -b CPU,CPU